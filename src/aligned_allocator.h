@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+// Minimal standard allocator that hands out memory aligned to the given boundary, so that containers
+// using it can be passed to vectorized code (aligned loads) and start on a cache line.
+template <class T, size_t Alignment> class aligned_allocator
+{
+public:
+	typedef T value_type;
+
+	template <class U> struct rebind { typedef aligned_allocator<U, Alignment> other; };
+
+	aligned_allocator() = default;
+	template <class U> aligned_allocator(const aligned_allocator<U, Alignment> &) {}
+
+	T * allocate(size_t n)
+	{
+		return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+	}
+
+	void deallocate(T * p, size_t)
+	{
+		::operator delete(p, std::align_val_t(Alignment));
+	}
+
+	template <class U> bool operator == (const aligned_allocator<U, Alignment> &) const { return true; }
+	template <class U> bool operator != (const aligned_allocator<U, Alignment> &) const { return false; }
+};
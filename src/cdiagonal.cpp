@@ -0,0 +1,160 @@
+#include "cdiagonal.h"
+
+template <class T> diagonal_operator<T>::diagonal_operator(size_t size, T initValue /*= T(1)*/)
+	: m_diagonal(size, initValue)
+{
+}
+
+template <class T> void diagonal_operator<T>::FromMatrix(const complex_matrix<T> & matrix)
+{
+	size_t n = matrix.Rows();
+
+	complex_vector<T> diagonal(n);
+
+	for (size_t i = 0; i < n; i++)
+	{
+		const complex_vector<T> & row = matrix[i];
+
+		if (row.size() != n)
+			throw std::out_of_range("A diagonal operator can only be created from a square matrix");
+
+		for (size_t j = 0; j < n; j++)
+			if (j != i && !row[j].IsZero())
+				throw std::invalid_argument("The matrix is not diagonal");
+
+		diagonal[i] = row[i];
+	}
+
+	m_diagonal.swap(diagonal);
+}
+
+template <class T> complex_matrix<T> diagonal_operator<T>::ToMatrix() const
+{
+	size_t n = Size();
+	complex_matrix<T> result(n, n);
+
+	for (size_t i = 0; i < n; i++)
+		result[i][i] = m_diagonal[i];
+
+	return result;
+}
+
+template <class T> complex_vector<T> diagonal_operator<T>::Multiply(const complex_vector<T> & other) const
+{
+	complex_vector<T> result;
+	Multiply(other, result);
+
+	return result;
+}
+
+template <class T> void diagonal_operator<T>::Multiply(const complex_vector<T> & other, complex_vector<T> & result) const
+{ // element-wise, so it works in place as well
+	size_t n = Size();
+
+	if (other.size() != n)
+		throw std::out_of_range("Incompatible operator and vector sizes for multiplication");
+
+	result.resize(n);
+
+	for (size_t i = 0; i < n; i++)
+		result[i] = m_diagonal[i] * other[i];
+}
+
+template <class T> complex_matrix<T> diagonal_operator<T>::Multiply(const complex_matrix<T> & other) const
+{
+	size_t n = Size();
+
+	if (other.Rows() != n)
+		throw std::out_of_range("Incompatible matrix sizes for multiplication");
+
+	complex_matrix<T> result;
+	result.reserve(n);
+
+	for (size_t i = 0; i < n; i++)
+		result.push_back(other[i] * m_diagonal[i]);
+
+	return result;
+}
+
+template <class T> diagonal_operator<T> diagonal_operator<T>::Multiply(const diagonal_operator & other) const
+{
+	diagonal_operator<T> result;
+	Multiply(other.m_diagonal, result.m_diagonal);
+
+	return result;
+}
+
+template <class T> diagonal_operator<T> diagonal_operator<T>::Invert() const
+{
+	size_t n = Size();
+	diagonal_operator<T> result(n);
+
+	const T one(1);
+
+	for (size_t i = 0; i < n; i++)
+	{
+		if (m_diagonal[i].IsZero())
+			throw std::domain_error("A diagonal operator with a zero on its diagonal has no inverse");
+
+		result.m_diagonal[i] = one / m_diagonal[i];
+	}
+
+	return result;
+}
+
+template <class T> diagonal_operator<T> diagonal_operator<T>::Adjoint() const
+{
+	return diagonal_operator<T>(m_diagonal.Conjugate());
+}
+
+template <class T> diagonal_operator<T> diagonal_operator<T>::TensorProduct(const diagonal_operator & other) const
+{
+	return diagonal_operator<T>(m_diagonal.TensorProduct(other.m_diagonal));
+}
+
+template <class T> diagonal_operator<T> diagonal_operator<T>::CreatePhaseFlip(size_t size, const std::vector<size_t> & marked)
+{
+	diagonal_operator<T> result(size);
+
+	for (size_t i : marked)
+	{
+		if (i >= size)
+			throw std::out_of_range("Marked index out of range");
+
+		result.m_diagonal[i] = T(-1);
+	}
+
+	return result;
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		cint_diagonal_operator di(1);
+		cdouble_diagonal_operator dd(1);
+
+		di.FromMatrix(cint_matrix());
+		dd.FromMatrix(cdouble_matrix());
+		di.ToMatrix();
+		dd.ToMatrix();
+
+		di.Multiply(cint_vector());
+		dd.Multiply(cdouble_vector());
+		di.Multiply(cint_matrix());
+		dd.Multiply(cdouble_matrix());
+		di.Multiply(di);
+		dd.Multiply(dd);
+
+		di.Invert();
+		dd.Invert();
+		di.Adjoint();
+		dd.Adjoint();
+		di.TensorProduct(di);
+		dd.TensorProduct(dd);
+
+		cint_diagonal_operator::CreatePhaseFlip(0, {});
+		cdouble_diagonal_operator::CreatePhaseFlip(0, {});
+	}
+}
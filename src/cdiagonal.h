@@ -0,0 +1,55 @@
+#pragma once
+
+#include "cmatrix.h"
+
+// Diagonal matrix, stored as its diagonal only. Phase oracles (flipping the sign of the marked states) and
+// phase gates are diagonal, so applying, composing and inverting them costs one pass over the diagonal.
+template <class T> class diagonal_operator
+{
+public:
+	diagonal_operator() = default;
+	explicit diagonal_operator(size_t size, T initValue = T(1));
+	explicit diagonal_operator(const complex_vector<T> & diagonal) : m_diagonal(diagonal) {}
+
+	size_t Size() const { return m_diagonal.size(); }
+	size_t Rows() const { return Size(); }
+	size_t Cols() const { return Size(); }
+
+	T & operator [] (size_t i) { return m_diagonal[i]; }
+	const T & operator [] (size_t i) const { return m_diagonal[i]; }
+
+	const complex_vector<T> & Diagonal() const { return m_diagonal; }
+
+	void FromMatrix(const complex_matrix<T> & matrix); // throws if the matrix is not diagonal
+	complex_matrix<T> ToMatrix() const;
+
+	bool Equals(const diagonal_operator & other) const { return m_diagonal == other.m_diagonal; }
+	bool operator == (const diagonal_operator & other) const { return Equals(other); }
+	bool operator != (const diagonal_operator & other) const { return !Equals(other); }
+
+	complex_vector<T> Multiply(const complex_vector<T> & other) const;
+	void Multiply(const complex_vector<T> & other, complex_vector<T> & result) const; // result is resized as needed, it can be the input
+	complex_vector<T> operator * (const complex_vector<T> & other) const { return Multiply(other); }
+	void Apply(complex_vector<T> & state) const { Multiply(state, state); }
+
+	complex_matrix<T> Multiply(const complex_matrix<T> & other) const; // scales the rows of other
+	complex_matrix<T> operator * (const complex_matrix<T> & other) const { return Multiply(other); }
+
+	diagonal_operator Multiply(const diagonal_operator & other) const;
+	diagonal_operator operator * (const diagonal_operator & other) const { return Multiply(other); }
+
+	diagonal_operator Invert() const; // the inverse matrix, throws if an element of the diagonal is zero
+	diagonal_operator Adjoint() const;
+	diagonal_operator Dagger() const { return Adjoint(); } // alias
+
+	diagonal_operator TensorProduct(const diagonal_operator & other) const;
+
+	static diagonal_operator CreatePhaseFlip(size_t size, const std::vector<size_t> & marked); // -1 at the marked indexes, 1 elsewhere
+
+protected:
+	complex_vector<T> m_diagonal;
+};
+
+
+typedef diagonal_operator<cint> cint_diagonal_operator;
+typedef diagonal_operator<cdouble> cdouble_diagonal_operator;
@@ -0,0 +1,337 @@
+#pragma once
+
+#include "cmatrix.h"
+#include "parallel.h"
+
+// Expression templates for complex_vector and complex_matrix arithmetic. Operands wrapped with Lazy() build
+// an expression object instead of a temporary container for every operator; the whole expression is evaluated
+// element by element in a single pass when it is assigned to a vector or matrix. Example:
+//
+//   using namespace ComplexExpression;
+//   cdouble_vector result = -Lazy(v) + 2.0 * (Lazy(A) * Lazy(v)); // one pass over v and A, one allocation
+//
+// Expression objects keep references to the wrapped containers, so they must not outlive them.
+namespace ComplexExpression
+{
+	template <class E> class vector_expression
+	{
+	public:
+		const E & Self() const { return static_cast<const E &>(*this); }
+	};
+
+	template <class E> class matrix_expression
+	{
+	public:
+		const E & Self() const { return static_cast<const E &>(*this); }
+	};
+
+	// All expression nodes implement Uses(container), telling whether a container is one of the operands, and
+	// NeedsTemporaryFor(container), telling whether assigning the expression to that container would overwrite
+	// elements before they are read (which only happens with products).
+
+	template <class T> class vector_ref : public vector_expression<vector_ref<T>>
+	{
+	public:
+		typedef T value_type;
+
+		explicit vector_ref(const complex_vector<T> & vector) : m_vector(vector) {}
+
+		size_t Size() const { return m_vector.size(); }
+		T operator [] (size_t i) const { return m_vector[i]; }
+
+		bool Uses(const void * container) const { return &m_vector == container; }
+		bool NeedsTemporaryFor(const void *) const { return false; }
+
+	private:
+		const complex_vector<T> & m_vector;
+	};
+
+	template <class T> class matrix_ref : public matrix_expression<matrix_ref<T>>
+	{
+	public:
+		typedef T value_type;
+
+		explicit matrix_ref(const complex_matrix<T> & matrix) : m_matrix(matrix) {}
+
+		size_t Rows() const { return m_matrix.size(); }
+		size_t Cols() const { return m_matrix.empty() ? 0 : m_matrix[0].size(); }
+		T operator () (size_t i, size_t j) const { return m_matrix[i][j]; }
+
+		bool Uses(const void * container) const { return &m_matrix == container; }
+		bool NeedsTemporaryFor(const void *) const { return false; }
+
+	private:
+		const complex_matrix<T> & m_matrix;
+	};
+
+	template <class T> vector_ref<T> Lazy(const complex_vector<T> & vector) { return vector_ref<T>(vector); }
+	template <class T> matrix_ref<T> Lazy(const complex_matrix<T> & matrix) { return matrix_ref<T>(matrix); }
+
+
+	struct add_op { template <class T> static T Apply(const T & a, const T & b) { return a + b; } };
+	struct subtract_op { template <class T> static T Apply(const T & a, const T & b) { return a - b; } };
+	struct negate_op { template <class T> static T Apply(const T & a) { return -a; } };
+	struct conjugate_op { template <class T> static T Apply(const T & a) { return a.Conjugate(); } };
+
+	// nodes hold their operand nodes by value, since those are usually temporaries; they are small anyway
+
+	template <class L, class R, class Op> class vector_binary : public vector_expression<vector_binary<L, R, Op>>
+	{
+	public:
+		typedef typename L::value_type value_type;
+
+		vector_binary(const L & left, const R & right) : m_left(left), m_right(right)
+		{
+			if (left.Size() != right.Size())
+				throw std::out_of_range("Cannot add or subtract vectors of different sizes");
+		}
+
+		size_t Size() const { return m_left.Size(); }
+		value_type operator [] (size_t i) const { return Op::Apply(m_left[i], m_right[i]); }
+
+		bool Uses(const void * container) const { return m_left.Uses(container) || m_right.Uses(container); }
+		bool NeedsTemporaryFor(const void * container) const { return m_left.NeedsTemporaryFor(container) || m_right.NeedsTemporaryFor(container); }
+
+	private:
+		const L m_left;
+		const R m_right;
+	};
+
+	template <class E, class Op> class vector_unary : public vector_expression<vector_unary<E, Op>>
+	{
+	public:
+		typedef typename E::value_type value_type;
+
+		explicit vector_unary(const E & operand) : m_operand(operand) {}
+
+		size_t Size() const { return m_operand.Size(); }
+		value_type operator [] (size_t i) const { return Op::Apply(m_operand[i]); }
+
+		bool Uses(const void * container) const { return m_operand.Uses(container); }
+		bool NeedsTemporaryFor(const void * container) const { return m_operand.NeedsTemporaryFor(container); }
+
+	private:
+		const E m_operand;
+	};
+
+	template <class E> class vector_scaled : public vector_expression<vector_scaled<E>>
+	{
+	public:
+		typedef typename E::value_type value_type;
+
+		vector_scaled(const E & operand, const value_type & scalar) : m_operand(operand), m_scalar(scalar) {}
+
+		size_t Size() const { return m_operand.Size(); }
+		value_type operator [] (size_t i) const { return m_operand[i] * m_scalar; }
+
+		bool Uses(const void * container) const { return m_operand.Uses(container); }
+		bool NeedsTemporaryFor(const void * container) const { return m_operand.NeedsTemporaryFor(container); }
+
+	private:
+		const E m_operand;
+		const value_type m_scalar;
+	};
+
+	template <class M, class V> class matrix_vector_product : public vector_expression<matrix_vector_product<M, V>>
+	{ // element i is the dot product of row i with the vector, computed only when the element is needed
+	public:
+		typedef typename M::value_type value_type;
+
+		matrix_vector_product(const M & matrix, const V & vector) : m_matrix(matrix), m_vector(vector)
+		{
+			if (matrix.Cols() != vector.Size())
+				throw std::out_of_range("Incompatible matrix and vector sizes for multiplication");
+		}
+
+		size_t Size() const { return m_matrix.Rows(); }
+
+		value_type operator [] (size_t i) const
+		{
+			value_type sum;
+
+			size_t n = m_vector.Size();
+			for (size_t j = 0; j < n; j++)
+				sum += m_matrix(i, j) * m_vector[j];
+
+			return sum;
+		}
+
+		bool Uses(const void * container) const { return m_matrix.Uses(container) || m_vector.Uses(container); }
+		bool NeedsTemporaryFor(const void * container) const { return Uses(container); } // every element reads all of the vector
+
+	private:
+		const M m_matrix;
+		const V m_vector;
+	};
+
+	template <class L, class R, class Op> class matrix_binary : public matrix_expression<matrix_binary<L, R, Op>>
+	{
+	public:
+		typedef typename L::value_type value_type;
+
+		matrix_binary(const L & left, const R & right) : m_left(left), m_right(right)
+		{
+			if (left.Rows() != right.Rows() || left.Cols() != right.Cols())
+				throw std::out_of_range("Cannot add or subtract matrixes of different sizes");
+		}
+
+		size_t Rows() const { return m_left.Rows(); }
+		size_t Cols() const { return m_left.Cols(); }
+		value_type operator () (size_t i, size_t j) const { return Op::Apply(m_left(i, j), m_right(i, j)); }
+
+		bool Uses(const void * container) const { return m_left.Uses(container) || m_right.Uses(container); }
+		bool NeedsTemporaryFor(const void * container) const { return m_left.NeedsTemporaryFor(container) || m_right.NeedsTemporaryFor(container); }
+
+	private:
+		const L m_left;
+		const R m_right;
+	};
+
+	template <class E, class Op> class matrix_unary : public matrix_expression<matrix_unary<E, Op>>
+	{
+	public:
+		typedef typename E::value_type value_type;
+
+		explicit matrix_unary(const E & operand) : m_operand(operand) {}
+
+		size_t Rows() const { return m_operand.Rows(); }
+		size_t Cols() const { return m_operand.Cols(); }
+		value_type operator () (size_t i, size_t j) const { return Op::Apply(m_operand(i, j)); }
+
+		bool Uses(const void * container) const { return m_operand.Uses(container); }
+		bool NeedsTemporaryFor(const void * container) const { return m_operand.NeedsTemporaryFor(container); }
+
+	private:
+		const E m_operand;
+	};
+
+	template <class E> class matrix_scaled : public matrix_expression<matrix_scaled<E>>
+	{
+	public:
+		typedef typename E::value_type value_type;
+
+		matrix_scaled(const E & operand, const value_type & scalar) : m_operand(operand), m_scalar(scalar) {}
+
+		size_t Rows() const { return m_operand.Rows(); }
+		size_t Cols() const { return m_operand.Cols(); }
+		value_type operator () (size_t i, size_t j) const { return m_operand(i, j) * m_scalar; }
+
+		bool Uses(const void * container) const { return m_operand.Uses(container); }
+		bool NeedsTemporaryFor(const void * container) const { return m_operand.NeedsTemporaryFor(container); }
+
+	private:
+		const E m_operand;
+		const value_type m_scalar;
+	};
+
+
+	template <class L, class R> vector_binary<L, R, add_op> operator + (const vector_expression<L> & left, const vector_expression<R> & right)
+	{
+		return vector_binary<L, R, add_op>(left.Self(), right.Self());
+	}
+
+	template <class L, class R> vector_binary<L, R, subtract_op> operator - (const vector_expression<L> & left, const vector_expression<R> & right)
+	{
+		return vector_binary<L, R, subtract_op>(left.Self(), right.Self());
+	}
+
+	template <class E> vector_unary<E, negate_op> operator - (const vector_expression<E> & operand)
+	{
+		return vector_unary<E, negate_op>(operand.Self());
+	}
+
+	template <class E> vector_unary<E, conjugate_op> Conjugate(const vector_expression<E> & operand)
+	{
+		return vector_unary<E, conjugate_op>(operand.Self());
+	}
+
+	template <class E> vector_scaled<E> operator * (const vector_expression<E> & operand, const typename E::value_type & scalar)
+	{
+		return vector_scaled<E>(operand.Self(), scalar);
+	}
+
+	template <class E> vector_scaled<E> operator * (const typename E::value_type & scalar, const vector_expression<E> & operand)
+	{
+		return vector_scaled<E>(operand.Self(), scalar);
+	}
+
+	template <class M, class V> matrix_vector_product<M, V> operator * (const matrix_expression<M> & matrix, const vector_expression<V> & vector)
+	{
+		return matrix_vector_product<M, V>(matrix.Self(), vector.Self());
+	}
+
+	template <class L, class R> matrix_binary<L, R, add_op> operator + (const matrix_expression<L> & left, const matrix_expression<R> & right)
+	{
+		return matrix_binary<L, R, add_op>(left.Self(), right.Self());
+	}
+
+	template <class L, class R> matrix_binary<L, R, subtract_op> operator - (const matrix_expression<L> & left, const matrix_expression<R> & right)
+	{
+		return matrix_binary<L, R, subtract_op>(left.Self(), right.Self());
+	}
+
+	template <class E> matrix_unary<E, negate_op> operator - (const matrix_expression<E> & operand)
+	{
+		return matrix_unary<E, negate_op>(operand.Self());
+	}
+
+	template <class E> matrix_unary<E, conjugate_op> Conjugate(const matrix_expression<E> & operand)
+	{
+		return matrix_unary<E, conjugate_op>(operand.Self());
+	}
+
+	template <class E> matrix_scaled<E> operator * (const matrix_expression<E> & operand, const typename E::value_type & scalar)
+	{
+		return matrix_scaled<E>(operand.Self(), scalar);
+	}
+
+	template <class E> matrix_scaled<E> operator * (const typename E::value_type & scalar, const matrix_expression<E> & operand)
+	{
+		return matrix_scaled<E>(operand.Self(), scalar);
+	}
+
+	const size_t MIN_ELEMENTS_PER_THREAD = Parallel::MIN_ELEMENTS_PER_THREAD;
+}
+
+
+template <class T> template <class E> complex_vector<T> & complex_vector<T>::Assign(const ComplexExpression::vector_expression<E> & expression)
+{
+	const E & e = expression.Self();
+
+	if (e.NeedsTemporaryFor(this))
+	{
+		complex_vector<T> temp(expression);
+		this->swap(temp);
+		return *this;
+	}
+
+	this->resize(e.Size());
+	T * data = this->data();
+
+	Parallel::For(0, this->size(), ComplexExpression::MIN_ELEMENTS_PER_THREAD, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			data[i] = e[i];
+	});
+
+	return *this;
+}
+
+template <class T> template <class E> complex_matrix<T> & complex_matrix<T>::Assign(const ComplexExpression::matrix_expression<E> & expression)
+{ // matrix expressions are element-wise only, so they can always be evaluated in place
+	const E & e = expression.Self();
+	size_t m = e.Rows(), n = e.Cols();
+
+	this->resize(m);
+
+	for (size_t i = 0; i < m; i++)
+	{
+		complex_vector<T> & row = (*this)[i];
+		row.resize(n);
+
+		for (size_t j = 0; j < n; j++)
+			row[j] = e(i, j);
+	}
+
+	return *this;
+}
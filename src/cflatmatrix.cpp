@@ -0,0 +1,358 @@
+#include "cflatmatrix.h"
+#include "complex_kernels.h"
+#include "gemm.h"
+
+#include <algorithm>
+
+template <class T> complex_flat_matrix<T>::complex_flat_matrix(size_t m, size_t n, T initValue)
+{
+	Resize(m, n);
+
+	if (!initValue.IsZero())
+		for (size_t i = 0; i < m; i++)
+			std::fill((*this)[i], (*this)[i] + n, initValue); // padding stays zero
+}
+
+template <class T> size_t complex_flat_matrix<T>::StrideForCols(size_t n)
+{
+	const size_t elementsPerBlock = ALIGNMENT >= sizeof(T) ? ALIGNMENT / sizeof(T) : 1;
+
+	return (n + elementsPerBlock - 1) / elementsPerBlock * elementsPerBlock;
+}
+
+template <class T> void complex_flat_matrix<T>::Resize(size_t m, size_t n)
+{
+	m_rows = m;
+	m_cols = n;
+	m_stride = StrideForCols(n);
+
+	m_data.assign(m_rows * m_stride, T());
+}
+
+template <class T> void complex_flat_matrix<T>::FromMatrix(const complex_matrix<T> & matrix)
+{ // like complex_matrix::Transpose, undefined behavior if the source has rows of different sizes
+	size_t m = matrix.Rows();
+	Resize(m, m ? matrix.Cols() : 0);
+
+	for (size_t i = 0; i < m; i++)
+		std::copy(matrix[i].begin(), matrix[i].end(), (*this)[i]);
+}
+
+template <class T> complex_matrix<T> complex_flat_matrix<T>::ToMatrix() const
+{
+	complex_matrix<T> result;
+	result.reserve(m_rows);
+
+	for (size_t i = 0; i < m_rows; i++)
+		result.push_back(complex_vector<T>(std::vector<T>((*this)[i], (*this)[i] + m_cols)));
+
+	return result;
+}
+
+template <class T> void complex_flat_matrix<T>::FromVector(const complex_vector<T> & vector)
+{
+	size_t m = vector.size();
+	Resize(m, 1);
+
+	for (size_t i = 0; i < m; i++)
+		(*this)(i, 0) = vector[i];
+}
+
+template <class T> complex_vector<T> complex_flat_matrix<T>::ToVector() const
+{
+	complex_vector<T> result(m_rows);
+
+	for (size_t i = 0; i < m_rows; i++)
+		result[i] = (*this)(i, 0);
+
+	return result;
+}
+
+template <class T> bool complex_flat_matrix<T>::Equals(const complex_flat_matrix & other) const
+{
+	if (m_rows != other.Rows() || m_cols != other.Cols())
+		return false;
+
+	for (size_t i = 0; i < m_rows; i++)
+		if (!std::equal((*this)[i], (*this)[i] + m_cols, other[i]))
+			return false;
+
+	return true;
+}
+
+template <class T> bool complex_flat_matrix<T>::NearEquals(const complex_flat_matrix & other, double epsilon) const
+{
+	if (m_rows != other.Rows() || m_cols != other.Cols())
+		return false;
+
+	for (size_t i = 0; i < m_rows; i++)
+		for (size_t j = 0; j < m_cols; j++)
+			if (!(*this)(i, j).NearEquals(other(i, j), epsilon))
+				return false;
+
+	return true;
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::Add(const complex_flat_matrix & other) const
+{
+	if (m_rows != other.Rows() || m_cols != other.Cols())
+		throw std::out_of_range("Cannot add or subtract matrixes of different sizes");
+
+	complex_flat_matrix<T> result(m_rows, m_cols);
+
+	// same layout on both sides, so the whole buffer can be processed at once; the padding stays zero
+	ComplexKernels::Add(m_data.data(), other.m_data.data(), result.m_data.data(), m_data.size());
+
+	return result;
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::Subtract(const complex_flat_matrix & other) const
+{
+	if (m_rows != other.Rows() || m_cols != other.Cols())
+		throw std::out_of_range("Cannot add or subtract matrixes of different sizes");
+
+	complex_flat_matrix<T> result(m_rows, m_cols);
+
+	ComplexKernels::Subtract(m_data.data(), other.m_data.data(), result.m_data.data(), m_data.size());
+
+	return result;
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::Conjugate() const
+{
+	complex_flat_matrix<T> result(*this);
+
+	for (auto & value : result.m_data)
+		value = value.Conjugate();
+
+	return result;
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::Inverse() const
+{
+	complex_flat_matrix<T> result(*this);
+
+	for (auto & value : result.m_data)
+		value = -value;
+
+	return result;
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::Multiply(const T & scalar) const
+{
+	complex_flat_matrix<T> result(m_rows, m_cols);
+
+	ComplexKernels::Scale(scalar, m_data.data(), result.m_data.data(), m_data.size());
+
+	return result;
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::Multiply(const complex_flat_matrix & other) const
+{
+	size_t m = m_rows, n = m_cols, p = other.Cols();
+
+	if (n != other.Rows())
+		throw std::out_of_range("Incompatible matrix sizes for multiplication");
+
+	complex_flat_matrix<T> result(m, p);
+
+	Gemm::Multiply(m, n, p, Data(), m_stride, other.Data(), other.Stride(), result.Data(), result.Stride());
+
+	return result;
+}
+
+template <class T> complex_vector<T> complex_flat_matrix<T>::Multiply(const complex_vector<T> & other) const
+{
+	complex_vector<T> result;
+	Multiply(other, result);
+
+	return result;
+}
+
+template <class T> void complex_flat_matrix<T>::Multiply(const complex_vector<T> & other, complex_vector<T> & result) const
+{
+	if (m_cols != other.size())
+		throw std::out_of_range("Incompatible matrix and vector sizes for multiplication");
+
+	if (&result == &other) // the input is still needed while the result is written
+	{
+		complex_vector<T> temp;
+		Multiply(other, temp);
+		result.swap(temp);
+		return;
+	}
+
+	result.resize(m_rows);
+
+	Gemm::MultiplyVector(m_rows, m_cols, Data(), m_stride, other.data(), result.data());
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::Transpose() const
+{
+	complex_flat_matrix<T> result(m_cols, m_rows);
+
+	const size_t blockSize = 32; // transpose in tiles so that neither side is walked column-wise for long
+
+	for (size_t ii = 0; ii < m_rows; ii += blockSize)
+		for (size_t jj = 0; jj < m_cols; jj += blockSize)
+		{
+			size_t iEnd = std::min(ii + blockSize, m_rows);
+			size_t jEnd = std::min(jj + blockSize, m_cols);
+
+			for (size_t i = ii; i < iEnd; i++)
+				for (size_t j = jj; j < jEnd; j++)
+					result(j, i) = (*this)(i, j);
+		}
+
+	return result;
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::Adjoint() const
+{
+	complex_flat_matrix<T> result = Transpose();
+
+	for (auto & value : result.m_data)
+		value = value.Conjugate();
+
+	return result;
+}
+
+template <class T> T complex_flat_matrix<T>::Trace() const
+{
+	size_t n = std::min(m_rows, m_cols);
+
+	T result;
+
+	for (size_t i = 0; i < n; i++)
+		result += (*this)(i, i);
+
+	return result;
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::TensorProduct(const complex_flat_matrix & other) const
+{ // works for any shapes, the result of (m x n) and (p x q) matrixes is (mp x nq)
+	size_t m = m_rows, n = m_cols, p = other.Rows(), q = other.Cols();
+
+	complex_flat_matrix<T> result(m * p, n * q);
+
+	for (size_t i = 0; i < m; i++)
+		for (size_t k = 0; k < p; k++)
+		{
+			T * resultRow = result[i * p + k];
+			const T * otherRow = other[k];
+
+			for (size_t j = 0; j < n; j++)
+			{
+				const T a = (*this)(i, j);
+
+				for (size_t l = 0; l < q; l++)
+					resultRow[j * q + l] = a * otherRow[l];
+			}
+		}
+
+	return result;
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::CreateZeroMatrix(size_t m, size_t n)
+{
+	complex_flat_matrix<T> result(m, n);
+	return result;
+}
+
+template <class T> complex_flat_matrix<T> complex_flat_matrix<T>::CreateIdentityMatrix(size_t size)
+{
+	complex_flat_matrix<T> result(size, size);
+
+	for (size_t i = 0; i < size; i++)
+		result(i, i) = 1;
+
+	return result;
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		cint_flat_matrix mi(0, 0);
+		cdouble_flat_matrix md(0, 0);
+		cfloat_flat_matrix mf(0, 0);
+
+		cint_flat_matrix miFromMatrix((cint_matrix()));
+		cdouble_flat_matrix mdFromMatrix((cdouble_matrix()));
+		cfloat_flat_matrix mfFromMatrix((cfloat_matrix()));
+
+		mi.ToMatrix();
+		md.ToMatrix();
+		mf.ToMatrix();
+
+		mi.FromVector(cint_vector());
+		md.FromVector(cdouble_vector());
+		mf.FromVector(cfloat_vector());
+		mi.ToVector();
+		md.ToVector();
+		mf.ToVector();
+
+		mi.Equals(mi);
+		md.Equals(md);
+		mf.Equals(mf);
+		mi.NearEquals(mi, 0);
+		md.NearEquals(md, 0);
+		mf.NearEquals(mf, 0);
+
+		mi.Add(mi);
+		md.Add(md);
+		mf.Add(mf);
+		mi.Subtract(mi);
+		md.Subtract(md);
+		mf.Subtract(mf);
+
+		mi.Conjugate();
+		md.Conjugate();
+		mf.Conjugate();
+
+		mi.Inverse();
+		md.Inverse();
+		mf.Inverse();
+
+		mi.Multiply(cint());
+		md.Multiply(cdouble());
+		mf.Multiply(cfloat());
+
+		mi.Multiply(mi);
+		md.Multiply(md);
+		mf.Multiply(mf);
+
+		mi.Multiply(cint_vector());
+		md.Multiply(cdouble_vector());
+		mf.Multiply(cfloat_vector());
+		cint_vector viResult;
+		cdouble_vector vdResult;
+		cfloat_vector vfResult;
+		mi.Multiply(viResult, viResult);
+		md.Multiply(vdResult, vdResult);
+		mf.Multiply(vfResult, vfResult);
+
+		mi.Transpose();
+		md.Transpose();
+		mf.Transpose();
+		mi.Adjoint();
+		md.Adjoint();
+		mf.Adjoint();
+
+		mi.Trace();
+		md.Trace();
+		mf.Trace();
+
+		mi.TensorProduct(mi);
+		md.TensorProduct(md);
+		mf.TensorProduct(mf);
+
+		cint_flat_matrix::CreateZeroMatrix(0, 0);
+		cdouble_flat_matrix::CreateZeroMatrix(0, 0);
+		cfloat_flat_matrix::CreateZeroMatrix(0, 0);
+		cint_flat_matrix::CreateIdentityMatrix(0);
+		cdouble_flat_matrix::CreateIdentityMatrix(0);
+		cfloat_flat_matrix::CreateIdentityMatrix(0);
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "cmatrix.h"
+#include "aligned_allocator.h"
+
+// Matrix stored in a single contiguous, aligned row-major buffer. Each row starts on an ALIGNMENT boundary,
+// so the distance between rows (Stride) can be larger than the number of columns; the padding is kept at zero.
+// Offers the same operations as complex_matrix, plus raw access to the buffer for vectorized kernels.
+template <class T> class complex_flat_matrix
+{
+public:
+	static const size_t ALIGNMENT = 64; // one cache line, also enough for the widest SIMD loads
+
+	typedef std::vector<T, aligned_allocator<T, ALIGNMENT>> storage_type;
+
+	complex_flat_matrix() = default;
+	complex_flat_matrix(size_t m, size_t n, T initValue = T());
+	complex_flat_matrix(const complex_matrix<T> & matrix) { FromMatrix(matrix); }
+
+	size_t Rows() const { return m_rows; }
+	size_t Cols() const { return m_cols; }
+	size_t Stride() const { return m_stride; } // distance between the starts of two consecutive rows, in elements
+
+	T * Data() { return m_data.data(); }
+	const T * Data() const { return m_data.data(); }
+
+	T * operator [] (size_t row) { return Data() + row * m_stride; }
+	const T * operator [] (size_t row) const { return Data() + row * m_stride; }
+
+	T & operator () (size_t row, size_t col) { return m_data[row * m_stride + col]; }
+	const T & operator () (size_t row, size_t col) const { return m_data[row * m_stride + col]; }
+
+	void FromMatrix(const complex_matrix<T> & matrix);
+	complex_matrix<T> ToMatrix() const;
+
+	void FromVector(const complex_vector<T> & vector); // creates a column matrix
+	complex_vector<T> ToVector() const;
+
+	bool Equals(const complex_flat_matrix & other) const;
+	bool operator == (const complex_flat_matrix & other) const { return Equals(other); }
+	bool operator != (const complex_flat_matrix & other) const { return !Equals(other); }
+
+	bool NearEquals(const complex_flat_matrix & other, double epsilon) const;
+
+	complex_flat_matrix Add(const complex_flat_matrix & other) const;
+	complex_flat_matrix operator + (const complex_flat_matrix & other) const { return Add(other); }
+	complex_flat_matrix Subtract(const complex_flat_matrix & other) const;
+	complex_flat_matrix operator - (const complex_flat_matrix & other) const { return Subtract(other); }
+
+	complex_flat_matrix Conjugate() const;
+
+	complex_flat_matrix Inverse() const;
+	complex_flat_matrix operator - () const { return Inverse(); }
+
+	complex_flat_matrix Multiply(const T & scalar) const;
+	complex_flat_matrix operator * (const T & scalar) const { return Multiply(scalar); }
+
+	complex_flat_matrix Multiply(const complex_flat_matrix & other) const;
+	complex_flat_matrix operator * (const complex_flat_matrix & other) const { return Multiply(other); }
+
+	complex_vector<T> Multiply(const complex_vector<T> & other) const;
+	void Multiply(const complex_vector<T> & other, complex_vector<T> & result) const; // result is resized as needed, so it can be reused between calls
+	complex_vector<T> operator * (const complex_vector<T> & other) const { return Multiply(other); }
+
+	complex_flat_matrix Transpose() const;
+
+	complex_flat_matrix Adjoint() const;
+	complex_flat_matrix Dagger() const { return Adjoint(); } // alias
+
+	T Trace() const;
+
+	complex_flat_matrix TensorProduct(const complex_flat_matrix & other) const;
+
+	static complex_flat_matrix CreateZeroMatrix(size_t m, size_t n);
+	static complex_flat_matrix CreateIdentityMatrix(size_t size);
+
+	static size_t StrideForCols(size_t n);
+
+protected:
+	void Resize(size_t m, size_t n);
+
+	size_t m_rows = 0;
+	size_t m_cols = 0;
+	size_t m_stride = 0;
+
+	storage_type m_data;
+};
+
+
+template <typename T> complex_flat_matrix<T> operator * (const T & scalar, const complex_flat_matrix<T> & matrix)
+{
+	return matrix * scalar;
+}
+
+
+typedef complex_flat_matrix<cint> cint_flat_matrix;
+typedef complex_flat_matrix<cfloat> cfloat_flat_matrix;
+typedef complex_flat_matrix<cdouble> cdouble_flat_matrix;
@@ -0,0 +1,144 @@
+#include "ckronecker.h"
+#include "complex_kernels.h"
+
+template <class T> kronecker_operator<T> & kronecker_operator<T>::Append(const complex_matrix<T> & factor)
+{
+	if (factor.empty() || factor.Cols() == 0)
+		throw std::out_of_range("Cannot use an empty matrix as a tensor product factor");
+
+	Factor f;
+	f.m_matrix = factor;
+	f.m_rows = factor.Rows();
+	f.m_cols = factor.Cols();
+
+	m_factors.push_back(f);
+	return *this;
+}
+
+template <class T> kronecker_operator<T> & kronecker_operator<T>::AppendIdentity(size_t size)
+{
+	if (size == 0)
+		throw std::out_of_range("Cannot use an empty matrix as a tensor product factor");
+
+	Factor f;
+	f.m_rows = size;
+	f.m_cols = size;
+
+	m_factors.push_back(f);
+	return *this;
+}
+
+template <class T> kronecker_operator<T> kronecker_operator<T>::TensorProduct(const kronecker_operator & other) const
+{
+	kronecker_operator<T> result(*this);
+	result.m_factors.insert(result.m_factors.end(), other.m_factors.begin(), other.m_factors.end());
+
+	return result;
+}
+
+template <class T> size_t kronecker_operator<T>::Rows() const
+{
+	size_t result = 1;
+
+	for (const auto & factor : m_factors)
+		result *= factor.m_rows;
+
+	return result;
+}
+
+template <class T> size_t kronecker_operator<T>::Cols() const
+{
+	size_t result = 1;
+
+	for (const auto & factor : m_factors)
+		result *= factor.m_cols;
+
+	return result;
+}
+
+template <class T> complex_vector<T> kronecker_operator<T>::Multiply(const complex_vector<T> & other) const
+{
+	complex_vector<T> result;
+	Multiply(other, result);
+
+	return result;
+}
+
+template <class T> void kronecker_operator<T>::Multiply(const complex_vector<T> & other, complex_vector<T> & result) const
+{ // the vector is viewed as a tensor with one index per factor (the first factor being the most significant);
+  // each factor transforms its own index, turning (left, cols, right) into (left, rows, right)
+	size_t right = Cols();
+
+	if (other.size() != right)
+		throw std::out_of_range("Incompatible operator and vector sizes for multiplication");
+
+	complex_vector<T> current(other), next;
+
+	size_t left = 1;
+
+	for (const auto & factor : m_factors)
+	{
+		const size_t rows = factor.m_rows, cols = factor.m_cols;
+		right /= cols;
+
+		if (!factor.IsIdentity())
+		{
+			next.assign(left * rows * right, T());
+
+			for (size_t l = 0; l < left; l++)
+				for (size_t i = 0; i < rows; i++)
+				{
+					T * destination = next.data() + (l * rows + i) * right;
+					const complex_vector<T> & factorRow = factor.m_matrix[i];
+
+					for (size_t j = 0; j < cols; j++)
+						ComplexKernels::Axpy(factorRow[j], current.data() + (l * cols + j) * right, destination, right);
+				}
+
+			current.swap(next);
+		}
+
+		left *= rows;
+	}
+
+	result.swap(current);
+}
+
+template <class T> complex_matrix<T> kronecker_operator<T>::ToMatrix() const
+{
+	complex_matrix<T> result = complex_matrix<T>::CreateIdentityMatrix(1);
+
+	for (const auto & factor : m_factors)
+		result = result.TensorProduct(factor.IsIdentity() ? complex_matrix<T>::CreateIdentityMatrix(factor.m_rows) : factor.m_matrix);
+
+	return result;
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		cint_kronecker_operator ki;
+		cdouble_kronecker_operator kd;
+
+		ki.Append(cint_matrix());
+		kd.Append(cdouble_matrix());
+		ki.AppendIdentity(0);
+		kd.AppendIdentity(0);
+
+		ki.TensorProduct(ki);
+		kd.TensorProduct(kd);
+
+		ki.Rows();
+		kd.Rows();
+		ki.Cols();
+		kd.Cols();
+
+		ki.Multiply(cint_vector());
+		kd.Multiply(cdouble_vector());
+
+		ki.ToMatrix();
+		kd.ToMatrix();
+	}
+}
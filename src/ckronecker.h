@@ -0,0 +1,46 @@
+#pragma once
+
+#include "cmatrix.h"
+
+// Lazy tensor (Kronecker) product of matrixes: the factors are kept as they are and only combined when the
+// operator is applied to a vector, one factor at a time. A product of k factors of size d costs k * d * d
+// memory instead of d^(2k), and applying it costs (vector size) * (sum of the factor sizes).
+// Factors can be rectangular; identity factors are stored by size only and cost nothing to apply.
+template <class T> class kronecker_operator
+{
+public:
+	kronecker_operator() = default; // no factors, acts as the 1x1 identity
+	kronecker_operator(const complex_matrix<T> & factor) { Append(factor); }
+
+	kronecker_operator & Append(const complex_matrix<T> & factor); // this becomes this (x) factor
+	kronecker_operator & AppendIdentity(size_t size);
+
+	kronecker_operator TensorProduct(const complex_matrix<T> & other) const { kronecker_operator result(*this); result.Append(other); return result; }
+	kronecker_operator TensorProduct(const kronecker_operator & other) const;
+
+	size_t Rows() const;
+	size_t Cols() const;
+	size_t FactorCount() const { return m_factors.size(); }
+
+	complex_vector<T> Multiply(const complex_vector<T> & other) const;
+	complex_vector<T> operator * (const complex_vector<T> & other) const { return Multiply(other); }
+	void Multiply(const complex_vector<T> & other, complex_vector<T> & result) const;
+
+	complex_matrix<T> ToMatrix() const; // expands the product, only meant for small operators and checks
+
+protected:
+	struct Factor
+	{
+		complex_matrix<T> m_matrix; // empty for identity factors
+		size_t m_rows = 0;
+		size_t m_cols = 0;
+
+		bool IsIdentity() const { return m_matrix.empty(); }
+	};
+
+	std::vector<Factor> m_factors;
+};
+
+
+typedef kronecker_operator<cint> cint_kronecker_operator;
+typedef kronecker_operator<cdouble> cdouble_kronecker_operator;
@@ -1,9 +1,11 @@
 #include "cmatrix.h"
+#include "complex_kernels.h"
+#include "gemm.h"
+#include "parallel.h"
 
 template <class T> complex_matrix<T>::complex_matrix(size_t m, size_t n, T initValue)
+	: std::vector<complex_vector<T>>(m, complex_vector<T>(n, initValue))
 {
-	for (size_t i = 0; i < m; i++)
-		this->push_back(complex_vector<T>(n, initValue));
 }
 
 template <class T> void complex_matrix<T>::FromVector(const complex_vector<T> & vector)
@@ -16,6 +18,7 @@ template <class T> void complex_matrix<T>::FromVector(const complex_vector<T> &
 template <class T> complex_vector<T> complex_matrix<T>::ToVector() const
 {
 	complex_vector<T> result;
+	result.reserve(this->size());
 
 	for (const auto & row : *this)
 		result.push_back(row[0]);
@@ -73,91 +76,261 @@ template <class T> bool complex_matrix<T>::NearEquals(const complex_matrix & oth
 	}
 }
 
-template <class T> complex_matrix<T> complex_matrix<T>::AddOrSubtract(const complex_matrix & other, complex_vector<T>(complex_vector<T>::*fnPtr)(const complex_vector<T> &) const) const
+template <class T> complex_matrix<T> & complex_matrix<T>::AddTo(const complex_matrix & other)
 {
 	size_t n = this->size();
 
 	if (n != other.size())
 		throw std::out_of_range("Cannot add or subtract matrixes of different sizes");
 
-	complex_matrix<T> result;
+	for (size_t i = 0; i < n; i++)
+		(*this)[i].AddTo(other[i]);
+
+	return *this;
+}
+
+template <class T> complex_matrix<T> & complex_matrix<T>::SubtractFrom(const complex_matrix & other)
+{
+	size_t n = this->size();
+
+	if (n != other.size())
+		throw std::out_of_range("Cannot add or subtract matrixes of different sizes");
 
 	for (size_t i = 0; i < n; i++)
-		result.push_back(((*this)[i].*fnPtr)(other[i]));
+		(*this)[i].SubtractFrom(other[i]);
 
-	return result;
+	return *this;
 }
 
-template <class T> complex_matrix<T> complex_matrix<T>::Conjugate() const
+template <class T> complex_matrix<T> & complex_matrix<T>::AddScaled(const T & scalar, const complex_matrix & other)
 {
-	complex_matrix<T> result;
+	size_t n = this->size();
 
-	for (auto & value : *this)
-		result.push_back(value.Conjugate());
+	if (n != other.size())
+		throw std::out_of_range("Cannot add or subtract matrixes of different sizes");
 
-	return result;
+	for (size_t i = 0; i < n; i++)
+		(*this)[i].AddScaled(scalar, other[i]);
+
+	return *this;
 }
 
-template <class T> complex_matrix<T> complex_matrix<T>::Inverse() const
+template <class T> complex_matrix<T> & complex_matrix<T>::ConjugateInPlace()
 {
-	complex_matrix<T> result;
+	for (auto & row : *this)
+		row.ConjugateInPlace();
 
-	for (auto & value : *this)
-		result.push_back(-value);
+	return *this;
+}
 
-	return result;
+template <class T> complex_matrix<T> & complex_matrix<T>::InverseInPlace()
+{
+	for (auto & row : *this)
+		row.InverseInPlace();
+
+	return *this;
 }
 
-template <class T> complex_matrix<T> complex_matrix<T>::Multiply(const T & scalar) const
+template <class T> complex_matrix<T> & complex_matrix<T>::MultiplyWith(const T & scalar)
 {
-	complex_matrix<T> result;
+	for (auto & row : *this)
+		row.MultiplyWith(scalar);
 
-	for (auto & vector : *this)
-		result.push_back(vector * scalar);
+	return *this;
+}
+
+template <class T> complex_matrix<T> complex_matrix<T>::Multiply(const complex_matrix<T> & other) const
+{
+	complex_matrix<T> result;
+	Multiply(other, result);
 
 	return result;
 }
 
-template <class T> complex_matrix<T> complex_matrix<T>::Multiply(const complex_matrix<T> & other) const
+template <class T> void complex_matrix<T>::Multiply(const complex_matrix<T> & other, complex_matrix<T> & result) const
 {
 	size_t m = Rows(), n=Cols(), p = other.Cols();
 
 	if (n != other.Rows())
 		throw std::out_of_range("Incompatible matrix sizes for multiplication");
 
-	complex_matrix<T> result(m, p);
+	if (&result == this || &result == &other) // the operands are still needed while the result is written
+	{
+		complex_matrix<T> temp;
+		Multiply(other, temp);
+		result.swap(temp);
+		return;
+	}
+
+	result.resize(m);
+
+	if (!Gemm::IsSmall(m, n, p)) // large products go through the tiled engine, which reads and writes the rows where they are
+	{
+		std::vector<const T *> a(m), b(n);
+		std::vector<T *> c(m);
+
+		for (size_t i = 0; i < m; i++)
+		{
+			result[i].resize(p);
+			a[i] = (*this)[i].data();
+			c[i] = result[i].data();
+		}
+
+		for (size_t k = 0; k < n; k++)
+			b[k] = other[k].data();
+
+		Gemm::MultiplyRows(m, n, p, a.data(), b.data(), c.data());
+		return;
+	}
 
 	for (size_t i = 0; i < m; i++)
+	{ // row i of the result is the sum of the rows of other, weighted by row i of this
+		complex_vector<T> & row = result[i];
+		row.assign(p, T());
+
+		for (size_t k = 0; k < n; k++)
+			ComplexKernels::Axpy((*this)[i][k], other[k].data(), row.data(), p);
+	}
+}
+
+template <class T> complex_matrix<T> & complex_matrix<T>::MultiplyWith(const complex_matrix<T> & other, complex_matrix<T> & workspace)
+{
+	Multiply(other, workspace);
+	this->swap(workspace);
+
+	return *this;
+}
+
+template <class T> complex_vector<T> complex_matrix<T>::Multiply(const complex_vector<T> & other) const
+{
+	complex_vector<T> result;
+	Multiply(other, result);
+
+	return result;
+}
+
+template <class T> void complex_matrix<T>::Multiply(const complex_vector<T> & other, complex_vector<T> & result) const
+{
+	size_t m = Rows(), n = other.size();
+
+	for (const auto & row : *this)
+		if (row.size() != n)
+			throw std::out_of_range("Incompatible matrix and vector sizes for multiplication");
+
+	if (&result == &other) // the input is still needed while the result is written
+	{
+		complex_vector<T> temp;
+		Multiply(other, temp);
+		result.swap(temp);
+		return;
+	}
+
+	result.resize(m);
+
+	Parallel::For(0, m, Gemm::MinRowsPerThread(n), [&](size_t rowBegin, size_t rowEnd)
 	{
-		for (size_t j = 0; j < p; j++)
+		for (size_t i = rowBegin; i < rowEnd; i++)
 		{
-			T sum;
-			for (size_t k = 0; k < n; k++)
-			{
-				sum += (*this)[i][k] * other[k][j];
-			}
+			result[i] = ComplexKernels::MultiplyAccumulate((*this)[i].data(), other.data(), n);
+		}
+	});
+}
+
+template <class T> complex_matrix<T> complex_matrix<T>::Power(size_t k) const
+{ // the squares and the partial products are kept in buffers that are reused from one step to the next
+	size_t n = Rows();
+
+	if (n && Cols() != n)
+		throw std::out_of_range("Only square matrixes can be raised to a power");
 
-			result[i][j] = sum;
+	if (k == 0)
+		return CreateIdentityMatrix(n);
+
+	complex_matrix<T> result, square(*this), workspace;
+	bool resultSet = false;
+
+	for (;;)
+	{
+		if (k & 1)
+		{
+			if (resultSet)
+				result.MultiplyWith(square, workspace);
+			else
+				result = square;
+
+			resultSet = true;
 		}
+
+		k >>= 1;
+		if (k == 0)
+			break;
+
+		square.MultiplyWith(square, workspace);
 	}
 
 	return result;
 }
 
-template <class T> complex_vector<T> complex_matrix<T>::Multiply(const complex_vector<T> & other) const
+template <class T> complex_vector<T> complex_matrix<T>::ApplyPower(size_t k, const complex_vector<T> & vector) const
 {
-	complex_matrix<T> otherMatrix;
-	otherMatrix.FromVector(other);
+	size_t n = Rows();
+
+	if (n && Cols() != n)
+		throw std::out_of_range("Only square matrixes can be raised to a power");
 
-	return Multiply(otherMatrix).ToVector();
+	size_t squarings = 0;
+	for (size_t i = k; i > 1; i >>= 1)
+		squarings++;
+
+	// k products of n^2 against up to 2 * log2(k) products of n^3
+	if (k <= 2 * (squarings + 1) * n)
+	{
+		complex_vector<T> result(vector), next;
+
+		for (size_t i = 0; i < k; i++)
+		{
+			Multiply(result, next);
+			result.swap(next);
+		}
+
+		return result;
+	}
+
+	return Power(k).Multiply(vector);
 }
 
-template <class T> complex_matrix<T> complex_matrix<T>::Power(size_t k) const
+template <class T> complex_vector<T> complex_matrix<T>::Evolve(size_t steps, const complex_vector<T> & state, double epsilon, size_t * stepsDone /*= nullptr*/) const
 {
-	complex_matrix<T> result = CreateIdentityMatrix(Rows());
+	auto same = [epsilon](const complex_vector<T> & a, const complex_vector<T> & b) // exact comparison for a zero epsilon
+	{
+		return epsilon > 0 ? a.NearEquals(b, epsilon) : a == b;
+	};
+
+	complex_vector<T> result(state), next;
+	size_t done = 0;
+
+	while (done < steps)
+	{
+		Multiply(result, next);
+		done++;
+
+		if (same(next, result)) // converged, further steps do not change it
+		{
+			result.swap(next);
+			break;
+		}
+
+		result.swap(next);
+
+		if (same(result, state)) // periodic, only the remainder of the steps matters
+		{
+			size_t remaining = (steps - done) % done;
+			steps = done + remaining;
+		}
+	}
 
-	for (size_t i = 0; i < k; i++)
-		result *= *this;
+	if (stepsDone)
+		*stepsDone = done;
 
 	return result;
 }
@@ -170,16 +343,17 @@ template <class T> complex_matrix<T> complex_matrix<T>::Transpose() const
 	if (n)
 	{
 		size_t m = (*this)[0].size();
+		result.resize(m);
 
 		for (size_t i = 0; i < m; i++)
 		{
-			complex_vector<T> vector;
+			complex_vector<T> & vector = result[i];
+			vector.resize(n);
+
 			for (size_t j = 0; j < n; j++)
 			{
-				vector.push_back((*this)[j][i]);
+				vector[j] = (*this)[j][i];
 			}
-
-			result.push_back(vector);
 		}
 	}
 
@@ -205,18 +379,16 @@ template <class T> T complex_matrix<T>::InnerProduct(const complex_matrix & othe
 
 template <class T> complex_matrix<T> complex_matrix<T>::TensorProduct(const complex_matrix & other) const
 {
-	size_t m = Rows(), n = other.Rows();
-
-	//TBD: throw if not square matrixes
-
-	size_t resultSize = m * n;
+	// works for any shapes, the result of (m x n) and (p x q) matrixes is (mp x nq)
+	size_t m = Rows(), p = other.Rows();
+	size_t n = m ? Cols() : 0, q = p ? other.Cols() : 0;
 
-	complex_matrix<T> result(resultSize, resultSize);
+	complex_matrix<T> result(m * p, n * q);
 
-	for (size_t j=0; j<resultSize; j++)
-		for (size_t k = 0; k < resultSize; k++)
+	for (size_t j = 0; j < m * p; j++)
+		for (size_t k = 0; k < n * q; k++)
 		{
-			result[j][k] = (*this)[j / n][k / m] * other[j % n][k % m];
+			result[j][k] = (*this)[j / p][k / q] * other[j % p][k % q];
 		}
 
 	return result;
@@ -227,6 +399,11 @@ template <> cint complex_matrix<cint>::Norm() const
 	return static_cast<int>(floor(sqrt(InnerProduct(*this).Real())));
 }
 
+template <> cfloat complex_matrix<cfloat>::Norm() const
+{
+	return static_cast<float>(sqrt(InnerProduct(*this).Real()));
+}
+
 template <> cdouble complex_matrix<cdouble>::Norm() const
 {
 	return sqrt(InnerProduct(*this).Real());
@@ -295,71 +472,116 @@ namespace
 	{
 		cint_matrix mi;
 		cdouble_matrix md;
+		cfloat_matrix mf;
 
 		cint_matrix miInit(0, 0);
 		cdouble_matrix mdInit(0, 0);
+		cfloat_matrix mfInit(0, 0);
 
 		mi.FromVector(cint_vector());
 		md.FromVector(cdouble_vector());
+		mf.FromVector(cfloat_vector());
 		mi.ToVector();
 		md.ToVector();
+		mf.ToVector();
 
 		mi.FromStringListList({});
 		md.FromStringListList({});
+		mf.FromStringListList({});
 
 		mi.ToStringListList();
 		md.ToStringListList();
+		mf.ToStringListList();
 
 		cint_matrix({ {1} });
 		cdouble_matrix({ {1} });
+		cfloat_matrix({ {1} });
 
 		mi.NearEquals(mi, 0);
 		md.NearEquals(md, 0);
-
-		mi.Add(mi);
-		md.Add(md);
-
-		mi.Conjugate();
-		md.Conjugate();
-
-		mi.Inverse();
-		md.Inverse();
-
-		mi.Multiply(cint());
-		md.Multiply(cdouble());
+		mf.NearEquals(mf, 0);
+
+		mi.AddTo(mi);
+		md.AddTo(md);
+		mf.AddTo(mf);
+		mi.SubtractFrom(mi);
+		md.SubtractFrom(md);
+		mf.SubtractFrom(mf);
+		mi.AddScaled(cint(), mi);
+		md.AddScaled(cdouble(), md);
+		mf.AddScaled(cfloat(), mf);
+
+		mi.ConjugateInPlace();
+		md.ConjugateInPlace();
+		mf.ConjugateInPlace();
+
+		mi.InverseInPlace();
+		md.InverseInPlace();
+		mf.InverseInPlace();
+
+		mi.MultiplyWith(cint());
+		md.MultiplyWith(cdouble());
+		mf.MultiplyWith(cfloat());
 
 		mi.Multiply(cint_matrix({}));
 		md.Multiply(cdouble_matrix({}));
+		mf.Multiply(cfloat_matrix({}));
+		mi.MultiplyWith(mi, mi);
+		md.MultiplyWith(md, md);
+		mf.MultiplyWith(mf, mf);
 
 		mi.Multiply(cint_vector({}));
 		md.Multiply(cdouble_vector({}));
+		mf.Multiply(cfloat_vector({}));
+		cint_vector viResult;
+		cdouble_vector vdResult;
+		cfloat_vector vfResult;
+		mi.Multiply(viResult, viResult);
+		md.Multiply(vdResult, vdResult);
+		mf.Multiply(vfResult, vfResult);
 
 		mi.Power(0);
 		md.Power(0);
+		mf.Power(0);
+		mi.ApplyPower(0, cint_vector());
+		md.ApplyPower(0, cdouble_vector());
+		mf.ApplyPower(0, cfloat_vector());
+		mi.Evolve(0, cint_vector(), 0);
+		md.Evolve(0, cdouble_vector(), 0);
+		mf.Evolve(0, cfloat_vector(), 0);
 
 		mi.Transpose();
 		md.Transpose();
+		mf.Transpose();
 
 		mi.Trace();
 		md.Trace();
+		mf.Trace();
 		mi.InnerProduct(mi);
 		md.InnerProduct(md);
+		mf.InnerProduct(mf);
 
 		mi.TensorProduct(mi);
 		md.TensorProduct(md);
+		mf.TensorProduct(mf);
 
 		mi.Norm();
 		md.Norm();
+		mf.Norm();
 
 		mi.IsDoublyStochastic();
 		md.IsDoublyStochastic();
+		mf.IsDoublyStochastic();
 
 		mi.IsUnitary();
 		md.IsUnitary();
+		mf.IsUnitary();
 
 		mi.CreateZeroMatrix(0, 0);
 		md.CreateZeroMatrix(0, 0);
+		mf.CreateZeroMatrix(0, 0);
 		mi.CreateIdentityMatrix(0);
 		md.CreateIdentityMatrix(0);
+		mf.CreateIdentityMatrix(0);
 	}
 }
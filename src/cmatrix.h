@@ -2,6 +2,8 @@
 
 #include "cvector.h"
 
+namespace ComplexExpression { template <class E> class matrix_expression; } // see cexpression.h
+
 template <class T> class complex_matrix : public std::vector<complex_vector<T>>
 {
 public:
@@ -9,6 +11,12 @@ public:
 	complex_matrix(const std::vector<std::vector<std::string>> & list) { FromStringListList(list); }
 	complex_matrix(const std::vector<std::vector<T>> & list) { FromValueListList(list); }
 	complex_matrix(size_t m, size_t n, T initValue = T());
+	template <class U> explicit complex_matrix(const complex_matrix<U> & other) : std::vector<complex_vector<T>>(other.begin(), other.end()) {} // between precisions
+
+	// evaluation of lazy expressions, these are defined in cexpression.h
+	template <class E> complex_matrix(const ComplexExpression::matrix_expression<E> & expression) { Assign(expression); }
+	template <class E> complex_matrix & operator = (const ComplexExpression::matrix_expression<E> & expression) { return Assign(expression); }
+	template <class E> complex_matrix & Assign(const ComplexExpression::matrix_expression<E> & expression);
 
 	size_t Rows() const { return this->size(); }
 	size_t Cols() const { return (*this)[0].size(); }
@@ -23,30 +31,62 @@ public:
 
 	bool NearEquals(const complex_matrix & other, double epsilon) const;
 
-	complex_matrix Add(const complex_matrix & other) const { return AddOrSubtract(other, &complex_vector<T>::Add); }
-	complex_matrix operator + (const complex_matrix & other) const { return Add(other); }
-	complex_matrix Subtract(const complex_matrix & other) const { return AddOrSubtract(other, &complex_vector<T>::Subtract); }
-	complex_matrix operator - (const complex_matrix & other) const { return Subtract(other); }
-
-	complex_matrix Conjugate() const;
-
-	complex_matrix Inverse() const;
-	complex_matrix operator - () const { return Inverse(); }
-
-	complex_matrix Multiply(const T & scalar) const;
-	complex_matrix operator * (const T & scalar) const { return Multiply(scalar); }
-	complex_matrix operator *= (const T & scalar) { *this * Multiply(scalar); return *this; }
+	// the && overloads work on a temporary's own buffers instead of allocating new ones
+
+	complex_matrix Add(const complex_matrix & other) const & { return complex_matrix(*this).AddTo(other); }
+	complex_matrix Add(const complex_matrix & other) && { return std::move(AddTo(other)); }
+	complex_matrix operator + (const complex_matrix & other) const & { return Add(other); }
+	complex_matrix operator + (const complex_matrix & other) && { return std::move(AddTo(other)); }
+	complex_matrix & AddTo(const complex_matrix & other);
+	complex_matrix & operator += (const complex_matrix & other) { return AddTo(other); }
+
+	complex_matrix Subtract(const complex_matrix & other) const & { return complex_matrix(*this).SubtractFrom(other); }
+	complex_matrix Subtract(const complex_matrix & other) && { return std::move(SubtractFrom(other)); }
+	complex_matrix operator - (const complex_matrix & other) const & { return Subtract(other); }
+	complex_matrix operator - (const complex_matrix & other) && { return std::move(SubtractFrom(other)); }
+	complex_matrix & SubtractFrom(const complex_matrix & other);
+	complex_matrix & operator -= (const complex_matrix & other) { return SubtractFrom(other); }
+
+	complex_matrix & AddScaled(const T & scalar, const complex_matrix & other); // this += scalar * other, without a temporary
+
+	complex_matrix Conjugate() const & { return complex_matrix(*this).ConjugateInPlace(); }
+	complex_matrix Conjugate() && { return std::move(ConjugateInPlace()); }
+	complex_matrix & ConjugateInPlace();
+
+	complex_matrix Inverse() const & { return complex_matrix(*this).InverseInPlace(); }
+	complex_matrix Inverse() && { return std::move(InverseInPlace()); }
+	complex_matrix operator - () const & { return Inverse(); }
+	complex_matrix operator - () && { return std::move(InverseInPlace()); }
+	complex_matrix & InverseInPlace();
+
+	complex_matrix Multiply(const T & scalar) const & { return complex_matrix(*this).MultiplyWith(scalar); }
+	complex_matrix Multiply(const T & scalar) && { return std::move(MultiplyWith(scalar)); }
+	complex_matrix operator * (const T & scalar) const & { return Multiply(scalar); }
+	complex_matrix operator * (const T & scalar) && { return std::move(MultiplyWith(scalar)); }
+	complex_matrix & MultiplyWith(const T & scalar);
+	complex_matrix & operator *= (const T & scalar) { return MultiplyWith(scalar); }
 
 	complex_matrix Multiply(const complex_matrix & other) const;
+	void Multiply(const complex_matrix & other, complex_matrix & result) const; // result is resized as needed, so its rows are reused between calls
 	complex_matrix operator * (const complex_matrix & other) const { return Multiply(other); }
-	complex_matrix operator *= (const complex_matrix & other) { *this = Multiply(other); return *this; }
+	complex_matrix & MultiplyWith(const complex_matrix & other, complex_matrix & workspace); // this = this * other, the product is built in workspace
+	complex_matrix & operator *= (const complex_matrix & other) { complex_matrix workspace; return MultiplyWith(other, workspace); }
 
 	complex_vector<T> Multiply(const complex_vector<T> & other) const;
+	void Multiply(const complex_vector<T> & other, complex_vector<T> & result) const; // result is resized as needed, so it can be reused between calls
 	complex_vector<T> operator * (const complex_vector<T> & other) const { return Multiply(other); }
 
-	complex_matrix Power(size_t k) const;
+	complex_matrix Power(size_t k) const; // by repeated squaring, i.e. about 2 * log2(k) products
 	complex_matrix operator ^ (size_t k) const { return Power(k); }
 
+	// this^k * vector; uses k matrix-vector products instead when that is cheaper than forming this^k
+	complex_vector<T> ApplyPower(size_t k, const complex_vector<T> & vector) const;
+
+	// applies this to state up to steps times, stopping early when the state comes back to its starting value
+	// (the remaining steps are then done modulo the period) or stops changing, both within epsilon (0 compares exactly);
+	// stepsDone, when given, receives the number of products actually computed
+	complex_vector<T> Evolve(size_t steps, const complex_vector<T> & state, double epsilon, size_t * stepsDone = nullptr) const;
+
 	complex_matrix Transpose() const;
 
 	complex_matrix Adjoint() const { return Transpose().Conjugate(); }
@@ -69,9 +109,6 @@ public:
 	static complex_matrix CreateFromVector(const complex_vector<T> & vector) { complex_matrix M; M.FromVector(vector); return M; }
 	static complex_matrix CreateZeroMatrix(size_t m, size_t n);
 	static complex_matrix CreateIdentityMatrix(size_t size);
-
-protected:
-	complex_matrix AddOrSubtract(const complex_matrix & other, complex_vector<T> (complex_vector<T>::*fnPtr)(const complex_vector<T> &) const) const;
 };
 
 
@@ -80,8 +117,14 @@ template <typename T> complex_matrix<T> operator * (const T & scalar, const comp
 	return matrix * scalar;
 }
 
+template <typename T> complex_matrix<T> operator * (const T & scalar, complex_matrix<T> && matrix)
+{
+	return std::move(matrix.MultiplyWith(scalar));
+}
+
 
 typedef complex_matrix<cint> cint_matrix;
+typedef complex_matrix<cfloat> cfloat_matrix;
 typedef complex_matrix<cdouble> cdouble_matrix;
 
 // convenience operators for multiplying matrixes with scalars
@@ -16,6 +16,18 @@ template <> static int complex<int>::ValueFromString(const std::string & valueSt
 	}
 }
 
+template <> static float complex<float>::ValueFromString(const std::string & valueStr, size_t * index)
+{
+	try
+	{
+		return std::stof(valueStr, index);
+	}
+	catch (...)
+	{
+		return 0;
+	}
+}
+
 template <> static double complex<double>::ValueFromString(const std::string & valueStr, size_t * index)
 {
 	try
@@ -79,6 +91,11 @@ template <> cint complex<int>::FromReal(int real)
 	return cint(real, 0);
 }
 
+template <> cfloat complex<float>::FromReal(int real)
+{
+	return cfloat(static_cast<float>(real), 0);
+}
+
 template <> cdouble complex<double>::FromReal(int real)
 {
 	return cdouble(real, 0);
@@ -89,6 +106,11 @@ template <> cint complex<int>::FromReal(double real)
 	return cint(static_cast<int>(floor(real)), 0);
 }
 
+template <> cfloat complex<float>::FromReal(double real)
+{
+	return cfloat(static_cast<float>(real), 0);
+}
+
 template <> cdouble complex<double>::FromReal(double real)
 {
 	return cdouble(real, 0);
@@ -129,7 +151,7 @@ template <class T> bool complex<T>::Equals(const complex & other) const
 
 template <class T> bool complex<T>::NearEquals(const complex & other) const
 {
-	return NearEquals(other, static_cast<T>(DBL_EPSILON * 10)); // for now we allow a 10x epsilon difference
+	return NearEquals(other, static_cast<double>(std::numeric_limits<T>::epsilon()) * 10); // for now we allow a 10x epsilon difference
 }
 
 template <class T> bool complex<T>::NearEquals(const complex & other, double epsilon) const
@@ -214,48 +236,65 @@ namespace {
 	{
 		cint ci("");
 		cdouble cd("");
+		cfloat cf("");
 
 		cint::FromReal(0);
 		cint::FromReal(0.0);
 		cdouble::FromReal(0);
+		cfloat::FromReal(0);
 		cdouble::FromReal(0.0);
+		cfloat::FromReal(0.0);
 
 		ci.ToString();
 		cd.ToString();
+		cf.ToString();
 
 		ci.Equals(cint());
 		cd.Equals(cdouble());
+		cf.Equals(cfloat());
 
 		ci.Add(cint());
 		cd.Add(cdouble());
+		cf.Add(cfloat());
 		ci.AddTo(cint());
 		cd.AddTo(cdouble());
+		cf.AddTo(cfloat());
 
 		ci.Subtract(cint());
 		cd.Subtract(cdouble());
+		cf.Subtract(cfloat());
 		ci.SubtractFrom(cint());
 		cd.SubtractFrom(cdouble());
+		cf.SubtractFrom(cfloat());
 
 		ci.Multiply(cint());
 		cd.Multiply(cdouble());
+		cf.Multiply(cfloat());
 		ci.MultiplyWith(cint());
 		cd.MultiplyWith(cdouble());
+		cf.MultiplyWith(cfloat());
 
 		ci.Divide(cint());
 		cd.Divide(cdouble());
+		cf.Divide(cfloat());
 		ci.DivideWith(cint());
 		cd.DivideWith(cdouble());
+		cf.DivideWith(cfloat());
 
 		(int)ci;
 		(double)cd;
+		(float)cf;
 
 		static_cast<int>(ci);
 		static_cast<double>(cd);
+		static_cast<float>(cf);
 
 		ci.FromPolar(0, 0);
 		cd.FromPolar(0, 0);
+		cf.FromPolar(0, 0);
 
 		ci.ToPolar();
 		cd.ToPolar();
+		cf.ToPolar();
 	}
 }
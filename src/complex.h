@@ -9,6 +9,7 @@ public:
 	complex(T real, T imag) : m_real(real), m_imag(imag) {}
 	complex(T real) : m_real(real), m_imag(0) {}
 	complex(const std::string & valueStr);
+	template <class U> explicit complex(const complex<U> & other) : m_real(static_cast<T>(other.Real())), m_imag(static_cast<T>(other.Imag())) {} // between precisions
 
 	T Real() const { return m_real; }
 	T Imag() const { return m_imag; }
@@ -25,6 +26,7 @@ public:
 
 	bool NearEquals(const complex & other) const; // you should not use this with cint
 	bool NearEquals(const complex & other, double epsilon) const; // or this
+	bool IsZero() const { return m_real == 0 && m_imag == 0; } // exactly zero, unlike == which allows an epsilon for floating point types
 
 	complex Add(const complex & other) const;
 	complex operator + (const complex & other) const { return Add(other); }
@@ -67,4 +69,5 @@ protected:
 
 
 typedef complex<int> cint;
+typedef complex<float> cfloat; // half the memory of cdouble, for large state vectors
 typedef complex<double> cdouble;
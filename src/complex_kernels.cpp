@@ -0,0 +1,397 @@
+#include "complex_kernels.h"
+
+#if defined(__AVX512F__)
+#define QC_SIMD_AVX512
+#elif defined(__AVX__)
+#define QC_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QC_SIMD_SSE2
+#endif
+
+#if defined(QC_SIMD_AVX512) || defined(QC_SIMD_AVX) || defined(QC_SIMD_SSE2)
+#define QC_SIMD
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	template <class T> T GenericDot(const T * a, const T * b, size_t n)
+	{
+		T result;
+		for (size_t i = 0; i < n; i++)
+			result += a[i].Conjugate() * b[i];
+		return result;
+	}
+
+	template <class T> T GenericMultiplyAccumulate(const T * a, const T * b, size_t n)
+	{
+		T result;
+		for (size_t i = 0; i < n; i++)
+			result += a[i] * b[i];
+		return result;
+	}
+
+	template <class T> void GenericAxpy(const T & alpha, const T * x, T * y, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			y[i] += alpha * x[i];
+	}
+
+	template <class T> void GenericScale(const T & alpha, const T * x, T * y, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			y[i] = alpha * x[i];
+	}
+
+	template <class T> void GenericAdd(const T * a, const T * b, T * y, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			y[i] = a[i] + b[i];
+	}
+
+	template <class T> void GenericSubtract(const T * a, const T * b, T * y, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			y[i] = a[i] - b[i];
+	}
+
+	template <class T> void GenericButterfly(T * a, T * b, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			const T x = a[i], y = b[i];
+			a[i] = x + y;
+			b[i] = x - y;
+		}
+	}
+
+	template <class T> void GenericModulusSquared(const T * x, double * y, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			y[i] = static_cast<double>(x[i].ModulusSquared());
+	}
+
+	template <class T> double GenericSumModulusSquared(const T * x, size_t n)
+	{
+		double result = 0;
+		for (size_t i = 0; i < n; i++)
+			result += static_cast<double>(x[i].ModulusSquared());
+		return result;
+	}
+
+#ifdef QC_SIMD
+	// The cdouble kernels view the arrays as interleaved real and imaginary parts. The helpers below hide the
+	// register width; "even" lanes hold real parts and "odd" lanes imaginary parts.
+
+	static_assert(sizeof(cdouble) == 2 * sizeof(double), "cdouble must be laid out as two doubles");
+
+#if defined(QC_SIMD_AVX512)
+	typedef __m512d simd_t;
+	const size_t SIMD_COMPLEX = 4; // complex numbers per register
+	const char * const SIMD_NAME = "AVX-512";
+
+	inline simd_t Load(const double * p) { return _mm512_loadu_pd(p); }
+	inline void Store(double * p, simd_t v) { _mm512_storeu_pd(p, v); }
+	inline simd_t Broadcast(double value) { return _mm512_set1_pd(value); }
+	inline simd_t Zero() { return _mm512_setzero_pd(); }
+	inline simd_t VectorAdd(simd_t a, simd_t b) { return _mm512_add_pd(a, b); }
+	inline simd_t VectorSubtract(simd_t a, simd_t b) { return _mm512_sub_pd(a, b); }
+	inline simd_t VectorMultiply(simd_t a, simd_t b) { return _mm512_mul_pd(a, b); }
+	inline simd_t SwapParts(simd_t a) { return _mm512_permute_pd(a, 0x55); }
+	inline simd_t AddSub(simd_t a, simd_t b) { return _mm512_mask_sub_pd(_mm512_add_pd(a, b), 0x55, a, b); } // even lanes a - b, odd lanes a + b
+#elif defined(QC_SIMD_AVX)
+	typedef __m256d simd_t;
+	const size_t SIMD_COMPLEX = 2;
+	const char * const SIMD_NAME = "AVX";
+
+	inline simd_t Load(const double * p) { return _mm256_loadu_pd(p); }
+	inline void Store(double * p, simd_t v) { _mm256_storeu_pd(p, v); }
+	inline simd_t Broadcast(double value) { return _mm256_set1_pd(value); }
+	inline simd_t Zero() { return _mm256_setzero_pd(); }
+	inline simd_t VectorAdd(simd_t a, simd_t b) { return _mm256_add_pd(a, b); }
+	inline simd_t VectorSubtract(simd_t a, simd_t b) { return _mm256_sub_pd(a, b); }
+	inline simd_t VectorMultiply(simd_t a, simd_t b) { return _mm256_mul_pd(a, b); }
+	inline simd_t SwapParts(simd_t a) { return _mm256_permute_pd(a, 0x5); }
+	inline simd_t AddSub(simd_t a, simd_t b) { return _mm256_addsub_pd(a, b); }
+#else
+	typedef __m128d simd_t;
+	const size_t SIMD_COMPLEX = 1;
+	const char * const SIMD_NAME = "SSE2";
+
+	inline simd_t Load(const double * p) { return _mm_loadu_pd(p); }
+	inline void Store(double * p, simd_t v) { _mm_storeu_pd(p, v); }
+	inline simd_t Broadcast(double value) { return _mm_set1_pd(value); }
+	inline simd_t Zero() { return _mm_setzero_pd(); }
+	inline simd_t VectorAdd(simd_t a, simd_t b) { return _mm_add_pd(a, b); }
+	inline simd_t VectorSubtract(simd_t a, simd_t b) { return _mm_sub_pd(a, b); }
+	inline simd_t VectorMultiply(simd_t a, simd_t b) { return _mm_mul_pd(a, b); }
+	inline simd_t SwapParts(simd_t a) { return _mm_shuffle_pd(a, a, 1); }
+	inline simd_t AddSub(simd_t a, simd_t b) { return _mm_add_pd(a, _mm_xor_pd(b, _mm_set_pd(0.0, -0.0))); } // SSE2 has no addsub, so flip the sign of the even lane
+#endif
+
+	const size_t SIMD_DOUBLES = 2 * SIMD_COMPLEX;
+
+	inline void SumLanes(simd_t v, double & even, double & odd)
+	{
+		double lanes[SIMD_DOUBLES];
+		Store(lanes, v);
+
+		for (size_t i = 0; i < SIMD_DOUBLES; i += 2)
+		{
+			even += lanes[i];
+			odd += lanes[i + 1];
+		}
+	}
+
+	inline const double * Doubles(const cdouble * p) { return reinterpret_cast<const double *>(p); }
+	inline double * Doubles(cdouble * p) { return reinterpret_cast<double *>(p); }
+
+	inline simd_t MultiplyByScalar(simd_t x, simd_t alphaReal, simd_t alphaImag)
+	{ // (xr * ar - xi * ai, xi * ar + xr * ai) for every complex number in the register
+		return AddSub(VectorMultiply(x, alphaReal), VectorMultiply(SwapParts(x), alphaImag));
+	}
+
+	void DotProducts(const cdouble * a, const cdouble * b, size_t n, double sums[4], size_t & done)
+	{ // sums of ar*br, ai*bi, ar*bi and ai*br, from which both the plain and the conjugated products are assembled
+		simd_t straight0 = Zero(), straight1 = Zero(), crossed0 = Zero(), crossed1 = Zero();
+
+		const double * pa = Doubles(a);
+		const double * pb = Doubles(b);
+
+		size_t i = 0;
+		for (; i + 2 * SIMD_COMPLEX <= n; i += 2 * SIMD_COMPLEX) // two independent accumulator chains per product
+		{
+			simd_t va0 = Load(pa + 2 * i), vb0 = Load(pb + 2 * i);
+			simd_t va1 = Load(pa + 2 * i + SIMD_DOUBLES), vb1 = Load(pb + 2 * i + SIMD_DOUBLES);
+
+			straight0 = VectorAdd(straight0, VectorMultiply(va0, vb0));
+			crossed0 = VectorAdd(crossed0, VectorMultiply(va0, SwapParts(vb0)));
+			straight1 = VectorAdd(straight1, VectorMultiply(va1, vb1));
+			crossed1 = VectorAdd(crossed1, VectorMultiply(va1, SwapParts(vb1)));
+		}
+
+		SumLanes(VectorAdd(straight0, straight1), sums[0], sums[1]);
+		SumLanes(VectorAdd(crossed0, crossed1), sums[2], sums[3]);
+
+		done = i;
+	}
+#endif
+}
+
+const char * ComplexKernels::InstructionSet()
+{
+#ifdef QC_SIMD
+	return SIMD_NAME;
+#else
+	return "none";
+#endif
+}
+
+template <class T> T ComplexKernels::Dot(const T * a, const T * b, size_t n) { return GenericDot(a, b, n); }
+template <class T> T ComplexKernels::MultiplyAccumulate(const T * a, const T * b, size_t n) { return GenericMultiplyAccumulate(a, b, n); }
+template <class T> void ComplexKernels::Axpy(const T & alpha, const T * x, T * y, size_t n) { GenericAxpy(alpha, x, y, n); }
+template <class T> void ComplexKernels::Scale(const T & alpha, const T * x, T * y, size_t n) { GenericScale(alpha, x, y, n); }
+template <class T> void ComplexKernels::Add(const T * a, const T * b, T * y, size_t n) { GenericAdd(a, b, y, n); }
+template <class T> void ComplexKernels::Subtract(const T * a, const T * b, T * y, size_t n) { GenericSubtract(a, b, y, n); }
+template <class T> void ComplexKernels::Butterfly(T * a, T * b, size_t n) { GenericButterfly(a, b, n); }
+template <class T> void ComplexKernels::ModulusSquared(const T * x, double * y, size_t n) { GenericModulusSquared(x, y, n); }
+template <class T> double ComplexKernels::SumModulusSquared(const T * x, size_t n) { return GenericSumModulusSquared(x, n); }
+
+#ifdef QC_SIMD
+
+template <> cdouble ComplexKernels::Dot(const cdouble * a, const cdouble * b, size_t n)
+{
+	double sums[4] = {};
+	size_t i;
+	DotProducts(a, b, n, sums, i);
+
+	cdouble result(sums[0] + sums[1], sums[2] - sums[3]); // conj(a) * b = (ar*br + ai*bi, ar*bi - ai*br)
+	return result + GenericDot(a + i, b + i, n - i);
+}
+
+template <> cdouble ComplexKernels::MultiplyAccumulate(const cdouble * a, const cdouble * b, size_t n)
+{
+	double sums[4] = {};
+	size_t i;
+	DotProducts(a, b, n, sums, i);
+
+	cdouble result(sums[0] - sums[1], sums[2] + sums[3]); // a * b = (ar*br - ai*bi, ar*bi + ai*br)
+	return result + GenericMultiplyAccumulate(a + i, b + i, n - i);
+}
+
+template <> void ComplexKernels::Axpy(const cdouble & alpha, const cdouble * x, cdouble * y, size_t n)
+{
+	const simd_t alphaReal = Broadcast(alpha.Real()), alphaImag = Broadcast(alpha.Imag());
+	const double * px = Doubles(x);
+	double * py = Doubles(y);
+
+	size_t i = 0;
+	for (; i + SIMD_COMPLEX <= n; i += SIMD_COMPLEX)
+		Store(py + 2 * i, VectorAdd(Load(py + 2 * i), MultiplyByScalar(Load(px + 2 * i), alphaReal, alphaImag)));
+
+	GenericAxpy(alpha, x + i, y + i, n - i);
+}
+
+template <> void ComplexKernels::Scale(const cdouble & alpha, const cdouble * x, cdouble * y, size_t n)
+{
+	const simd_t alphaReal = Broadcast(alpha.Real()), alphaImag = Broadcast(alpha.Imag());
+	const double * px = Doubles(x);
+	double * py = Doubles(y);
+
+	size_t i = 0;
+	for (; i + SIMD_COMPLEX <= n; i += SIMD_COMPLEX)
+		Store(py + 2 * i, MultiplyByScalar(Load(px + 2 * i), alphaReal, alphaImag));
+
+	GenericScale(alpha, x + i, y + i, n - i);
+}
+
+template <> void ComplexKernels::Add(const cdouble * a, const cdouble * b, cdouble * y, size_t n)
+{
+	const double * pa = Doubles(a);
+	const double * pb = Doubles(b);
+	double * py = Doubles(y);
+
+	size_t i = 0;
+	for (; i + SIMD_COMPLEX <= n; i += SIMD_COMPLEX)
+		Store(py + 2 * i, VectorAdd(Load(pa + 2 * i), Load(pb + 2 * i)));
+
+	GenericAdd(a + i, b + i, y + i, n - i);
+}
+
+template <> void ComplexKernels::Subtract(const cdouble * a, const cdouble * b, cdouble * y, size_t n)
+{
+	const double * pa = Doubles(a);
+	const double * pb = Doubles(b);
+	double * py = Doubles(y);
+
+	size_t i = 0;
+	for (; i + SIMD_COMPLEX <= n; i += SIMD_COMPLEX)
+		Store(py + 2 * i, VectorSubtract(Load(pa + 2 * i), Load(pb + 2 * i)));
+
+	GenericSubtract(a + i, b + i, y + i, n - i);
+}
+
+template <> void ComplexKernels::Butterfly(cdouble * a, cdouble * b, size_t n)
+{
+	double * pa = Doubles(a);
+	double * pb = Doubles(b);
+
+	size_t i = 0;
+	for (; i + SIMD_COMPLEX <= n; i += SIMD_COMPLEX)
+	{
+		simd_t x = Load(pa + 2 * i), y = Load(pb + 2 * i);
+
+		Store(pa + 2 * i, VectorAdd(x, y));
+		Store(pb + 2 * i, VectorSubtract(x, y));
+	}
+
+	GenericButterfly(a + i, b + i, n - i);
+}
+
+template <> void ComplexKernels::ModulusSquared(const cdouble * x, double * y, size_t n)
+{ // two complex numbers at a time with 128-bit registers, which every SIMD level above has
+	const double * px = Doubles(x);
+
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2)
+	{
+		__m128d first = _mm_loadu_pd(px + 2 * i);
+		__m128d second = _mm_loadu_pd(px + 2 * i + 2);
+
+		first = _mm_mul_pd(first, first);
+		second = _mm_mul_pd(second, second);
+
+		_mm_storeu_pd(y + i, _mm_add_pd(_mm_unpacklo_pd(first, second), _mm_unpackhi_pd(first, second)));
+	}
+
+	GenericModulusSquared(x + i, y + i, n - i);
+}
+
+template <> double ComplexKernels::SumModulusSquared(const cdouble * x, size_t n)
+{
+	const double * px = Doubles(x);
+	simd_t sum0 = Zero(), sum1 = Zero();
+
+	size_t i = 0;
+	for (; i + 2 * SIMD_COMPLEX <= n; i += 2 * SIMD_COMPLEX)
+	{
+		simd_t v0 = Load(px + 2 * i), v1 = Load(px + 2 * i + SIMD_DOUBLES);
+		sum0 = VectorAdd(sum0, VectorMultiply(v0, v0));
+		sum1 = VectorAdd(sum1, VectorMultiply(v1, v1));
+	}
+
+	double even = 0, odd = 0;
+	SumLanes(VectorAdd(sum0, sum1), even, odd);
+
+	return even + odd + GenericSumModulusSquared(x + i, n - i);
+}
+
+#else // no SIMD available, the cdouble versions are the generic loops
+
+template <> cdouble ComplexKernels::Dot(const cdouble * a, const cdouble * b, size_t n) { return GenericDot(a, b, n); }
+template <> cdouble ComplexKernels::MultiplyAccumulate(const cdouble * a, const cdouble * b, size_t n) { return GenericMultiplyAccumulate(a, b, n); }
+template <> void ComplexKernels::Axpy(const cdouble & alpha, const cdouble * x, cdouble * y, size_t n) { GenericAxpy(alpha, x, y, n); }
+template <> void ComplexKernels::Scale(const cdouble & alpha, const cdouble * x, cdouble * y, size_t n) { GenericScale(alpha, x, y, n); }
+template <> void ComplexKernels::Add(const cdouble * a, const cdouble * b, cdouble * y, size_t n) { GenericAdd(a, b, y, n); }
+template <> void ComplexKernels::Subtract(const cdouble * a, const cdouble * b, cdouble * y, size_t n) { GenericSubtract(a, b, y, n); }
+template <> void ComplexKernels::Butterfly(cdouble * a, cdouble * b, size_t n) { GenericButterfly(a, b, n); }
+template <> void ComplexKernels::ModulusSquared(const cdouble * x, double * y, size_t n) { GenericModulusSquared(x, y, n); }
+template <> double ComplexKernels::SumModulusSquared(const cdouble * x, size_t n) { return GenericSumModulusSquared(x, n); }
+
+#endif
+
+template <> cfloat ComplexKernels::Dot(const cfloat * a, const cfloat * b, size_t n)
+{
+	cdouble result;
+	for (size_t i = 0; i < n; i++)
+		result += cdouble(a[i].Conjugate()) * cdouble(b[i]);
+
+	return cfloat(result);
+}
+
+template <> cfloat ComplexKernels::MultiplyAccumulate(const cfloat * a, const cfloat * b, size_t n)
+{
+	cdouble result;
+	for (size_t i = 0; i < n; i++)
+		result += cdouble(a[i]) * cdouble(b[i]);
+
+	return cfloat(result);
+}
+
+template <> void ComplexKernels::ModulusSquared(const cfloat * x, double * y, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		y[i] = cdouble(x[i]).ModulusSquared();
+}
+
+template <> double ComplexKernels::SumModulusSquared(const cfloat * x, size_t n)
+{
+	double result = 0;
+	for (size_t i = 0; i < n; i++)
+		result += cdouble(x[i]).ModulusSquared();
+
+	return result;
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		ComplexKernels::Dot<cint>(nullptr, nullptr, 0);
+		ComplexKernels::MultiplyAccumulate<cint>(nullptr, nullptr, 0);
+		ComplexKernels::Axpy<cint>(cint(), nullptr, nullptr, 0);
+		ComplexKernels::Scale<cint>(cint(), nullptr, nullptr, 0);
+		ComplexKernels::Add<cint>(nullptr, nullptr, nullptr, 0);
+		ComplexKernels::Subtract<cint>(nullptr, nullptr, nullptr, 0);
+		ComplexKernels::Butterfly<cint>(nullptr, nullptr, 0);
+
+		ComplexKernels::Axpy<cfloat>(cfloat(), nullptr, nullptr, 0);
+		ComplexKernels::Scale<cfloat>(cfloat(), nullptr, nullptr, 0);
+		ComplexKernels::Add<cfloat>(nullptr, nullptr, nullptr, 0);
+		ComplexKernels::Subtract<cfloat>(nullptr, nullptr, nullptr, 0);
+		ComplexKernels::Butterfly<cfloat>(nullptr, nullptr, 0);
+		ComplexKernels::ModulusSquared<cint>(nullptr, nullptr, 0);
+		ComplexKernels::SumModulusSquared<cint>(nullptr, 0);
+	}
+}
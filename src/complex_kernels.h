@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+#include "complex.h"
+
+// Loops over arrays of complex numbers that the vector and matrix classes spend most of their time in.
+// The cdouble versions are vectorized with the widest instruction set the compiler targets (AVX-512, AVX or
+// SSE2, selected at compile time), the generic versions are plain loops.
+// The cfloat versions of the sums accumulate in double, so float storage keeps close to double results.
+// Output arrays may be the same as input arrays, but must not partially overlap them.
+namespace ComplexKernels
+{
+	const char * InstructionSet(); // name of the instruction set used for the cdouble kernels
+
+	template <class T> T Dot(const T * a, const T * b, size_t n); // sum of conj(a[i]) * b[i], i.e. the inner product
+	template <class T> T MultiplyAccumulate(const T * a, const T * b, size_t n); // sum of a[i] * b[i]
+
+	template <class T> void Axpy(const T & alpha, const T * x, T * y, size_t n); // y[i] += alpha * x[i]
+	template <class T> void Scale(const T & alpha, const T * x, T * y, size_t n); // y[i] = alpha * x[i]
+
+	template <class T> void Add(const T * a, const T * b, T * y, size_t n); // y[i] = a[i] + b[i]
+	template <class T> void Subtract(const T * a, const T * b, T * y, size_t n); // y[i] = a[i] - b[i]
+	template <class T> void Butterfly(T * a, T * b, size_t n); // (a[i], b[i]) = (a[i] + b[i], a[i] - b[i]), the Walsh-Hadamard step
+
+	template <class T> void ModulusSquared(const T * x, double * y, size_t n); // y[i] = |x[i]|^2
+	template <class T> double SumModulusSquared(const T * x, size_t n); // sum of |x[i]|^2, i.e. the squared norm
+
+	template <> cdouble Dot(const cdouble * a, const cdouble * b, size_t n);
+	template <> cdouble MultiplyAccumulate(const cdouble * a, const cdouble * b, size_t n);
+	template <> void Axpy(const cdouble & alpha, const cdouble * x, cdouble * y, size_t n);
+	template <> void Scale(const cdouble & alpha, const cdouble * x, cdouble * y, size_t n);
+	template <> void Add(const cdouble * a, const cdouble * b, cdouble * y, size_t n);
+	template <> void Subtract(const cdouble * a, const cdouble * b, cdouble * y, size_t n);
+	template <> void Butterfly(cdouble * a, cdouble * b, size_t n);
+	template <> void ModulusSquared(const cdouble * x, double * y, size_t n);
+	template <> double SumModulusSquared(const cdouble * x, size_t n);
+
+	template <> cfloat Dot(const cfloat * a, const cfloat * b, size_t n);
+	template <> cfloat MultiplyAccumulate(const cfloat * a, const cfloat * b, size_t n);
+	template <> void ModulusSquared(const cfloat * x, double * y, size_t n);
+	template <> double SumModulusSquared(const cfloat * x, size_t n);
+}
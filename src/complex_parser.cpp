@@ -0,0 +1,362 @@
+#include "complex_parser.h"
+#include "memory_mapped_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	inline bool IsSeparator(char c) { return c == ' ' || c == '\t' || c == '\r' || c == ','; }
+	inline bool IsNumberStart(char c) { return (c >= '0' && c <= '9') || c == '.'; }
+
+	const char * ReadNumber(const char * p, const char * end, int & value, std::errc & error)
+	{
+		auto result = std::from_chars(p, end, value);
+		error = result.ec;
+		return result.ptr;
+	}
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611
+	template <class S> const char * ReadNumber(const char * p, const char * end, S & value, std::errc & error)
+	{
+		auto result = std::from_chars(p, end, value, std::chars_format::general);
+		error = result.ec;
+		return result.ptr;
+	}
+#else
+	template <class S> const char * ReadNumber(const char * p, const char * end, S & value, std::errc & error)
+	{ // standard libraries without the floating point from_chars: strtod on a terminated copy of the number
+		char buffer[64];
+		size_t length = std::min(sizeof(buffer) - 1, size_t(end - p));
+		memcpy(buffer, p, length);
+		buffer[length] = 0;
+
+		char * stop;
+		errno = 0;
+		value = static_cast<S>(strtod(buffer, &stop));
+		error = errno == ERANGE ? std::errc::result_out_of_range : stop == buffer ? std::errc::invalid_argument : std::errc();
+
+		return p + (stop - buffer);
+	}
+#endif
+
+	// reads the literals of a text one after the other, from the start to the end
+	template <class T> class reader
+	{
+	public:
+		typedef decltype(T().Real()) scalar;
+
+		reader(std::string_view text, const std::string & source) : m_text(text), m_source(source), m_p(text.data()), m_end(text.data() + text.size()) {}
+
+		// the next literal, if there is one before the end of the text, or of the line unless acrossLines
+		bool Next(T & value, bool acrossLines)
+		{
+			while (m_p < m_end && (IsSeparator(*m_p) || (acrossLines && *m_p == '\n')))
+				m_p++;
+
+			if (m_p == m_end || *m_p == '\n')
+				return false;
+
+			m_token = m_p;
+			value = ReadLiteral();
+
+			return true;
+		}
+
+		bool AtLineEnd()
+		{
+			while (m_p < m_end && IsSeparator(*m_p))
+				m_p++;
+
+			return m_p == m_end || *m_p == '\n';
+		}
+
+		bool NextLine() // past the end of the current line, if it is not the last one
+		{
+			if (!AtLineEnd())
+				Fail(m_p, "unexpected character");
+
+			if (m_p == m_end)
+				return false;
+
+			m_p++;
+			return true;
+		}
+
+		const char * Position() const { return m_p; }
+		const char * Token() const { return m_token; } // where the last literal started
+
+		[[noreturn]] void Fail(const char * at, const std::string & message) const
+		{
+			throw ComplexParser::parse_error(m_text, size_t(at - m_text.data()), message, m_source);
+		}
+
+	protected:
+		T ReadLiteral()
+		{ // [sign] (number | number i | i | number sign (number i | i))
+			const char * p = m_p;
+			scalar real = 0, imag = 0;
+
+			const char * sign = p;
+			if (*p == '+' || *p == '-')
+				p++;
+
+			if (p < m_end && *p == 'i')
+			{
+				imag = *sign == '-' ? -1 : 1;
+				p++;
+			}
+			else
+			{
+				scalar first;
+				p = Number(sign, p, first);
+
+				if (p < m_end && *p == 'i')
+				{
+					imag = first;
+					p++;
+				}
+				else
+				{
+					real = first;
+
+					if (p < m_end && (*p == '+' || *p == '-'))
+					{
+						sign = p++;
+
+						if (p < m_end && *p == 'i')
+						{
+							imag = *sign == '-' ? -1 : 1;
+							p++;
+						}
+						else
+						{
+							p = Number(sign, p, imag);
+
+							if (p == m_end || *p != 'i')
+								Fail(p, "expected 'i'");
+							p++;
+						}
+					}
+				}
+			}
+
+			if (p < m_end && !IsSeparator(*p) && *p != '\n')
+				Fail(p, "unexpected character");
+
+			m_p = p;
+			return T(real, imag);
+		}
+
+		const char * Number(const char * sign, const char * p, scalar & value) const
+		{ // from_chars takes a minus sign but not a plus sign, and nothing else may come between the sign and the digits
+			if (p == m_end || !IsNumberStart(*p))
+				Fail(p, "expected a number");
+
+			std::errc error;
+			const char * result = ReadNumber(*sign == '-' ? sign : p, m_end, value, error);
+
+			if (error == std::errc::result_out_of_range)
+				Fail(p, "the number is out of range");
+			if (error != std::errc())
+				Fail(p, "expected a number");
+
+			return result;
+		}
+
+		std::string_view m_text;
+		std::string m_source; // the file, in the messages
+		const char * m_p;
+		const char * m_end;
+		const char * m_token = nullptr;
+	};
+
+	template <class T> void ParseVector(std::string_view text, complex_vector<T> & vector, const std::string & source)
+	{
+		reader<T> reader(text, source);
+
+		for (size_t i = 0; i < vector.size(); i++)
+			if (!reader.Next(vector[i], true))
+				reader.Fail(reader.Position(), "expected " + std::to_string(vector.size()) + " literals, found " + std::to_string(i));
+
+		T extra;
+		if (reader.Next(extra, true))
+			reader.Fail(reader.Token(), "expected " + std::to_string(vector.size()) + " literals, found more");
+	}
+
+	template <class T> complex_vector<T> ParseVector(std::string_view text, const std::string & source)
+	{
+		reader<T> reader(text, source);
+		complex_vector<T> result;
+
+		T value;
+		while (reader.Next(value, true))
+			result.push_back(value);
+
+		return result;
+	}
+
+	template <class T> void ParseMatrix(std::string_view text, complex_matrix<T> & matrix, const std::string & source)
+	{
+		reader<T> reader(text, source);
+		size_t row = 0;
+
+		do
+		{
+			if (reader.AtLineEnd())
+				continue;
+
+			if (row == matrix.Rows())
+				reader.Fail(reader.Position(), "expected " + std::to_string(matrix.Rows()) + " rows, found more");
+
+			complex_vector<T> & elements = matrix[row++];
+
+			for (size_t j = 0; j < elements.size(); j++)
+				if (!reader.Next(elements[j], false))
+					reader.Fail(reader.Position(), "expected " + std::to_string(elements.size()) + " elements in the row, found " + std::to_string(j));
+
+			T extra;
+			if (reader.Next(extra, false))
+				reader.Fail(reader.Token(), "expected " + std::to_string(elements.size()) + " elements in the row, found more");
+		} while (reader.NextLine());
+
+		if (row != matrix.Rows())
+			reader.Fail(reader.Position(), "expected " + std::to_string(matrix.Rows()) + " rows, found " + std::to_string(row));
+	}
+
+	template <class T> complex_matrix<T> ParseMatrix(std::string_view text, const std::string & source)
+	{
+		reader<T> reader(text, source);
+		complex_matrix<T> result;
+
+		do
+		{
+			const char * lineStart = reader.Position();
+			complex_vector<T> row;
+			row.reserve(result.empty() ? 0 : result.Cols());
+
+			T value;
+			while (reader.Next(value, false))
+				row.push_back(value);
+
+			if (row.empty())
+				continue;
+
+			if (!result.empty() && row.size() != result.Cols())
+				reader.Fail(lineStart, "the row has " + std::to_string(row.size()) + " elements, the first one has " + std::to_string(result.Cols()));
+
+			result.push_back(std::move(row));
+		} while (reader.NextLine());
+
+		return result;
+	}
+
+	size_t LineOf(std::string_view text, size_t offset)
+	{
+		return 1 + std::count(text.begin(), text.begin() + std::min(offset, text.size()), '\n');
+	}
+
+	size_t ColumnOf(std::string_view text, size_t offset)
+	{
+		size_t newline = text.substr(0, offset).rfind('\n');
+		return newline == std::string_view::npos ? offset + 1 : offset - newline;
+	}
+
+	std::string_view Text(const memory_mapped_file & file)
+	{
+		return std::string_view(file.Data(), file.Size());
+	}
+}
+
+ComplexParser::parse_error::parse_error(std::string_view text, size_t offset, const std::string & message, const std::string & source /*= ""*/)
+	: std::runtime_error((source.empty() ? "" : source + ", ") + "line " + std::to_string(LineOf(text, offset)) + ", column " + std::to_string(ColumnOf(text, offset)) + ": " + message),
+	m_offset(offset), m_line(LineOf(text, offset)), m_column(ColumnOf(text, offset))
+{
+}
+
+template <class T> T ComplexParser::ParseValue(std::string_view text)
+{
+	reader<T> reader(text, "");
+
+	T value;
+	if (!reader.Next(value, true))
+		reader.Fail(reader.Position(), "expected a number");
+
+	T extra;
+	if (reader.Next(extra, true))
+		reader.Fail(reader.Token(), "expected a single literal");
+
+	return value;
+}
+
+template <class T> complex_vector<T> ComplexParser::ParseVector(std::string_view text)
+{
+	return ::ParseVector<T>(text, "");
+}
+
+template <class T> void ComplexParser::ParseVector(std::string_view text, complex_vector<T> & vector)
+{
+	::ParseVector(text, vector, "");
+}
+
+template <class T> complex_matrix<T> ComplexParser::ParseMatrix(std::string_view text)
+{
+	return ::ParseMatrix<T>(text, "");
+}
+
+template <class T> void ComplexParser::ParseMatrix(std::string_view text, complex_matrix<T> & matrix)
+{
+	::ParseMatrix(text, matrix, "");
+}
+
+template <class T> complex_vector<T> ComplexParser::LoadVector(const std::string & path)
+{
+	memory_mapped_file file(path, false);
+	return ::ParseVector<T>(Text(file), path);
+}
+
+template <class T> complex_matrix<T> ComplexParser::LoadMatrix(const std::string & path)
+{
+	memory_mapped_file file(path, false);
+	return ::ParseMatrix<T>(Text(file), path);
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		cint_vector vi;
+		cint_matrix mi;
+		ComplexParser::ParseValue<cint>("");
+		ComplexParser::ParseVector<cint>("");
+		ComplexParser::ParseVector<cint>("", vi);
+		ComplexParser::ParseMatrix<cint>("");
+		ComplexParser::ParseMatrix<cint>("", mi);
+		ComplexParser::LoadVector<cint>("");
+		ComplexParser::LoadMatrix<cint>("");
+
+		cfloat_vector vf;
+		cfloat_matrix mf;
+		ComplexParser::ParseValue<cfloat>("");
+		ComplexParser::ParseVector<cfloat>("");
+		ComplexParser::ParseVector<cfloat>("", vf);
+		ComplexParser::ParseMatrix<cfloat>("");
+		ComplexParser::ParseMatrix<cfloat>("", mf);
+		ComplexParser::LoadVector<cfloat>("");
+		ComplexParser::LoadMatrix<cfloat>("");
+
+		cdouble_vector vd;
+		cdouble_matrix md;
+		ComplexParser::ParseValue<cdouble>("");
+		ComplexParser::ParseVector<cdouble>("");
+		ComplexParser::ParseVector<cdouble>("", vd);
+		ComplexParser::ParseMatrix<cdouble>("");
+		ComplexParser::ParseMatrix<cdouble>("", md);
+		ComplexParser::LoadVector<cdouble>("");
+		ComplexParser::LoadMatrix<cdouble>("");
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "cmatrix.h"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Bulk parsing of complex literals in the book notation of complex(const std::string &): 3, -2.5, 3+4i, 3-i,
+// 4i, -i. The literals are separated by whitespace or commas, and a matrix has one row per line; empty lines are
+// skipped. The numbers are read with std::from_chars straight out of the text, without copying or allocating,
+// into the elements of the vector or matrix.
+//
+// Unlike complex(const std::string &), which reads what it can and takes 0 for the rest, anything that is not
+// a literal is an error: a parse_error with the line and column where the text stops making sense.
+namespace ComplexParser
+{
+	class parse_error : public std::runtime_error
+	{
+	public:
+		parse_error(std::string_view text, size_t offset, const std::string & message, const std::string & source = "");
+
+		size_t Offset() const { return m_offset; } // from the start of the text
+		size_t Line() const { return m_line; } // from 1
+		size_t Column() const { return m_column; } // from 1, in bytes
+
+	protected:
+		size_t m_offset, m_line, m_column;
+	};
+
+	template <class T> T ParseValue(std::string_view text); // exactly one literal, with optional whitespace around it
+
+	template <class T> complex_vector<T> ParseVector(std::string_view text); // as many elements as there are literals
+	template <class T> void ParseVector(std::string_view text, complex_vector<T> & vector); // exactly vector.size() literals
+
+	template <class T> complex_matrix<T> ParseMatrix(std::string_view text); // all the rows must have the same size
+	template <class T> void ParseMatrix(std::string_view text, complex_matrix<T> & matrix); // exactly the shape of matrix
+
+	// the file is mapped into memory and parsed in place; the parse_error names the file
+	template <class T> complex_vector<T> LoadVector(const std::string & path);
+	template <class T> complex_matrix<T> LoadMatrix(const std::string & path);
+}
@@ -0,0 +1,249 @@
+#include "complex_writer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const size_t MAX_ELEMENT_BYTES = 160; // two numbers of at most 64 characters, a separator, the signs and the brackets
+
+	template <class S> using real_type = typename std::conditional<std::is_integral<S>::value, double, S>::type; // of the polar form
+
+	bool WriteAll(int fileDescriptor, const char * data, size_t bytes)
+	{
+		while (bytes)
+		{
+#ifdef _WIN32
+			int written = _write(fileDescriptor, data, unsigned(std::min<size_t>(bytes, 1 << 30)));
+#else
+			ssize_t written = write(fileDescriptor, data, bytes);
+#endif
+			if (written <= 0)
+				return false;
+
+			data += written;
+			bytes -= size_t(written);
+		}
+
+		return true;
+	}
+}
+
+complex_writer::complex_writer(std::ostream & stream, int format /*= BOOK*/, int precision /*= 0*/)
+	: m_stream(&stream), m_buffer(new char[BUFFER_SIZE])
+{
+	SetFormat(format);
+	SetPrecision(precision);
+}
+
+complex_writer::complex_writer(int fileDescriptor, int format /*= BOOK*/, int precision /*= 0*/)
+	: m_fileDescriptor(fileDescriptor), m_buffer(new char[BUFFER_SIZE])
+{
+	SetFormat(format);
+	SetPrecision(precision);
+}
+
+complex_writer::~complex_writer()
+{
+	try
+	{
+		Flush();
+	}
+	catch (...)
+	{
+	}
+}
+
+void complex_writer::SetFormat(int format)
+{
+	if (format != BOOK && format != CSV && format != POLAR)
+		throw std::invalid_argument("Unknown format");
+
+	m_format = format;
+}
+
+void complex_writer::SetPrecision(int precision)
+{
+	if (precision < 0 || precision > 40)
+		throw std::out_of_range("The precision must be between 0 and 40 digits");
+
+	m_precision = precision;
+}
+
+void complex_writer::Flush()
+{
+	if (m_used == 0)
+		return;
+
+	bool written = m_stream ? bool(m_stream->write(m_buffer.get(), std::streamsize(m_used))) : WriteAll(m_fileDescriptor, m_buffer.get(), m_used);
+	m_used = 0;
+
+	if (!written)
+		throw std::runtime_error("Cannot write the output");
+}
+
+char * complex_writer::Reserve(size_t bytes)
+{
+	if (m_used + bytes > BUFFER_SIZE)
+		Flush();
+
+	return m_buffer.get() + m_used;
+}
+
+complex_writer & complex_writer::Write(std::string_view text)
+{
+	while (!text.empty())
+	{
+		char * p = Reserve(1);
+		size_t n = std::min(text.size(), BUFFER_SIZE - m_used);
+
+		memcpy(p, text.data(), n);
+		m_used += n;
+		text.remove_prefix(n);
+	}
+
+	return *this;
+}
+
+template <class S> char * complex_writer::WriteNumber(char * p, S value)
+{
+	char * end = p + MAX_ELEMENT_BYTES / 2;
+
+	if constexpr (std::is_integral<S>::value)
+		return std::to_chars(p, end, value).ptr;
+	else
+	{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611
+		return (m_precision ? std::to_chars(p, end, value, std::chars_format::general, m_precision) : std::to_chars(p, end, value)).ptr;
+#else // standard libraries without the floating point to_chars; the shortest digits that are sure to read back
+		int digits = m_precision ? m_precision : std::numeric_limits<S>::max_digits10;
+		return p + snprintf(p, size_t(end - p), "%.*g", digits, double(value));
+#endif
+	}
+}
+
+template <class T> char * complex_writer::WriteElement(char * p, const complex<T> & value)
+{
+	const T real = value.Real(), imag = value.Imag();
+
+	if (m_format == CSV)
+	{
+		p = WriteNumber(p, real);
+		*p++ = ',';
+		return WriteNumber(p, imag);
+	}
+
+	if (m_format == POLAR)
+	{
+		const real_type<T> x = static_cast<real_type<T>>(real), y = static_cast<real_type<T>>(imag);
+
+		*p++ = '(';
+		p = WriteNumber(p, static_cast<real_type<T>>(std::hypot(x, y)));
+		*p++ = ',';
+		p = WriteNumber(p, static_cast<real_type<T>>(std::atan2(y, x)));
+		*p++ = ')';
+		return p;
+	}
+
+	// as complex::ToString: the real part unless it is 0, then the imaginary part unless it is 0, without a 1 before the i
+	const bool hasReal = real != 0 || imag == 0;
+
+	if (hasReal)
+		p = WriteNumber(p, real);
+
+	if (imag != 0)
+	{
+		if (imag < 0)
+			*p++ = '-';
+		else if (hasReal)
+			*p++ = '+';
+
+		const T absImag = imag < 0 ? -imag : imag;
+		if (absImag != 1)
+			p = WriteNumber(p, absImag);
+
+		*p++ = 'i';
+	}
+
+	return p;
+}
+
+template <class T> void complex_writer::WriteRow(const complex<T> * values, size_t count, char separator)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		char * p = Reserve(MAX_ELEMENT_BYTES);
+
+		if (i)
+			*p++ = separator;
+
+		p = WriteElement(p, values[i]);
+		m_used = size_t(p - m_buffer.get());
+	}
+
+	*Reserve(1) = '\n';
+	m_used++;
+}
+
+template <class T> complex_writer & complex_writer::Write(const complex<T> & value)
+{
+	char * p = Reserve(MAX_ELEMENT_BYTES);
+	m_used = size_t(WriteElement(p, value) - m_buffer.get());
+
+	return *this;
+}
+
+template <class T> complex_writer & complex_writer::Write(const complex_vector<T> & vector)
+{
+	if (m_format == CSV) // a column
+	{
+		for (const auto & value : vector)
+			WriteRow(&value, 1, ',');
+	}
+	else
+		WriteRow(vector.data(), vector.size(), ' ');
+
+	return *this;
+}
+
+template <class T> complex_writer & complex_writer::Write(const complex_matrix<T> & matrix)
+{
+	for (const auto & row : matrix)
+		WriteRow(row.data(), row.size(), m_format == CSV ? ',' : ' ');
+
+	return *this;
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		complex_writer writer(-1);
+
+		writer.Write(cint());
+		writer.Write(cint_vector());
+		writer.Write(cint_matrix());
+
+		writer.Write(cfloat());
+		writer.Write(cfloat_vector());
+		writer.Write(cfloat_matrix());
+
+		writer.Write(cdouble());
+		writer.Write(cdouble_vector());
+		writer.Write(cdouble_matrix());
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "cmatrix.h"
+
+#include <iosfwd>
+#include <memory>
+#include <string_view>
+
+// Streaming output of complex numbers, vectors and matrices. The numbers are formatted with std::to_chars into
+// one reusable buffer, which goes to the stream or file descriptor whenever it is full, so writing a matrix
+// costs no strings at all, however large it is. The formats:
+//
+//   BOOK   3+4i, -i, 2.5 as complex::ToString; a vector on one line, a matrix one row per line, separated
+//          by spaces, which is what ComplexParser reads back
+//   CSV    the real and imaginary parts as two columns; a vector one element per line, a matrix one row per line
+//   POLAR  (modulus,angle) with the angle in radians, laid out as BOOK
+//
+// A precision of 0 gives the shortest text that reads back to the same number, otherwise it is the number of
+// significant digits.
+class complex_writer
+{
+public:
+	static const int BOOK = 0;
+	static const int CSV = 1;
+	static const int POLAR = 2;
+
+	static const size_t BUFFER_SIZE = 1 << 16;
+
+	explicit complex_writer(std::ostream & stream, int format = BOOK, int precision = 0);
+	explicit complex_writer(int fileDescriptor, int format = BOOK, int precision = 0); // the descriptor stays open
+	~complex_writer(); // flushes, but cannot report an error, so call Flush() first if that matters
+
+	complex_writer(const complex_writer &) = delete;
+	complex_writer & operator=(const complex_writer &) = delete;
+
+	int Format() const { return m_format; }
+	void SetFormat(int format);
+	int Precision() const { return m_precision; }
+	void SetPrecision(int precision);
+
+	template <class T> complex_writer & Write(const complex<T> & value);
+	template <class T> complex_writer & Write(const complex_vector<T> & vector); // ends with a line break
+	template <class T> complex_writer & Write(const complex_matrix<T> & matrix);
+	complex_writer & Write(std::string_view text);
+
+	void Flush(); // throws std::runtime_error if the output fails
+
+protected:
+	char * Reserve(size_t bytes); // room for at least this many bytes at the end of the buffer
+	template <class S> char * WriteNumber(char * p, S value);
+	template <class T> char * WriteElement(char * p, const complex<T> & value);
+	template <class T> void WriteRow(const complex<T> * values, size_t count, char separator);
+
+	std::ostream * m_stream = nullptr;
+	int m_fileDescriptor = -1;
+
+	int m_format;
+	int m_precision;
+
+	std::unique_ptr<char[]> m_buffer;
+	size_t m_used = 0;
+};
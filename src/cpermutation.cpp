@@ -0,0 +1,205 @@
+#include "cpermutation.h"
+
+template <class T> permutation_operator<T>::permutation_operator(size_t size)
+	: m_targets(size)
+{
+	for (size_t i = 0; i < size; i++)
+		m_targets[i] = i;
+}
+
+template <class T> void permutation_operator<T>::FromTargets(const std::vector<size_t> & targets)
+{
+	size_t n = targets.size();
+	std::vector<bool> hit(n, false);
+
+	for (size_t target : targets)
+	{
+		if (target >= n || hit[target])
+			throw std::invalid_argument("The targets are not a permutation");
+
+		hit[target] = true;
+	}
+
+	m_targets = targets;
+}
+
+template <class T> void permutation_operator<T>::FromMatrix(const complex_matrix<T> & matrix)
+{
+	size_t n = matrix.Rows();
+
+	const T one(1);
+	std::vector<size_t> targets(n, n);
+
+	for (size_t i = 0; i < n; i++)
+	{
+		const complex_vector<T> & row = matrix[i];
+
+		if (row.size() != n)
+			throw std::out_of_range("A permutation operator can only be created from a square matrix");
+
+		for (size_t j = 0; j < n; j++)
+		{
+			if (row[j].IsZero())
+				continue;
+
+			if (row[j] != one || targets[j] != n)
+				throw std::invalid_argument("The matrix is not a permutation matrix");
+
+			targets[j] = i;
+		}
+	}
+
+	FromTargets(targets); // also catches rows without a 1
+}
+
+template <class T> complex_matrix<T> permutation_operator<T>::ToMatrix() const
+{
+	size_t n = Size();
+	complex_matrix<T> result(n, n);
+
+	for (size_t i = 0; i < n; i++)
+		result[m_targets[i]][i] = T(1);
+
+	return result;
+}
+
+template <class T> complex_vector<T> permutation_operator<T>::Multiply(const complex_vector<T> & other) const
+{
+	complex_vector<T> result;
+	Multiply(other, result);
+
+	return result;
+}
+
+template <class T> void permutation_operator<T>::Multiply(const complex_vector<T> & other, complex_vector<T> & result) const
+{
+	size_t n = Size();
+
+	if (other.size() != n)
+		throw std::out_of_range("Incompatible operator and vector sizes for multiplication");
+
+	if (&result == &other) // amplitudes would be overwritten before they are moved
+	{
+		complex_vector<T> temp;
+		Multiply(other, temp);
+		result.swap(temp);
+		return;
+	}
+
+	result.resize(n);
+
+	for (size_t i = 0; i < n; i++)
+		result[m_targets[i]] = other[i];
+}
+
+template <class T> complex_matrix<T> permutation_operator<T>::Multiply(const complex_matrix<T> & other) const
+{
+	size_t n = Size();
+
+	if (other.Rows() != n)
+		throw std::out_of_range("Incompatible matrix sizes for multiplication");
+
+	complex_matrix<T> result;
+	result.resize(n);
+
+	for (size_t i = 0; i < n; i++)
+		result[m_targets[i]] = other[i];
+
+	return result;
+}
+
+template <class T> permutation_operator<T> permutation_operator<T>::Multiply(const permutation_operator & other) const
+{
+	size_t n = Size();
+
+	if (other.Size() != n)
+		throw std::out_of_range("Incompatible operator sizes for multiplication");
+
+	permutation_operator<T> result;
+	result.m_targets.resize(n);
+
+	for (size_t i = 0; i < n; i++)
+		result.m_targets[i] = m_targets[other.m_targets[i]];
+
+	return result;
+}
+
+template <class T> permutation_operator<T> permutation_operator<T>::Invert() const
+{
+	size_t n = Size();
+
+	permutation_operator<T> result;
+	result.m_targets.resize(n);
+
+	for (size_t i = 0; i < n; i++)
+		result.m_targets[m_targets[i]] = i;
+
+	return result;
+}
+
+template <class T> permutation_operator<T> permutation_operator<T>::TensorProduct(const permutation_operator & other) const
+{
+	size_t m = Size(), n = other.Size();
+
+	permutation_operator<T> result;
+	result.m_targets.resize(m * n);
+
+	for (size_t i = 0; i < m; i++)
+		for (size_t j = 0; j < n; j++)
+			result.m_targets[i * n + j] = m_targets[i] * n + other.m_targets[j];
+
+	return result;
+}
+
+template <class T> permutation_operator<T> permutation_operator<T>::CreateOracle(size_t inputBits, size_t outputBits, const std::function<size_t(size_t)> & f)
+{
+	const size_t inputs = size_t(1) << inputBits, outputs = size_t(1) << outputBits;
+
+	permutation_operator<T> result;
+	result.m_targets.resize(inputs * outputs);
+
+	for (size_t x = 0; x < inputs; x++)
+	{
+		size_t fx = f(x);
+
+		if (fx >= outputs)
+			throw std::out_of_range("Oracle function value does not fit in the output bits");
+
+		for (size_t y = 0; y < outputs; y++)
+			result.m_targets[x * outputs + y] = x * outputs + (y ^ fx);
+	}
+
+	return result;
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		cint_permutation_operator pi(1);
+		cdouble_permutation_operator pd(1);
+
+		pi.FromTargets({});
+		pd.FromTargets({});
+		pi.FromMatrix(cint_matrix());
+		pd.FromMatrix(cdouble_matrix());
+		pi.ToMatrix();
+		pd.ToMatrix();
+
+		pi.Multiply(cint_vector());
+		pd.Multiply(cdouble_vector());
+		pi.Multiply(cint_matrix());
+		pd.Multiply(cdouble_matrix());
+		pi.Multiply(pi);
+		pd.Multiply(pd);
+
+		pi.Invert();
+		pd.Invert();
+		pi.TensorProduct(pi);
+		pd.TensorProduct(pd);
+
+		cint_permutation_operator::CreateOracle(0, 0, nullptr);
+		cdouble_permutation_operator::CreateOracle(0, 0, nullptr);
+	}
+}
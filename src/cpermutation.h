@@ -0,0 +1,58 @@
+#pragma once
+
+#include <functional>
+
+#include "cmatrix.h"
+
+// Permutation matrix, stored as the image of every basis state: column i has its only 1 in row Target(i).
+// Reversible oracles like Uf, CNOT and Toffoli are permutations of the basis states, so applying them is
+// a single pass moving the amplitudes, and composing and inverting them are linear in the size as well.
+template <class T> class permutation_operator
+{
+public:
+	permutation_operator() = default;
+	explicit permutation_operator(size_t size); // identity
+	explicit permutation_operator(const std::vector<size_t> & targets) { FromTargets(targets); }
+
+	size_t Size() const { return m_targets.size(); }
+	size_t Rows() const { return Size(); }
+	size_t Cols() const { return Size(); }
+
+	size_t Target(size_t i) const { return m_targets[i]; } // basis state i is mapped to basis state Target(i)
+	const std::vector<size_t> & Targets() const { return m_targets; }
+
+	void FromTargets(const std::vector<size_t> & targets); // throws if the targets are not a permutation
+	void FromMatrix(const complex_matrix<T> & matrix); // throws if the matrix is not a permutation matrix
+	complex_matrix<T> ToMatrix() const;
+
+	bool Equals(const permutation_operator & other) const { return m_targets == other.m_targets; }
+	bool operator == (const permutation_operator & other) const { return Equals(other); }
+	bool operator != (const permutation_operator & other) const { return !Equals(other); }
+
+	complex_vector<T> Multiply(const complex_vector<T> & other) const;
+	void Multiply(const complex_vector<T> & other, complex_vector<T> & result) const; // result is resized as needed, it can be the input
+	complex_vector<T> operator * (const complex_vector<T> & other) const { return Multiply(other); }
+	void Apply(complex_vector<T> & state) const { Multiply(state, state); }
+
+	complex_matrix<T> Multiply(const complex_matrix<T> & other) const; // moves the rows of other
+	complex_matrix<T> operator * (const complex_matrix<T> & other) const { return Multiply(other); }
+
+	permutation_operator Multiply(const permutation_operator & other) const; // other is applied first
+	permutation_operator operator * (const permutation_operator & other) const { return Multiply(other); }
+
+	permutation_operator Invert() const;
+	permutation_operator Adjoint() const { return Invert(); } // same for permutations
+	permutation_operator Dagger() const { return Invert(); } // alias
+
+	permutation_operator TensorProduct(const permutation_operator & other) const;
+
+	// the oracle Uf|x, y> = |x, y xor f(x)> for f from inputBits to outputBits bits, x being the most significant part
+	static permutation_operator CreateOracle(size_t inputBits, size_t outputBits, const std::function<size_t(size_t)> & f);
+
+protected:
+	std::vector<size_t> m_targets;
+};
+
+
+typedef permutation_operator<cint> cint_permutation_operator;
+typedef permutation_operator<cdouble> cdouble_permutation_operator;
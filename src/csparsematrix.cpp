@@ -0,0 +1,381 @@
+#include "csparsematrix.h"
+#include "complex_kernels.h"
+#include "gemm.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+template <class T> complex_sparse_matrix<T>::complex_sparse_matrix(size_t m, size_t n)
+	: m_rows(m), m_cols(n), m_rowStart(m + 1, 0)
+{
+}
+
+template <class T> T complex_sparse_matrix<T>::Get(size_t row, size_t col) const
+{
+	if (row >= m_rows || col >= m_cols)
+		throw std::out_of_range("Matrix index out of range");
+
+	auto begin = m_colIndex.begin() + m_rowStart[row], end = m_colIndex.begin() + m_rowStart[row + 1];
+	auto position = std::lower_bound(begin, end, col); // the columns of a row are sorted
+
+	if (position == end || *position != col)
+		return T();
+
+	return m_values[position - m_colIndex.begin()];
+}
+
+template <class T> void complex_sparse_matrix<T>::FromMatrix(const complex_matrix<T> & matrix)
+{
+	m_rows = matrix.Rows();
+	m_cols = m_rows == 0 ? 0 : matrix.Cols();
+
+	m_rowStart.assign(1, 0);
+	m_rowStart.reserve(m_rows + 1);
+	m_colIndex.clear();
+	m_values.clear();
+
+	for (const auto & row : matrix)
+	{
+		if (row.size() != m_cols)
+			throw std::out_of_range("All rows of the matrix must have the same size");
+
+		for (size_t j = 0; j < m_cols; j++)
+		{
+			if (!row[j].IsZero())
+			{
+				m_colIndex.push_back(j);
+				m_values.push_back(row[j]);
+			}
+		}
+
+		m_rowStart.push_back(m_values.size());
+	}
+}
+
+template <class T> void complex_sparse_matrix<T>::FromTriplets(size_t m, size_t n, const std::vector<Triplet> & triplets)
+{
+	std::vector<Triplet> sorted(triplets);
+
+	for (const auto & triplet : sorted)
+		if (triplet.m_row >= m || triplet.m_col >= n)
+			throw std::out_of_range("Matrix index out of range");
+
+	std::stable_sort(sorted.begin(), sorted.end(), [](const Triplet & a, const Triplet & b)
+	{
+		return a.m_row < b.m_row || (a.m_row == b.m_row && a.m_col < b.m_col);
+	});
+
+	m_rows = m;
+	m_cols = n;
+
+	m_rowStart.assign(m + 1, 0);
+	m_colIndex.clear();
+	m_values.clear();
+	m_colIndex.reserve(sorted.size());
+	m_values.reserve(sorted.size());
+
+	size_t count = sorted.size();
+
+	for (size_t i = 0; i < count; )
+	{ // sum up the duplicates, zeros are not stored
+		const size_t row = sorted[i].m_row, col = sorted[i].m_col;
+
+		T sum;
+		for (; i < count && sorted[i].m_row == row && sorted[i].m_col == col; i++)
+			sum += sorted[i].m_value;
+
+		if (!sum.IsZero())
+		{
+			m_colIndex.push_back(col);
+			m_values.push_back(sum);
+			m_rowStart[row + 1]++;
+		}
+	}
+
+	for (size_t i = 0; i < m; i++) // counts to offsets
+		m_rowStart[i + 1] += m_rowStart[i];
+}
+
+template <class T> complex_matrix<T> complex_sparse_matrix<T>::ToMatrix() const
+{
+	complex_matrix<T> result(m_rows, m_cols);
+
+	for (size_t i = 0; i < m_rows; i++)
+		for (size_t k = m_rowStart[i]; k < m_rowStart[i + 1]; k++)
+			result[i][m_colIndex[k]] = m_values[k];
+
+	return result;
+}
+
+template <class T> bool complex_sparse_matrix<T>::Equals(const complex_sparse_matrix & other) const
+{ // zeros are never stored, so equal matrixes have the same representation
+	return m_rows == other.m_rows && m_cols == other.m_cols && m_rowStart == other.m_rowStart && m_colIndex == other.m_colIndex && m_values == other.m_values;
+}
+
+template <class T> complex_sparse_matrix<T> complex_sparse_matrix<T>::Multiply(const T & scalar) const
+{
+	if (scalar.IsZero())
+		return complex_sparse_matrix<T>(m_rows, m_cols);
+
+	complex_sparse_matrix<T> result(*this);
+	ComplexKernels::Scale(scalar, m_values.data(), result.m_values.data(), m_values.size());
+
+	return result;
+}
+
+template <class T> complex_vector<T> complex_sparse_matrix<T>::Multiply(const complex_vector<T> & other) const
+{
+	complex_vector<T> result;
+	Multiply(other, result);
+
+	return result;
+}
+
+template <class T> void complex_sparse_matrix<T>::Multiply(const complex_vector<T> & other, complex_vector<T> & result) const
+{
+	if (other.size() != m_cols)
+		throw std::out_of_range("Incompatible matrix and vector sizes for multiplication");
+
+	if (&result == &other) // the input is still needed while the result is written
+	{
+		complex_vector<T> temp;
+		Multiply(other, temp);
+		result.swap(temp);
+		return;
+	}
+
+	result.resize(m_rows);
+
+	const size_t averageRowLength = m_rows == 0 ? 1 : std::max<size_t>(1, NonZeros() / m_rows);
+
+	Parallel::For(0, m_rows, Gemm::MinRowsPerThread(averageRowLength), [&](size_t rowBegin, size_t rowEnd)
+	{
+		const T * x = other.data();
+
+		for (size_t i = rowBegin; i < rowEnd; i++)
+		{
+			T sum;
+			for (size_t k = m_rowStart[i]; k < m_rowStart[i + 1]; k++)
+				sum += m_values[k] * x[m_colIndex[k]];
+
+			result[i] = sum;
+		}
+	});
+}
+
+template <class T> complex_matrix<T> complex_sparse_matrix<T>::Multiply(const complex_matrix<T> & other) const
+{ // row i of the result is a combination of the rows of other selected by the non-zeros of row i
+	if (other.Rows() != m_cols)
+		throw std::out_of_range("Incompatible matrix sizes for multiplication");
+
+	const size_t p = m_cols == 0 ? 0 : other.Cols();
+
+	for (const auto & row : other)
+		if (row.size() != p)
+			throw std::out_of_range("All rows of the matrix must have the same size");
+
+	complex_matrix<T> result(m_rows, p);
+
+	const size_t averageRowLength = m_rows == 0 ? 1 : std::max<size_t>(1, NonZeros() / m_rows);
+
+	Parallel::For(0, m_rows, Gemm::MinRowsPerThread(averageRowLength * p), [&](size_t rowBegin, size_t rowEnd)
+	{
+		for (size_t i = rowBegin; i < rowEnd; i++)
+			for (size_t k = m_rowStart[i]; k < m_rowStart[i + 1]; k++)
+				ComplexKernels::Axpy(m_values[k], other[m_colIndex[k]].data(), result[i].data(), p);
+	});
+
+	return result;
+}
+
+template <class T> complex_sparse_matrix<T> complex_sparse_matrix<T>::Multiply(const complex_sparse_matrix<T> & other) const
+{ // row by row, the products are gathered in a dense row and the touched columns are collected in sorted order
+	if (other.m_rows != m_cols)
+		throw std::out_of_range("Incompatible matrix sizes for multiplication");
+
+	const size_t p = other.m_cols;
+	complex_sparse_matrix<T> result(m_rows, p);
+
+	std::vector<T> row(p);
+	std::vector<bool> used(p, false);
+	std::vector<size_t> columns;
+
+	const T zero;
+
+	for (size_t i = 0; i < m_rows; i++)
+	{
+		columns.clear();
+
+		for (size_t k = m_rowStart[i]; k < m_rowStart[i + 1]; k++)
+		{
+			const T a = m_values[k];
+			const size_t r = m_colIndex[k];
+
+			for (size_t l = other.m_rowStart[r]; l < other.m_rowStart[r + 1]; l++)
+			{
+				const size_t col = other.m_colIndex[l];
+
+				if (!used[col])
+				{
+					used[col] = true;
+					columns.push_back(col);
+				}
+
+				row[col] += a * other.m_values[l];
+			}
+		}
+
+		std::sort(columns.begin(), columns.end());
+
+		for (size_t col : columns)
+		{
+			if (!row[col].IsZero())
+			{
+				result.m_colIndex.push_back(col);
+				result.m_values.push_back(row[col]);
+			}
+
+			row[col] = zero;
+			used[col] = false;
+		}
+
+		result.m_rowStart[i + 1] = result.m_values.size();
+	}
+
+	return result;
+}
+
+template <class T> complex_sparse_matrix<T> complex_sparse_matrix<T>::Transpose() const
+{ // counting sort by column, which keeps the new rows sorted as well
+	complex_sparse_matrix<T> result(m_cols, m_rows);
+
+	size_t count = NonZeros();
+	result.m_colIndex.resize(count);
+	result.m_values.resize(count);
+
+	for (size_t k = 0; k < count; k++)
+		result.m_rowStart[m_colIndex[k] + 1]++;
+
+	for (size_t j = 0; j < m_cols; j++)
+		result.m_rowStart[j + 1] += result.m_rowStart[j];
+
+	std::vector<size_t> next(result.m_rowStart.begin(), result.m_rowStart.end() - 1);
+
+	for (size_t i = 0; i < m_rows; i++)
+	{
+		for (size_t k = m_rowStart[i]; k < m_rowStart[i + 1]; k++)
+		{
+			size_t position = next[m_colIndex[k]]++;
+
+			result.m_colIndex[position] = i;
+			result.m_values[position] = m_values[k];
+		}
+	}
+
+	return result;
+}
+
+template <class T> complex_sparse_matrix<T> complex_sparse_matrix<T>::Adjoint() const
+{
+	complex_sparse_matrix<T> result = Transpose();
+
+	for (auto & value : result.m_values)
+		value = value.Conjugate();
+
+	return result;
+}
+
+template <class T> complex_sparse_matrix<T> complex_sparse_matrix<T>::TensorProduct(const complex_sparse_matrix<T> & other) const
+{ // row (i, r) of the result holds the products of the non-zeros of row i with those of row r of other;
+  // going through both in order keeps the columns (j * other.Cols() + c) sorted
+	const size_t p = other.m_rows, q = other.m_cols;
+
+	complex_sparse_matrix<T> result(m_rows * p, m_cols * q);
+
+	size_t count = NonZeros() * other.NonZeros();
+	result.m_colIndex.reserve(count);
+	result.m_values.reserve(count);
+
+	size_t row = 0;
+
+	for (size_t i = 0; i < m_rows; i++)
+	{
+		for (size_t r = 0; r < p; r++, row++)
+		{
+			for (size_t k = m_rowStart[i]; k < m_rowStart[i + 1]; k++)
+			{
+				const size_t colOffset = m_colIndex[k] * q;
+				const T a = m_values[k];
+
+				for (size_t l = other.m_rowStart[r]; l < other.m_rowStart[r + 1]; l++)
+				{
+					result.m_colIndex.push_back(colOffset + other.m_colIndex[l]);
+					result.m_values.push_back(a * other.m_values[l]);
+				}
+			}
+
+			result.m_rowStart[row + 1] = result.m_values.size();
+		}
+	}
+
+	return result;
+}
+
+template <class T> complex_sparse_matrix<T> complex_sparse_matrix<T>::CreateIdentityMatrix(size_t size)
+{
+	complex_sparse_matrix<T> result(size, size);
+
+	result.m_colIndex.resize(size);
+	result.m_values.assign(size, T(1));
+
+	for (size_t i = 0; i < size; i++)
+	{
+		result.m_colIndex[i] = i;
+		result.m_rowStart[i + 1] = i + 1;
+	}
+
+	return result;
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		cint_sparse_matrix si(1, 1);
+		cdouble_sparse_matrix sd(1, 1);
+
+		si.Get(0, 0);
+		sd.Get(0, 0);
+
+		si.FromMatrix(cint_matrix());
+		sd.FromMatrix(cdouble_matrix());
+		si.FromTriplets(0, 0, {});
+		sd.FromTriplets(0, 0, {});
+		si.ToMatrix();
+		sd.ToMatrix();
+
+		si.Equals(si);
+		sd.Equals(sd);
+
+		si.Multiply(cint());
+		sd.Multiply(cdouble());
+		si.Multiply(cint_vector());
+		sd.Multiply(cdouble_vector());
+		si.Multiply(cint_matrix());
+		sd.Multiply(cdouble_matrix());
+		si.Multiply(si);
+		sd.Multiply(sd);
+
+		si.Transpose();
+		sd.Transpose();
+		si.Adjoint();
+		sd.Adjoint();
+
+		si.TensorProduct(si);
+		sd.TensorProduct(sd);
+
+		cint_sparse_matrix::CreateIdentityMatrix(0);
+		cdouble_sparse_matrix::CreateIdentityMatrix(0);
+	}
+}
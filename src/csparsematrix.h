@@ -0,0 +1,74 @@
+#pragma once
+
+#include "cmatrix.h"
+
+// Matrix in compressed sparse row (CSR) format: only the non-zero elements are stored, row after row, together
+// with their column indexes. Gates, identity padded operators and oracles are mostly zeros, so multiplying
+// with them costs O(number of non-zeros) instead of O(rows * cols).
+template <class T> class complex_sparse_matrix
+{
+public:
+	struct Triplet
+	{
+		size_t m_row;
+		size_t m_col;
+		T m_value;
+	};
+
+	complex_sparse_matrix() = default;
+	complex_sparse_matrix(size_t m, size_t n); // all zeros
+	complex_sparse_matrix(const complex_matrix<T> & matrix) { FromMatrix(matrix); }
+
+	size_t Rows() const { return m_rows; }
+	size_t Cols() const { return m_cols; }
+	size_t NonZeros() const { return m_values.size(); }
+
+	T Get(size_t row, size_t col) const; // zero if the element is not stored
+
+	void FromMatrix(const complex_matrix<T> & matrix);
+	void FromTriplets(size_t m, size_t n, const std::vector<Triplet> & triplets); // duplicates are summed
+	complex_matrix<T> ToMatrix() const;
+
+	bool Equals(const complex_sparse_matrix & other) const;
+	bool operator == (const complex_sparse_matrix & other) const { return Equals(other); }
+	bool operator != (const complex_sparse_matrix & other) const { return !Equals(other); }
+
+	complex_sparse_matrix Multiply(const T & scalar) const;
+	complex_sparse_matrix operator * (const T & scalar) const { return Multiply(scalar); }
+
+	complex_vector<T> Multiply(const complex_vector<T> & other) const;
+	void Multiply(const complex_vector<T> & other, complex_vector<T> & result) const; // result is resized as needed, so it can be reused between calls
+	complex_vector<T> operator * (const complex_vector<T> & other) const { return Multiply(other); }
+
+	complex_matrix<T> Multiply(const complex_matrix<T> & other) const;
+	complex_matrix<T> operator * (const complex_matrix<T> & other) const { return Multiply(other); }
+
+	complex_sparse_matrix Multiply(const complex_sparse_matrix & other) const;
+	complex_sparse_matrix operator * (const complex_sparse_matrix & other) const { return Multiply(other); }
+
+	complex_sparse_matrix Transpose() const;
+	complex_sparse_matrix Adjoint() const;
+	complex_sparse_matrix Dagger() const { return Adjoint(); } // alias
+
+	complex_sparse_matrix TensorProduct(const complex_sparse_matrix & other) const;
+
+	static complex_sparse_matrix CreateIdentityMatrix(size_t size);
+
+protected:
+	size_t m_rows = 0;
+	size_t m_cols = 0;
+
+	std::vector<size_t> m_rowStart = { 0 }; // Rows() + 1 entries, row i is stored in [m_rowStart[i], m_rowStart[i + 1])
+	std::vector<size_t> m_colIndex;
+	std::vector<T> m_values;
+};
+
+
+template <typename T> complex_sparse_matrix<T> operator * (const T & scalar, const complex_sparse_matrix<T> & matrix)
+{
+	return matrix * scalar;
+}
+
+
+typedef complex_sparse_matrix<cint> cint_sparse_matrix;
+typedef complex_sparse_matrix<cdouble> cdouble_sparse_matrix;
@@ -1,14 +1,16 @@
 #include "cvector.h"
+#include "complex_kernels.h"
+#include "parallel.h"
 
 template <class T> complex_vector<T>::complex_vector(size_t size, T initValue /*= T()*/)
+	: std::vector<T>(size, initValue)
 {
-	for (size_t i = 0; i < size; i++)
-		this->push_back(initValue);
 }
 
 template <class T> void complex_vector<T>::FromStringList(const std::vector<std::string> & list)
 {
 	this->clear();
+	this->reserve(list.size());
 
 	for (const auto & str : list)
 		this->push_back(T(str));
@@ -17,6 +19,7 @@ template <class T> void complex_vector<T>::FromStringList(const std::vector<std:
 template <class T> std::vector<std::string> complex_vector<T>::ToStringList() const
 {
 	std::vector<std::string> result;
+	result.reserve(this->size());
 
 	for (auto & value : *this)
 		result.push_back(value.ToString());
@@ -26,10 +29,7 @@ template <class T> std::vector<std::string> complex_vector<T>::ToStringList() co
 
 template <class T> void complex_vector<T>::FromValueList(const std::vector<T> & list)
 {
-	this->clear();
-
-	for (const auto & value : list)
-		this->push_back(value);
+	this->assign(list.begin(), list.end());
 }
 
 template <class T> bool complex_vector<T>::NearEquals(const complex_vector<T> & other, double epsilon) const
@@ -54,61 +54,126 @@ template <class T> bool complex_vector<T>::NearEquals(const complex_vector<T> &
 	return result;
 }
 
-template <class T> complex_vector<T> complex_vector<T>::Add(const complex_vector & other) const
+template <class T> complex_vector<T> complex_vector<T>::Add(const complex_vector & other) const &
 {
-	return AddOrSubtract(other, &T::Add);
+	size_t n = this->size();
+
+	if (n != other.size())
+		throw std::out_of_range("Cannot add or subtract vectors of different sizes");
+
+	complex_vector<T> result(n);
+	ComplexKernels::Add(this->data(), other.data(), result.data(), n);
+
+	return result;
 }
 
-template <class T> complex_vector<T> complex_vector<T>::Subtract(const complex_vector & other) const
+template <class T> complex_vector<T> & complex_vector<T>::AddTo(const complex_vector & other)
 {
-	return AddOrSubtract(other, &T::Subtract);
+	size_t n = this->size();
+
+	if (n != other.size())
+		throw std::out_of_range("Cannot add or subtract vectors of different sizes");
+
+	ComplexKernels::Add(this->data(), other.data(), this->data(), n);
+
+	return *this;
 }
 
-template <class T> complex_vector<T> complex_vector<T>::AddOrSubtract(const complex_vector & other, T(T::*fnPtr)(const T &) const) const
+template <class T> complex_vector<T> complex_vector<T>::Subtract(const complex_vector & other) const &
 {
 	size_t n = this->size();
 
 	if (n != other.size())
 		throw std::out_of_range("Cannot add or subtract vectors of different sizes");
 
-	complex_vector<T> result;
-
-	for (size_t i = 0; i < n; i++)
-		result.push_back(((*this)[i].*fnPtr)(other[i]));
+	complex_vector<T> result(n);
+	ComplexKernels::Subtract(this->data(), other.data(), result.data(), n);
 
 	return result;
 }
 
-template <class T> complex_vector<T> complex_vector<T>::Conjugate() const
+template <class T> complex_vector<T> & complex_vector<T>::SubtractFrom(const complex_vector & other)
 {
-	complex_vector<T> result;
+	size_t n = this->size();
 
-	for (const auto & value : *this)
-		result.push_back(value.Conjugate());
+	if (n != other.size())
+		throw std::out_of_range("Cannot add or subtract vectors of different sizes");
+
+	ComplexKernels::Subtract(this->data(), other.data(), this->data(), n);
+
+	return *this;
+}
+
+template <class T> complex_vector<T> & complex_vector<T>::AddScaled(const T & scalar, const complex_vector & other)
+{
+	size_t n = this->size();
+
+	if (n != other.size())
+		throw std::out_of_range("Cannot add or subtract vectors of different sizes");
+
+	ComplexKernels::Axpy(scalar, other.data(), this->data(), n);
+
+	return *this;
+}
+
+template <class T> complex_vector<T> complex_vector<T>::Conjugate() const &
+{
+	size_t n = this->size();
+	complex_vector<T> result(n);
+
+	for (size_t i = 0; i < n; i++)
+		result[i] = (*this)[i].Conjugate();
 
 	return result;
 }
 
-template <class T> complex_vector<T> complex_vector<T>::Inverse() const
+template <class T> complex_vector<T> & complex_vector<T>::ConjugateInPlace()
 {
-	complex_vector<T> result;
+	for (auto & value : *this)
+		value = value.Conjugate();
 
-	for (const auto & value : *this)
-		result.push_back(-value);
+	return *this;
+}
+
+template <class T> complex_vector<T> complex_vector<T>::Inverse() const &
+{
+	size_t n = this->size();
+	complex_vector<T> result(n);
+
+	for (size_t i = 0; i < n; i++)
+		result[i] = -(*this)[i];
 
 	return result;
 }
 
-template <class T> complex_vector<T> complex_vector<T>::Multiply(const T & scalar) const
+template <class T> complex_vector<T> & complex_vector<T>::InverseInPlace()
 {
-	complex_vector<T> result;
+	for (auto & value : *this)
+		value = -value;
 
-	for (const auto & value : *this)
-		result.push_back(value * scalar);
+	return *this;
+}
+
+template <class T> complex_vector<T> complex_vector<T>::Multiply(const T & scalar) const &
+{
+	complex_vector<T> result(this->size());
+	ComplexKernels::Scale(scalar, this->data(), result.data(), this->size());
 
 	return result;
 }
 
+template <class T> complex_vector<T> & complex_vector<T>::MultiplyWith(const T & scalar)
+{ // the scaling of NormalizeInPlace, worth splitting across threads for large state vectors
+	T * data = this->data();
+
+	Parallel::For(0, this->size(), Parallel::MIN_ELEMENTS_PER_THREAD, [&](size_t begin, size_t end)
+	{
+		ComplexKernels::Scale(scalar, data + begin, data + begin, end - begin);
+	});
+
+	return *this;
+}
+
 template <class T> T complex_vector<T>::InnerProduct(const complex_vector<T> & other) const
 {
 	size_t n = this->size();
@@ -116,12 +181,13 @@ template <class T> T complex_vector<T>::InnerProduct(const complex_vector<T> & o
 	if (n != other.size())
 		throw std::out_of_range("Cannot compute inner product of vectors of different sizes");
 
-	T result;
+	const T * a = this->data();
+	const T * b = other.data();
 
-	for (size_t i = 0; i < n; i++)
-		result += (*this)[i].Conjugate() * other[i];
-
-	return result;
+	return Parallel::Reduce(size_t(0), n, Parallel::MIN_ELEMENTS_PER_THREAD, T(), [&](size_t begin, size_t end)
+	{
+		return ComplexKernels::Dot(a + begin, b + begin, end - begin);
+	}, [](const T & x, const T & y) { return x + y; });
 }
 
 template <class T> complex_vector<T> complex_vector<T>::TensorProduct(const complex_vector<T> & other) const
@@ -144,21 +210,32 @@ template <class T> T complex_vector<T>::Norm() const
 
 template <class T> T complex_vector<T>::NormSquare() const
 {
-	return T::FromReal(InnerProduct(*this).Real());
+	const T * data = this->data();
+
+	return T::FromReal(Parallel::Reduce(size_t(0), this->size(), Parallel::MIN_ELEMENTS_PER_THREAD, 0.0, [&](size_t begin, size_t end)
+	{
+		return ComplexKernels::SumModulusSquared(data + begin, end - begin);
+	}, [](double x, double y) { return x + y; }));
 }
 
-template <class T> complex_vector<T> complex_vector<T>::Normalize() const
-{
-	size_t n = this->size();
+template <> cint_vector & complex_vector<cint>::NormalizeInPlace()
+{ // integer division, as there is no reciprocal of the length to multiply with
+	const cint length = Lenght();
 
-	complex_vector<T> result(n);
+	for (auto & value : *this)
+		value /= length;
 
-	T length = this->Lenght();
+	return *this;
+}
 
-	for (size_t i = 0; i < n; i++)
-		result[i] = (*this)[i] / length;
+template <> cfloat_vector & complex_vector<cfloat>::NormalizeInPlace()
+{ // the norm is accumulated in double, see ComplexKernels
+	return MultiplyWith(cfloat(static_cast<float>(1.0 / sqrt(static_cast<double>(NormSquare().Real())))));
+}
 
-	return result;
+template <> cdouble_vector & complex_vector<cdouble>::NormalizeInPlace()
+{ // the length is real, so one division and a scaling replace a complex division per element
+	return MultiplyWith(cdouble(1.0 / Lenght().Real()));
 }
 
 template <class T> T complex_vector<T>::Distance(const complex_vector & other) const
@@ -189,57 +266,96 @@ namespace
 	{
 		cint_vector vi;
 		cdouble_vector vd;
+		cfloat_vector vf;
 
 		vi.FromStringList({});
 		vd.FromStringList({});
+		vf.FromStringList({});
 		vi.ToStringList();
 		vd.ToStringList();
+		vf.ToStringList();
 
 		cint_vector({ 1 });
 		cdouble_vector({ 1 });
+		cfloat_vector({ 1 });
 
 		vi.FromValueList({});
 		vd.FromValueList({});
+		vf.FromValueList({});
 
 		vi.NearEquals(vi, 0);
 		vd.NearEquals(vd, 0);
+		vf.NearEquals(vf, 0);
 
 		vi.Add(cint_vector());
 		vd.Add(cdouble_vector());
+		vf.Add(cfloat_vector());
 		vi.Subtract(cint_vector());
 		vd.Subtract(cdouble_vector());
+		vf.Subtract(cfloat_vector());
+
+		vi.AddTo(cint_vector());
+		vd.AddTo(cdouble_vector());
+		vf.AddTo(cfloat_vector());
+		vi.SubtractFrom(cint_vector());
+		vd.SubtractFrom(cdouble_vector());
+		vf.SubtractFrom(cfloat_vector());
+		vi.AddScaled(cint(), cint_vector());
+		vd.AddScaled(cdouble(), cdouble_vector());
+		vf.AddScaled(cfloat(), cfloat_vector());
 
 		vi.Conjugate();
 		vd.Conjugate();
+		vf.Conjugate();
+		vi.ConjugateInPlace();
+		vd.ConjugateInPlace();
+		vf.ConjugateInPlace();
 
 		vi.Inverse();
 		vd.Inverse();
+		vf.Inverse();
+		vi.InverseInPlace();
+		vd.InverseInPlace();
+		vf.InverseInPlace();
 
 		vi.Multiply({});
 		vd.Multiply({});
+		vf.Multiply({});
+		vi.MultiplyWith({});
+		vd.MultiplyWith({});
+		vf.MultiplyWith({});
 
 		vi.InnerProduct(vi);
 		vd.InnerProduct(vd);
+		vf.InnerProduct(vf);
 
 		vi.TensorProduct(vi);
 		vd.TensorProduct(vd);
+		vf.TensorProduct(vf);
 
 		vi.Norm();
 		vd.Norm();
+		vf.Norm();
 		vi.NormSquare();
 		vd.NormSquare();
-		vi.Normalize();
-		vd.Normalize();
+		vf.NormSquare();
+		vi.NormalizeInPlace();
+		vd.NormalizeInPlace();
+		vf.NormalizeInPlace();
 
 		vi.Distance(vi);
 		vd.Distance(vd);
+		vf.Distance(vf);
 		vi.Sum();
 		vd.Sum();
+		vf.Sum();
 
 		cint_vector viInit(0);
 		cdouble_vector vdInit(0);
+		cfloat_vector vfInit(0);
 
 		vi.CreateZeroVector(0);
 		vd.CreateZeroVector(0);
+		vf.CreateZeroVector(0);
 	}
 }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <utility>
 #include <vector>
 #include "complex.h"
 
+namespace ComplexExpression { template <class E> class vector_expression; } // see cexpression.h
+
 template <class T> class complex_vector : public std::vector<T>
 {
 public:
@@ -10,6 +13,12 @@ public:
 	complex_vector(const std::vector<std::string> & list) { FromStringList(list); }
 	complex_vector(const std::vector<T> & list) { FromValueList(list); }
 	complex_vector(size_t size, T initValue=T());
+	template <class U> explicit complex_vector(const complex_vector<U> & other) : std::vector<T>(other.begin(), other.end()) {} // between precisions
+
+	// evaluation of lazy expressions, these are defined in cexpression.h
+	template <class E> complex_vector(const ComplexExpression::vector_expression<E> & expression) { Assign(expression); }
+	template <class E> complex_vector & operator = (const ComplexExpression::vector_expression<E> & expression) { return Assign(expression); }
+	template <class E> complex_vector & Assign(const ComplexExpression::vector_expression<E> & expression);
 
 	void FromStringList(const std::vector<std::string> & list);
 	std::vector<std::string> ToStringList() const;
@@ -18,19 +27,40 @@ public:
 
 	bool NearEquals(const complex_vector & other, double epsilon) const;
 
-	complex_vector Add(const complex_vector & other) const;
-	complex_vector operator + (const complex_vector & other) const { return Add(other); }
-	complex_vector Subtract(const complex_vector & other) const;
-	complex_vector operator - (const complex_vector & other) const { return Subtract(other); }
-
-	complex_vector Conjugate() const;
-
-	complex_vector Inverse() const;
-	complex_vector operator - () const { return Inverse(); }
-
-	complex_vector Multiply(const T & scalar) const;
-	complex_vector operator * (const T & scalar) const { return Multiply(scalar); }
-	complex_vector operator *= (const T & scalar) { *this = Multiply(scalar); return *this; }
+	// the && overloads work on a temporary's own buffer instead of allocating a new one
+
+	complex_vector Add(const complex_vector & other) const &;
+	complex_vector Add(const complex_vector & other) && { return std::move(AddTo(other)); }
+	complex_vector operator + (const complex_vector & other) const & { return Add(other); }
+	complex_vector operator + (const complex_vector & other) && { return std::move(AddTo(other)); }
+	complex_vector & AddTo(const complex_vector & other);
+	complex_vector & operator += (const complex_vector & other) { return AddTo(other); }
+
+	complex_vector Subtract(const complex_vector & other) const &;
+	complex_vector Subtract(const complex_vector & other) && { return std::move(SubtractFrom(other)); }
+	complex_vector operator - (const complex_vector & other) const & { return Subtract(other); }
+	complex_vector operator - (const complex_vector & other) && { return std::move(SubtractFrom(other)); }
+	complex_vector & SubtractFrom(const complex_vector & other);
+	complex_vector & operator -= (const complex_vector & other) { return SubtractFrom(other); }
+
+	complex_vector & AddScaled(const T & scalar, const complex_vector & other); // this += scalar * other, without a temporary
+
+	complex_vector Conjugate() const &;
+	complex_vector Conjugate() && { return std::move(ConjugateInPlace()); }
+	complex_vector & ConjugateInPlace();
+
+	complex_vector Inverse() const &;
+	complex_vector Inverse() && { return std::move(InverseInPlace()); }
+	complex_vector operator - () const & { return Inverse(); }
+	complex_vector operator - () && { return std::move(InverseInPlace()); }
+	complex_vector & InverseInPlace();
+
+	complex_vector Multiply(const T & scalar) const &;
+	complex_vector Multiply(const T & scalar) && { return std::move(MultiplyWith(scalar)); }
+	complex_vector operator * (const T & scalar) const & { return Multiply(scalar); }
+	complex_vector operator * (const T & scalar) && { return std::move(MultiplyWith(scalar)); }
+	complex_vector & MultiplyWith(const T & scalar);
+	complex_vector & operator *= (const T & scalar) { return MultiplyWith(scalar); }
 
 	T InnerProduct(const complex_vector & other) const;
 	T operator * (const complex_vector & other) const { return InnerProduct(other); }
@@ -42,16 +72,15 @@ public:
 	T NormSquare() const;
 	T LengthSquare() const { return NormSquare(); } // alias
 
-	complex_vector Normalize() const;
+	complex_vector Normalize() const & { return complex_vector(*this).NormalizeInPlace(); }
+	complex_vector Normalize() && { return std::move(NormalizeInPlace()); }
+	complex_vector & NormalizeInPlace();
 
 	T Distance(const complex_vector & other) const;
 
 	T Sum() const;
 
 	static complex_vector CreateZeroVector(size_t size);
-
-protected:
-	complex_vector AddOrSubtract(const complex_vector & other, T (T::*fnPtr)(const T &) const) const;
 };
 
 
@@ -60,7 +89,13 @@ template <typename T> complex_vector<T> operator * (const T & scalar, const comp
 	return vector * scalar;
 }
 
+template <typename T> complex_vector<T> operator * (const T & scalar, complex_vector<T> && vector)
+{
+	return std::move(vector.MultiplyWith(scalar));
+}
+
 
 typedef complex_vector<cint> cint_vector;
+typedef complex_vector<cfloat> cfloat_vector;
 typedef complex_vector<cdouble> cdouble_vector;
 
@@ -0,0 +1,339 @@
+#include "density_matrix.h"
+#include "complex_kernels.h"
+#include "parallel.h"
+#include "state_vector.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+	const size_t MIN_BLOCKS_PER_THREAD = 1 << 12; // every block costs 16 complex multiplications
+
+	size_t TriangleRow(size_t k) // the row a of the k-th element of a lower triangle stored row after row
+	{
+		size_t a = static_cast<size_t>((sqrt(8.0 * double(k) + 1) - 1) / 2);
+
+		while (a * (a + 1) / 2 > k) // the square root can be one off for large k
+			a--;
+		while ((a + 1) * (a + 2) / 2 <= k)
+			a++;
+
+		return a;
+	}
+
+	// calls body(a, b) for every 0 <= b <= a < count, split across threads by the number of pairs, not of rows
+	template <class F> void ForEachInTriangle(size_t count, size_t minChunk, F body)
+	{
+		Parallel::For(0, count * (count + 1) / 2, minChunk, [&](size_t begin, size_t end)
+		{
+			size_t a = TriangleRow(begin), b = begin - a * (a + 1) / 2;
+
+			for (size_t k = begin; k < end; k++)
+			{
+				body(a, b);
+
+				if (++b > a)
+				{
+					a++;
+					b = 0;
+				}
+			}
+		});
+	}
+
+	template <class T> void CheckOperator(const complex_matrix<T> & op)
+	{
+		if (op.Rows() != 2 || op[0].size() != 2 || op[1].size() != 2)
+			throw std::out_of_range("A single-qubit operator must be a 2x2 matrix");
+	}
+
+	template <class T> complex_matrix<T> Operator(T a, T b, T c, T d)
+	{
+		return complex_matrix<T>(std::vector<std::vector<T>>{ { a, b }, { c, d } });
+	}
+
+	void CheckProbability(double p)
+	{
+		if (!(p >= 0 && p <= 1))
+			throw std::out_of_range("The probability must be between 0 and 1");
+	}
+}
+
+template <class T> density_matrix<T>::density_matrix(size_t qubitCount)
+	: m_qubitCount(qubitCount)
+{
+	if (qubitCount >= 4 * sizeof(size_t) - 1)
+		throw std::out_of_range("Qubit count out of range");
+
+	m_elements.resize(Size() * (Size() + 1) / 2);
+	m_elements[0] = T(1);
+}
+
+template <class T> density_matrix<T>::density_matrix(const complex_vector<T> & state)
+	: m_qubitCount(StateVector::QubitCount(state))
+{
+	m_elements.resize(Size() * (Size() + 1) / 2);
+
+	T * elements = m_elements.data();
+	const T * amplitudes = state.data();
+
+	ForEachInTriangle(Size(), Parallel::MIN_ELEMENTS_PER_THREAD, [&](size_t i, size_t j)
+	{
+		elements[Index(i, j)] = amplitudes[i] * amplitudes[j].Conjugate();
+	});
+}
+
+template <class T> density_matrix<T>::density_matrix(const complex_matrix<T> & matrix)
+	: m_qubitCount(StateVector::QubitCount(matrix.empty() ? complex_vector<T>() : matrix[0]))
+{
+	if (matrix.Rows() != Size())
+		throw std::out_of_range("A density matrix must be square");
+
+	m_elements.resize(Size() * (Size() + 1) / 2);
+
+	for (size_t i = 0; i < Size(); i++)
+	{
+		if (matrix[i].size() != Size())
+			throw std::out_of_range("A density matrix must be square");
+
+		std::copy(matrix[i].begin(), matrix[i].begin() + i + 1, m_elements.begin() + Index(i, 0));
+	}
+}
+
+template <class T> complex_matrix<T> density_matrix<T>::ToMatrix() const
+{
+	complex_matrix<T> result(Size(), Size());
+
+	for (size_t i = 0; i < Size(); i++)
+		for (size_t j = 0; j <= i; j++)
+		{
+			result[i][j] = m_elements[Index(i, j)];
+			result[j][i] = m_elements[Index(i, j)].Conjugate();
+		}
+
+	return result;
+}
+
+template <class T> size_t density_matrix<T>::Stride(size_t qubit) const
+{
+	if (qubit >= m_qubitCount)
+		throw std::out_of_range("Qubit index out of range");
+
+	return StateVector::QubitStride(m_qubitCount, qubit);
+}
+
+template <class T> typename density_matrix<T>::superoperator density_matrix<T>::Superoperator(const std::vector<complex_matrix<T>> & rowOperators, const std::vector<complex_matrix<T>> & columnOperators)
+{ // B -> sum of R B C*, so b'[xy] = sum over k, u and v of R[x][u] b[uv] conj(C[y][v])
+	superoperator result;
+
+	for (size_t k = 0; k < rowOperators.size(); k++)
+	{
+		const complex_matrix<T> & r = rowOperators[k], & c = columnOperators[k];
+
+		CheckOperator(r);
+		CheckOperator(c);
+
+		for (size_t x = 0; x < 2; x++)
+			for (size_t y = 0; y < 2; y++)
+				for (size_t u = 0; u < 2; u++)
+					for (size_t v = 0; v < 2; v++)
+						result[4 * (2 * x + y) + 2 * u + v] += r[x][u] * c[y][v].Conjugate();
+	}
+
+	return result;
+}
+
+template <class T> void density_matrix<T>::ApplyBlocks(size_t qubit, size_t controlMask, const superoperator ops[4])
+{ // the block of row pair a and column pair b <= a; all its elements are in the lower triangle, or mirror one that is
+	const size_t stride = Stride(qubit);
+	T * elements = m_elements.data();
+
+	auto get = [&](size_t i, size_t j) { return i >= j ? elements[Index(i, j)] : elements[Index(j, i)].Conjugate(); };
+	auto set = [&](size_t i, size_t j, const T & value)
+	{
+		if (i >= j)
+			elements[Index(i, j)] = value;
+		else
+			elements[Index(j, i)] = value.Conjugate();
+	};
+
+	ForEachInTriangle(Size() / 2, MIN_BLOCKS_PER_THREAD, [&](size_t a, size_t b)
+	{
+		const size_t i0 = StateVector::PairIndex(a, stride), i1 = i0 + stride;
+		const size_t j0 = StateVector::PairIndex(b, stride), j1 = j0 + stride;
+
+		const superoperator & s = ops[2 * ((i0 & controlMask) == controlMask) + ((j0 & controlMask) == controlMask)];
+
+		const T x[4] = { get(i0, j0), get(i0, j1), get(i1, j0), get(i1, j1) };
+		T y[4];
+
+		for (size_t r = 0; r < 4; r++)
+			y[r] = s[4 * r] * x[0] + s[4 * r + 1] * x[1] + s[4 * r + 2] * x[2] + s[4 * r + 3] * x[3];
+
+		set(i0, j0, y[0]);
+		if (a != b) // on the diagonal, (i0, i1) is the mirror of (i1, i0)
+			set(i0, j1, y[1]);
+		set(i1, j0, y[2]);
+		set(i1, j1, y[3]);
+	});
+}
+
+template <class T> void density_matrix<T>::ApplyGate(const complex_matrix<T> & gate, size_t qubit)
+{
+	superoperator s = Superoperator({ gate }, { gate });
+	const superoperator ops[4] = { s, s, s, s };
+
+	ApplyBlocks(qubit, 0, ops);
+}
+
+template <class T> void density_matrix<T>::ApplyControlledGate(const complex_matrix<T> & gate, const std::vector<size_t> & controls, size_t target)
+{ // the rows (columns) whose controls are not all set see the identity instead of the gate
+	const size_t targetMask = Stride(target);
+	size_t controlMask = 0;
+
+	for (size_t control : controls)
+	{
+		size_t mask = Stride(control);
+
+		if (mask == targetMask || (controlMask & mask))
+			throw std::invalid_argument("The qubits of a gate must be different");
+
+		controlMask |= mask;
+	}
+
+	const complex_matrix<T> identity = Operator(T(1), T(0), T(0), T(1));
+	const superoperator ops[4] = { Superoperator({ identity }, { identity }), Superoperator({ identity }, { gate }), Superoperator({ gate }, { identity }), Superoperator({ gate }, { gate }) };
+
+	ApplyBlocks(target, controlMask, ops);
+}
+
+template <class T> void density_matrix<T>::ApplyChannel(const std::vector<complex_matrix<T>> & kraus, size_t qubit)
+{
+	superoperator s = Superoperator(kraus, kraus);
+	const superoperator ops[4] = { s, s, s, s };
+
+	ApplyBlocks(qubit, 0, ops);
+}
+
+template <class T> std::vector<complex_matrix<T>> density_matrix<T>::DepolarizingChannel(double p)
+{ // (1 - p) rho + p I / 2 = (1 - 3p/4) rho + p/4 (X rho X + Y rho Y + Z rho Z)
+	CheckProbability(p);
+
+	const T i = T::FromReal(sqrt(1 - 3 * p / 4)), c = T::FromReal(sqrt(p / 4)), zero;
+	const T ic = c * T(0, 1);
+
+	return { Operator(i, zero, zero, i), Operator(zero, c, c, zero), Operator(zero, -ic, ic, zero), Operator(c, zero, zero, -c) };
+}
+
+template <class T> std::vector<complex_matrix<T>> density_matrix<T>::AmplitudeDampingChannel(double gamma)
+{
+	CheckProbability(gamma);
+
+	const T one(1), zero;
+	return { Operator(one, zero, zero, T::FromReal(sqrt(1 - gamma))), Operator(zero, T::FromReal(sqrt(gamma)), zero, zero) };
+}
+
+template <class T> std::vector<complex_matrix<T>> density_matrix<T>::PhaseDampingChannel(double lambda)
+{
+	CheckProbability(lambda);
+
+	const T one(1), zero;
+	return { Operator(one, zero, zero, T::FromReal(sqrt(1 - lambda))), Operator(zero, zero, zero, T::FromReal(sqrt(lambda))) };
+}
+
+template <class T> double density_matrix<T>::Trace() const
+{
+	double result = 0;
+	for (size_t i = 0; i < Size(); i++)
+		result += double(m_elements[Index(i, i)].Real());
+
+	return result;
+}
+
+template <class T> double density_matrix<T>::Purity() const
+{ // Tr(rho^2) is the sum of all |rho_ij|^2, which counts every element below the diagonal twice
+	const T * elements = m_elements.data();
+
+	double all = Parallel::Reduce(size_t(0), m_elements.size(), Parallel::MIN_ELEMENTS_PER_THREAD, 0.0, [&](size_t begin, size_t end)
+	{
+		return ComplexKernels::SumModulusSquared(elements + begin, end - begin);
+	}, [](double x, double y) { return x + y; });
+
+	double diagonal = 0;
+	for (size_t i = 0; i < Size(); i++)
+		diagonal += double(m_elements[Index(i, i)].ModulusSquared());
+
+	return 2 * all - diagonal;
+}
+
+template <class T> std::vector<double> density_matrix<T>::MeasurementProbabilities() const
+{
+	std::vector<double> result(Size());
+
+	for (size_t i = 0; i < Size(); i++)
+		result[i] = double(m_elements[Index(i, i)].Real());
+
+	return result;
+}
+
+template <class T> double density_matrix<T>::Fidelity(const complex_vector<T> & state) const
+{ // the sum of conj(s_i) rho_ij s_j: the diagonal, and twice the real part of the lower triangle
+	if (state.size() != Size())
+		throw std::out_of_range("The state does not have the size of the density matrix");
+
+	const T * elements = m_elements.data();
+	const T * s = state.data();
+
+	return Parallel::Reduce(size_t(0), Size(), Parallel::MIN_ELEMENTS_PER_THREAD / Size() + 1, 0.0, [&](size_t begin, size_t end)
+	{
+		double sum = 0;
+
+		for (size_t i = begin; i < end; i++)
+		{
+			const T * row = elements + Index(i, 0);
+			cdouble below = cdouble(ComplexKernels::MultiplyAccumulate(row, s, i)); // sum over j < i of rho_ij s_j
+
+			sum += double(s[i].ModulusSquared()) * double(row[i].Real()) + 2 * (cdouble(s[i].Conjugate()) * below).Real();
+		}
+
+		return sum;
+	}, [](double x, double y) { return x + y; });
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		cdouble_density_matrix rd(1);
+		cdouble_density_matrix rdv((cdouble_vector()));
+		cdouble_density_matrix rdm((cdouble_matrix()));
+		rd.ToMatrix();
+		rd.ApplyGate(cdouble_matrix(), 0);
+		rd.ApplyControlledGate(cdouble_matrix(), {}, 0);
+		rd.ApplyChannel({}, 0);
+		cdouble_density_matrix::DepolarizingChannel(0);
+		cdouble_density_matrix::AmplitudeDampingChannel(0);
+		cdouble_density_matrix::PhaseDampingChannel(0);
+		rd.Trace();
+		rd.Purity();
+		rd.MeasurementProbabilities();
+		rd.Fidelity(cdouble_vector());
+
+		cfloat_density_matrix rf(1);
+		cfloat_density_matrix rfv((cfloat_vector()));
+		cfloat_density_matrix rfm((cfloat_matrix()));
+		rf.ToMatrix();
+		rf.ApplyGate(cfloat_matrix(), 0);
+		rf.ApplyControlledGate(cfloat_matrix(), {}, 0);
+		rf.ApplyChannel({}, 0);
+		cfloat_density_matrix::DepolarizingChannel(0);
+		cfloat_density_matrix::AmplitudeDampingChannel(0);
+		cfloat_density_matrix::PhaseDampingChannel(0);
+		rf.Trace();
+		rf.Purity();
+		rf.MeasurementProbabilities();
+		rf.Fidelity(cfloat_vector());
+	}
+}
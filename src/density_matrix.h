@@ -0,0 +1,67 @@
+#pragma once
+
+#include "cmatrix.h"
+
+#include <array>
+
+// Mixed states, for decoherence: the density matrix rho of an n-qubit register. Only the lower triangle is
+// stored, row after row, since rho is Hermitian: N (N + 1) / 2 elements for N = 2^n, about half of a
+// complex_matrix (14 qubits take 2 GB in cdouble).
+//
+// Everything that acts on one qubit (a gate U, rho -> U rho U*, or a channel with Kraus operators K,
+// rho -> sum of K rho K*) mixes the elements in 2x2 blocks: the rows i and i + stride with the columns j and
+// j + stride, with the stride of the qubit as in StateVector. Each block is updated with the 4x4 matrix of the
+// operation on the block, O(N^2) work in all instead of the O(N^3) of U rho U* as two matrix products. The
+// blocks are split evenly across Parallel's threads.
+template <class T>
+class density_matrix
+{
+public:
+	typedef std::array<T, 16> superoperator; // acts on a 2x2 block in row-major order: b'[xy] = sum of s[4 xy + uv] b[uv]
+
+	density_matrix() = default;
+	explicit density_matrix(size_t qubitCount); // |0...0><0...0|
+	explicit density_matrix(const complex_vector<T> & state); // |state><state|, a pure state
+	explicit density_matrix(const complex_matrix<T> & matrix); // takes the lower triangle of a Hermitian matrix
+
+	size_t QubitCount() const { return m_qubitCount; }
+	size_t Size() const { return size_t(1) << m_qubitCount; } // N, the number of rows and columns
+
+	T operator()(size_t row, size_t column) const { return row >= column ? m_elements[Index(row, column)] : m_elements[Index(column, row)].Conjugate(); }
+	const complex_vector<T> & Packed() const { return m_elements; } // the lower triangle, row after row
+
+	complex_matrix<T> ToMatrix() const;
+
+	void ApplyGate(const complex_matrix<T> & gate, size_t qubit); // gate is 2x2
+	void ApplyControlledGate(const complex_matrix<T> & gate, const std::vector<size_t> & controls, size_t target);
+	void ApplyChannel(const std::vector<complex_matrix<T>> & kraus, size_t qubit); // 2x2 operators with sum of K* K = I
+
+	// the Kraus operators of the usual noise channels, see Nielsen and Chuang, section 8.3
+	static std::vector<complex_matrix<T>> DepolarizingChannel(double p); // rho -> (1 - p) rho + p I / 2
+	static std::vector<complex_matrix<T>> AmplitudeDampingChannel(double gamma); // |1> decays to |0> with probability gamma
+	static std::vector<complex_matrix<T>> PhaseDampingChannel(double lambda); // the coherences shrink by sqrt(1 - lambda)
+
+	void ApplyDepolarizing(double p, size_t qubit) { ApplyChannel(DepolarizingChannel(p), qubit); }
+	void ApplyAmplitudeDamping(double gamma, size_t qubit) { ApplyChannel(AmplitudeDampingChannel(gamma), qubit); }
+	void ApplyPhaseDamping(double lambda, size_t qubit) { ApplyChannel(PhaseDampingChannel(lambda), qubit); }
+
+	double Trace() const; // 1 for a state
+	double Purity() const; // Tr(rho^2), 1 for a pure state, down to 1 / N
+	std::vector<double> MeasurementProbabilities() const; // the diagonal
+	double Fidelity(const complex_vector<T> & state) const; // <state| rho |state>
+
+protected:
+	static size_t Index(size_t row, size_t column) { return row * (row + 1) / 2 + column; } // column <= row
+
+	size_t Stride(size_t qubit) const;
+	static superoperator Superoperator(const std::vector<complex_matrix<T>> & rowOperators, const std::vector<complex_matrix<T>> & columnOperators);
+
+	// applies ops[2 r + c] to every block, where r and c tell if the controls are all set in its rows and columns
+	void ApplyBlocks(size_t qubit, size_t controlMask, const superoperator ops[4]);
+
+	complex_vector<T> m_elements;
+	size_t m_qubitCount = 0;
+};
+
+typedef density_matrix<cfloat> cfloat_density_matrix;
+typedef density_matrix<cdouble> cdouble_density_matrix;
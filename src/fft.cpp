@@ -0,0 +1,104 @@
+#include "fft.h"
+#include "parallel.h"
+#include "state_vector.h"
+
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+	const double PI = 3.14159265358979323846;
+
+	size_t ReverseBits(size_t value, size_t bits)
+	{
+		size_t result = 0;
+		for (size_t i = 0; i < bits; i++, value >>= 1)
+			result = (result << 1) | (value & 1);
+
+		return result;
+	}
+}
+
+std::shared_ptr<const std::vector<cdouble>> FFT::Twiddles(size_t size)
+{
+	static std::mutex mutex;
+	static std::weak_ptr<const std::vector<cdouble>> cache; // only the largest table, the smaller ones are subsamples of it
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::shared_ptr<const std::vector<cdouble>> twiddles = cache.lock(); // empty once the last transform let it go
+
+	if (!twiddles || 2 * twiddles->size() < size)
+	{
+		auto table = std::make_shared<std::vector<cdouble>>(size / 2);
+
+		for (size_t j = 0; j < size / 2; j++) // each one from the angle, so the errors do not add up
+		{
+			double angle = -2 * PI * double(j) / double(size);
+			(*table)[j] = cdouble(cos(angle), sin(angle));
+		}
+
+		twiddles = table;
+		cache = twiddles;
+	}
+
+	return twiddles;
+}
+
+void FFT::Transform(cdouble_vector & data, int sign, double scale /*= 1.0*/)
+{
+	const size_t n = data.size();
+	const size_t bits = StateVector::QubitCount(data); // throws if n is not a power of 2
+
+	cdouble * values = data.data();
+	const cdouble factor(scale);
+
+	// the bit-reversal permutation, with the scaling while the values pass through
+	Parallel::For(0, n, Parallel::MIN_ELEMENTS_PER_THREAD, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			size_t j = ReverseBits(i, bits);
+
+			if (i < j)
+			{
+				cdouble x = values[i];
+				values[i] = values[j] * factor;
+				values[j] = x * factor;
+			}
+			else if (i == j)
+				values[i] *= factor;
+		}
+	});
+
+	if (n < 2)
+		return;
+
+	auto table = Twiddles(n);
+	const cdouble * twiddles = table->data();
+	const size_t tableStride = 2 * table->size() / n; // the table can be for a larger size
+	const bool conjugate = sign > 0;
+
+	for (size_t half = 1; half < n; half *= 2)
+	{ // butterflies between the two halves of every block of 2 * half elements; pair p has the twiddle of p % half
+		const size_t twiddleStride = tableStride * n / (2 * half);
+
+		Parallel::For(0, n / 2, StateVector::MIN_PAIRS_PER_THREAD, [&](size_t pairBegin, size_t pairEnd)
+		{
+			for (size_t pair = pairBegin; pair < pairEnd; pair++)
+			{
+				size_t i = StateVector::PairIndex(pair, half);
+				cdouble w = twiddles[(pair & (half - 1)) * twiddleStride];
+
+				if (conjugate)
+					w = w.Conjugate();
+
+				const cdouble a = values[i], b = values[i + half] * w;
+
+				values[i] = a + b;
+				values[i + half] = a - b;
+			}
+		}, StateVector::CHUNK_GRANULARITY);
+	}
+}
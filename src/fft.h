@@ -0,0 +1,21 @@
+#pragma once
+
+#include "cvector.h"
+
+#include <memory>
+
+// In-place fast Fourier transform of 2^k elements: iterative radix-2, a bit-reversal permutation followed by k
+// passes of butterflies, O(N log N). The butterflies of a pass are numbered like the amplitude pairs of a
+// single-qubit gate (see StateVector::PairIndex), so every pass is split across threads the same way.
+namespace FFT
+{
+	const int FORWARD = -1; // the sign of the exponent, as in the usual definition of the DFT
+	const int BACKWARD = 1;
+
+	// data[k] = scale * sum over j of data[j] * exp(sign * 2 pi i j k / N); throws unless N is a power of 2
+	void Transform(cdouble_vector & data, int sign, double scale = 1.0);
+
+	// exp(-2 pi i j / N) for j < N / 2, where N is the largest size still in use and at least size. Only this one
+	// table is shared, and it is freed when its last user lets it go; the twiddles of size are every (N / size)-th of it.
+	std::shared_ptr<const std::vector<cdouble>> Twiddles(size_t size);
+}
@@ -0,0 +1,235 @@
+#include "gemm.h"
+#include "complex.h"
+#include "complex_kernels.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Gemm;
+
+namespace
+{
+	// the operands are read and written through arrays of row pointers, so the rows need not be evenly spaced
+
+	template <class T> void PackA(size_t mc, size_t kc, const T * const * A, size_t col, T * packed)
+	{ // MR-row micro-panels of kc columns from col, each stored column by column; rows past the end are zero-filled
+		for (size_t ir = 0; ir < mc; ir += MR)
+		{
+			size_t mr = std::min(MR, mc - ir);
+
+			for (size_t k = 0; k < kc; k++)
+			{
+				for (size_t r = 0; r < mr; r++)
+					packed[r] = A[ir + r][col + k];
+				for (size_t r = mr; r < MR; r++)
+					packed[r] = T();
+
+				packed += MR;
+			}
+		}
+	}
+
+	template <class T> void PackB(size_t kc, size_t nc, size_t panelBegin, size_t panelEnd, const T * const * B, size_t col, T * packed)
+	{ // NR-column micro-panels [panelBegin, panelEnd) of the nc columns from col, each stored row by row; columns past the end are zero-filled
+		for (size_t panel = panelBegin; panel < panelEnd; panel++)
+		{
+			size_t jr = panel * NR;
+			size_t nr = std::min(NR, nc - jr);
+			T * out = packed + jr * kc;
+
+			for (size_t k = 0; k < kc; k++)
+			{
+				const T * row = B[k] + col + jr;
+
+				for (size_t c = 0; c < nr; c++)
+					out[c] = row[c];
+				for (size_t c = nr; c < NR; c++)
+					out[c] = T();
+
+				out += NR;
+			}
+		}
+	}
+
+	template <class T> void MicroKernel(size_t kc, const T * a, const T * b, T * const * C, size_t col, size_t mr, size_t nr)
+	{
+		T acc[MR][NR];
+
+		for (size_t k = 0; k < kc; k++, a += MR, b += NR)
+			for (size_t r = 0; r < MR; r++)
+				for (size_t c = 0; c < NR; c++)
+					acc[r][c] += a[r] * b[c];
+
+		for (size_t r = 0; r < mr; r++)
+			for (size_t c = 0; c < nr; c++)
+				C[r][col + c] += acc[r][c];
+	}
+
+	template <> void MicroKernel<cdouble>(size_t kc, const cdouble * a, const cdouble * b, cdouble * const * C, size_t col, size_t mr, size_t nr)
+	{ // real and imaginary parts are accumulated separately, so the whole tile stays in registers
+		double accReal[MR][NR] = {};
+		double accImag[MR][NR] = {};
+
+		for (size_t k = 0; k < kc; k++, a += MR, b += NR)
+		{
+			for (size_t r = 0; r < MR; r++)
+			{
+				const double aReal = a[r].Real(), aImag = a[r].Imag();
+
+				for (size_t c = 0; c < NR; c++)
+				{
+					const double bReal = b[c].Real(), bImag = b[c].Imag();
+
+					accReal[r][c] += aReal * bReal - aImag * bImag;
+					accImag[r][c] += aReal * bImag + aImag * bReal;
+				}
+			}
+		}
+
+		for (size_t r = 0; r < mr; r++)
+			for (size_t c = 0; c < nr; c++)
+				C[r][col + c] += cdouble(accReal[r][c], accImag[r][c]);
+	}
+
+	template <class T> T * PackedABuffer()
+	{ // every thread packs its own blocks of A
+		thread_local std::vector<T> buffer(MC * KC);
+		return buffer.data();
+	}
+
+	template <class T> void MultiplyPanel(size_t rowBegin, size_t rowEnd, size_t jc, size_t nc, size_t pc, size_t kc, const T * const * A, const T * packedB, T * const * C)
+	{ // adds the product of the kc columns of A from pc and the packed panel of B to columns [jc, jc + nc) of rows [rowBegin, rowEnd) of C
+		T * packedA = PackedABuffer<T>();
+
+		if (pc == 0)
+			for (size_t i = rowBegin; i < rowEnd; i++)
+				std::fill(C[i] + jc, C[i] + jc + nc, T());
+
+		for (size_t ic = rowBegin; ic < rowEnd; ic += MC)
+		{
+			size_t mc = std::min(MC, rowEnd - ic);
+
+			PackA(mc, kc, A + ic, pc, packedA);
+
+			for (size_t jr = 0; jr < nc; jr += NR)
+				for (size_t ir = 0; ir < mc; ir += MR)
+				{
+					MicroKernel(kc, packedA + ir * kc, packedB + jr * kc,
+						C + ic + ir, jc + jr, std::min(MR, mc - ir), std::min(NR, nc - jr));
+				}
+		}
+	}
+
+	template <class T> std::vector<T *> RowPointers(T * data, size_t rows, size_t stride)
+	{
+		std::vector<T *> result(rows);
+
+		for (size_t i = 0; i < rows; i++)
+			result[i] = data + i * stride;
+
+		return result;
+	}
+}
+
+template <class T> void Gemm::MultiplyNaive(size_t m, size_t n, size_t p, const T * A, size_t lda, const T * B, size_t ldb, T * C, size_t ldc)
+{
+	for (size_t i = 0; i < m; i++)
+	{
+		T * resultRow = C + i * ldc;
+		std::fill(resultRow, resultRow + p, T());
+
+		for (size_t k = 0; k < n; k++)
+		{
+			const T a = A[i * lda + k];
+			const T * otherRow = B + k * ldb;
+
+			for (size_t j = 0; j < p; j++)
+				resultRow[j] += a * otherRow[j];
+		}
+	}
+}
+
+template <class T> void Gemm::Multiply(size_t m, size_t n, size_t p, const T * A, size_t lda, const T * B, size_t ldb, T * C, size_t ldc)
+{
+	if (IsSmall(m, n, p))
+	{
+		MultiplyNaive(m, n, p, A, lda, B, ldb, C, ldc);
+		return;
+	}
+
+	MultiplyRows(m, n, p, RowPointers(A, m, lda).data(), RowPointers(B, n, ldb).data(), RowPointers(C, m, ldc).data());
+}
+
+template <class T> void Gemm::MultiplyRows(size_t m, size_t n, size_t p, const T * const * A, const T * const * B, T * const * C)
+{
+	if (IsSmall(m, n, p))
+	{
+		for (size_t i = 0; i < m; i++)
+		{
+			std::fill(C[i], C[i] + p, T());
+
+			for (size_t k = 0; k < n; k++)
+				ComplexKernels::Axpy(A[i][k], B[k], C[i], p);
+		}
+
+		return;
+	}
+
+	// every panel of B is packed once, by all threads together, and then shared by the threads that split the rows
+	std::vector<T> packedB(KC * ((NC + NR - 1) / NR * NR));
+
+	for (size_t jc = 0; jc < p; jc += NC)
+	{
+		size_t nc = std::min(NC, p - jc);
+
+		for (size_t pc = 0; pc < n; pc += KC)
+		{
+			size_t kc = std::min(KC, n - pc);
+
+			Parallel::For(0, (nc + NR - 1) / NR, Parallel::MIN_ELEMENTS_PER_THREAD / (KC * NR), [&](size_t panelBegin, size_t panelEnd)
+			{
+				PackB(kc, nc, panelBegin, panelEnd, B + pc, jc, packedB.data());
+			});
+
+			Parallel::For(0, m, MC, [&](size_t rowBegin, size_t rowEnd)
+			{
+				MultiplyPanel(rowBegin, rowEnd, jc, nc, pc, kc, A, packedB.data(), C);
+			});
+		}
+	}
+}
+
+template <class T> void Gemm::MultiplyVector(size_t m, size_t n, const T * A, size_t lda, const T * x, T * y)
+{ // a single streaming pass over A, rows split across threads for large matrixes
+	Parallel::For(0, m, MinRowsPerThread(n), [&](size_t rowBegin, size_t rowEnd)
+	{
+		for (size_t i = rowBegin; i < rowEnd; i++)
+		{
+			y[i] = ComplexKernels::MultiplyAccumulate(A + i * lda, x, n);
+		}
+	});
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		Gemm::Multiply<cint>(0, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0);
+		Gemm::Multiply<cdouble>(0, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0);
+		Gemm::Multiply<cfloat>(0, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0);
+
+		Gemm::MultiplyRows<cint>(0, 0, 0, nullptr, nullptr, nullptr);
+		Gemm::MultiplyRows<cdouble>(0, 0, 0, nullptr, nullptr, nullptr);
+		Gemm::MultiplyRows<cfloat>(0, 0, 0, nullptr, nullptr, nullptr);
+
+		Gemm::MultiplyVector<cint>(0, 0, nullptr, 0, nullptr, nullptr);
+		Gemm::MultiplyVector<cdouble>(0, 0, nullptr, 0, nullptr, nullptr);
+		Gemm::MultiplyVector<cfloat>(0, 0, nullptr, 0, nullptr, nullptr);
+
+		Gemm::MultiplyNaive<cint>(0, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0);
+		Gemm::MultiplyNaive<cdouble>(0, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0);
+		Gemm::MultiplyNaive<cfloat>(0, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0);
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+// General matrix multiplication engine for row-major complex matrixes stored in contiguous buffers.
+// Large products are computed in cache-sized tiles: blocks of A and B are packed into contiguous panels and
+// multiplied by a small register-blocked micro-kernel. Each panel of B is packed once and shared by all threads,
+// which split the rows of the result.
+namespace Gemm
+{
+	const size_t MR = 2; // rows of the micro-kernel tile
+	const size_t NR = 4; // columns of the micro-kernel tile
+	const size_t MC = 64; // rows of A packed at a time
+	const size_t KC = 128; // depth of the packed panels
+	const size_t NC = 512; // columns of B packed at a time
+
+	const size_t NAIVE_THRESHOLD = 32 * 32 * 32; // products with at most this many multiply-adds skip the tiling
+
+	inline bool IsSmall(size_t m, size_t n, size_t p) { return m * n * p <= NAIVE_THRESHOLD; }
+
+	const size_t MIN_WORK_PER_THREAD = 1 << 16; // multiply-adds, below this threads cost more than they save
+
+	inline size_t MinRowsPerThread(size_t n) { return n ? (MIN_WORK_PER_THREAD + n - 1) / n : MIN_WORK_PER_THREAD; }
+
+	// C = A * B, where A is m x n, B is n x p and C is m x p; lda, ldb and ldc are the row strides in elements.
+	// C is overwritten and must not overlap with A or B.
+	template <class T> void Multiply(size_t m, size_t n, size_t p, const T * A, size_t lda, const T * B, size_t ldb, T * C, size_t ldc);
+
+	// the same with every matrix given as an array of pointers to its rows, which can then live in separate buffers
+	template <class T> void MultiplyRows(size_t m, size_t n, size_t p, const T * const * A, const T * const * B, T * const * C);
+
+	// y = A * x, where A is m x n with row stride lda; y must not overlap with A or x
+	template <class T> void MultiplyVector(size_t m, size_t n, const T * A, size_t lda, const T * x, T * y);
+
+	// the plain triple loop, used for small products and as a reference
+	template <class T> void MultiplyNaive(size_t m, size_t n, size_t p, const T * A, size_t lda, const T * B, size_t ldb, T * C, size_t ldc);
+}
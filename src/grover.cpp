@@ -0,0 +1,219 @@
+#include "grover.h"
+#include "parallel.h"
+#include "qc_algorithms.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const double PI = 3.14159265358979323846;
+
+	struct Sums // of all the amplitudes and of the marked ones, what the mean after the phase flip is computed from
+	{
+		cdouble m_all;
+		cdouble m_marked;
+	};
+
+	Sums Add(const Sums & a, const Sums & b)
+	{
+		return { a.m_all + b.m_all, a.m_marked + b.m_marked };
+	}
+
+	cdouble Sum(const cdouble_vector & state)
+	{
+		const cdouble * data = state.data();
+
+		return Parallel::Reduce(size_t(0), state.size(), Parallel::MIN_ELEMENTS_PER_THREAD, cdouble(), [&](size_t begin, size_t end)
+		{
+			cdouble sum;
+			for (size_t i = begin; i < end; i++)
+				sum += data[i];
+
+			return sum;
+		}, [](const cdouble & a, const cdouble & b) { return a + b; });
+	}
+}
+
+Grover::Oracle::Oracle(const std::vector<size_t> & marked)
+	: m_marked(marked)
+{
+	std::sort(m_marked.begin(), m_marked.end());
+	m_marked.erase(std::unique(m_marked.begin(), m_marked.end()), m_marked.end());
+}
+
+bool Grover::Oracle::IsMarked(size_t index) const
+{
+	if (m_predicate)
+		return m_predicate(index);
+
+	return std::binary_search(m_marked.begin(), m_marked.end(), index);
+}
+
+size_t Grover::Oracle::MarkedCount(size_t size) const
+{
+	if (!m_predicate)
+		return std::lower_bound(m_marked.begin(), m_marked.end(), size) - m_marked.begin();
+
+	return Parallel::Reduce(size_t(0), size, Parallel::MIN_ELEMENTS_PER_THREAD, size_t(0), [&](size_t begin, size_t end)
+	{
+		size_t count = 0;
+		for (size_t i = begin; i < end; i++)
+			if (m_predicate(i))
+				count++;
+
+		return count;
+	}, [](size_t a, size_t b) { return a + b; });
+}
+
+void Grover::Oracle::Apply(cdouble_vector & state) const
+{
+	cdouble * data = state.data();
+
+	Parallel::For(0, state.size(), Parallel::MIN_ELEMENTS_PER_THREAD, [&](size_t begin, size_t end)
+	{
+		ForEachRun(begin, end, [&](size_t runBegin, size_t runEnd, bool marked)
+		{
+			if (marked)
+				for (size_t i = runBegin; i < runEnd; i++)
+					data[i] = -data[i];
+		});
+	});
+}
+
+void Grover::Oracle::ForEachRun(size_t begin, size_t end, const std::function<void(size_t, size_t, bool)> & body) const
+{
+	if (m_predicate)
+	{
+		for (size_t runBegin = begin; runBegin < end; )
+		{
+			bool marked = m_predicate(runBegin);
+
+			size_t runEnd = runBegin + 1;
+			while (runEnd < end && m_predicate(runEnd) == marked)
+				runEnd++;
+
+			body(runBegin, runEnd, marked);
+			runBegin = runEnd;
+		}
+
+		return;
+	}
+
+	size_t runBegin = begin;
+
+	for (auto marked = std::lower_bound(m_marked.begin(), m_marked.end(), begin); marked != m_marked.end() && *marked < end; ++marked)
+	{
+		if (runBegin < *marked)
+			body(runBegin, *marked, false);
+
+		body(*marked, *marked + 1, true);
+		runBegin = *marked + 1;
+	}
+
+	if (runBegin < end)
+		body(runBegin, end, false);
+}
+
+size_t Grover::OptimalIterations(size_t size, size_t markedCount)
+{ // every iteration rotates the state by 2 theta towards the marked states, starting theta away from the unmarked ones
+	if (markedCount == 0 || markedCount >= size)
+		return 0;
+
+	double theta = asin(sqrt(double(markedCount) / size));
+
+	return static_cast<size_t>(floor(PI / (4 * theta)));
+}
+
+void Grover::InverseAboutMean(cdouble_vector & state)
+{
+	if (state.empty())
+		return;
+
+	const cdouble twoMean = Sum(state) * cdouble(2.0 / state.size());
+	cdouble * data = state.data();
+
+	Parallel::For(0, state.size(), Parallel::MIN_ELEMENTS_PER_THREAD, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			data[i] = twoMean - data[i];
+	});
+}
+
+void Grover::Iterate(cdouble_vector & state, const Oracle & oracle, size_t iterations)
+{
+	const size_t n = state.size();
+
+	if (n == 0 || iterations == 0)
+		return;
+
+	cdouble * data = state.data();
+
+	auto pass = [&](const std::function<void(size_t, size_t, bool, Sums &)> & update)
+	{
+		return Parallel::Reduce(size_t(0), n, Parallel::MIN_ELEMENTS_PER_THREAD, Sums(), [&](size_t begin, size_t end)
+		{
+			Sums sums;
+			oracle.ForEachRun(begin, end, [&](size_t runBegin, size_t runEnd, bool marked) { update(runBegin, runEnd, marked, sums); });
+
+			return sums;
+		}, Add);
+	};
+
+	Sums sums = pass([&](size_t runBegin, size_t runEnd, bool marked, Sums & partial)
+	{
+		for (size_t i = runBegin; i < runEnd; i++)
+		{
+			partial.m_all += data[i];
+			if (marked)
+				partial.m_marked += data[i];
+		}
+	});
+
+	for (size_t iteration = 0; iteration < iterations; iteration++)
+	{
+		// after the phase flip the marked amplitudes are negated, which changes the sum by twice their sum
+		const cdouble twoMean = (sums.m_all - sums.m_marked - sums.m_marked) * cdouble(2.0 / n);
+
+		sums = pass([&](size_t runBegin, size_t runEnd, bool marked, Sums & partial)
+		{ // the phase flip and the inversion about the mean, summing up the new amplitudes for the next iteration
+			cdouble sum;
+
+			if (marked)
+			{
+				for (size_t i = runBegin; i < runEnd; i++)
+				{
+					data[i] += twoMean;
+					sum += data[i];
+				}
+
+				partial.m_marked += sum;
+			}
+			else
+			{
+				for (size_t i = runBegin; i < runEnd; i++)
+				{
+					data[i] = twoMean - data[i];
+					sum += data[i];
+				}
+			}
+
+			partial.m_all += sum;
+		});
+	}
+}
+
+cdouble_vector Grover::Run(size_t qubitCount, const Oracle & oracle)
+{
+	const size_t n = size_t(1) << qubitCount;
+
+	cdouble_vector state(n, cdouble(1 / sqrt(double(n)))); // H (x) ... (x) H |0...0>
+	Iterate(state, oracle, OptimalIterations(n, oracle.MarkedCount(n)));
+
+	return state;
+}
+
+size_t Grover::Search(size_t qubitCount, const Oracle & oracle)
+{
+	return QC_Algorithms::Measure(Run(qubitCount, oracle));
+}
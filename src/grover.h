@@ -0,0 +1,43 @@
+#pragma once
+
+#include "cvector.h"
+
+#include <functional>
+
+// Grover's search on a state vector, see pages 195-204. One iteration flips the phase of the marked states and
+// inverts every amplitude about the mean; both are done in one pass over the vector, which also sums up what the
+// mean of the next iteration needs, so no N x N averager matrix is ever built and an iteration costs O(N).
+namespace Grover
+{
+	// The marked states of a search: either a list of indices or a predicate on the index. The predicate is
+	// called once per amplitude and iteration, from several threads at once.
+	class Oracle
+	{
+	public:
+		Oracle(const std::vector<size_t> & marked);
+		Oracle(const std::function<bool(size_t)> & predicate) : m_predicate(predicate) {}
+
+		bool IsMarked(size_t index) const;
+		size_t MarkedCount(size_t size) const; // of the indices below size; evaluates the predicate on all of them
+
+		void Apply(cdouble_vector & state) const; // the phase flip alone, state[i] = -state[i] for the marked i
+
+		// calls body(begin, end, marked) for the consecutive runs of [begin, end) that are all marked or all unmarked
+		void ForEachRun(size_t begin, size_t end, const std::function<void(size_t, size_t, bool)> & body) const;
+
+	protected:
+		std::vector<size_t> m_marked; // sorted, without duplicates; unused with a predicate
+		std::function<bool(size_t)> m_predicate;
+	};
+
+	// the number of iterations after which measuring most likely gives a marked state, about pi/4 sqrt(size / markedCount)
+	size_t OptimalIterations(size_t size, size_t markedCount);
+
+	void InverseAboutMean(cdouble_vector & state); // state[i] = 2 * mean - state[i], in place
+
+	void Iterate(cdouble_vector & state, const Oracle & oracle, size_t iterations);
+
+	// the whole search: the uniform superposition on qubitCount qubits, then OptimalIterations iterations
+	cdouble_vector Run(size_t qubitCount, const Oracle & oracle);
+	size_t Search(size_t qubitCount, const Oracle & oracle); // Run, then a measurement; returns a marked index with high probability
+}
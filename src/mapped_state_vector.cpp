@@ -0,0 +1,275 @@
+#include "mapped_state_vector.h"
+#include "complex_kernels.h"
+#include "parallel.h"
+#include "state_vector.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+template <class T> mapped_state_vector<T>::mapped_state_vector(const std::string & path, size_t qubitCount, size_t chunkBytes /*= DEFAULT_CHUNK_BYTES*/)
+	: m_qubitCount(qubitCount)
+{
+	if (qubitCount == 0 || qubitCount >= 8 * sizeof(size_t) - 5)
+		throw std::out_of_range("Qubit count out of range");
+
+	m_file = memory_mapped_file(path, Size() * sizeof(T)); // a new file reads as zeros, without writing them
+	SetChunkSize(chunkBytes);
+
+	(*this)[0] = T(1);
+}
+
+template <class T> mapped_state_vector<T> mapped_state_vector<T>::Open(const std::string & path, size_t chunkBytes /*= DEFAULT_CHUNK_BYTES*/)
+{
+	mapped_state_vector result;
+	result.m_file = memory_mapped_file(path);
+
+	size_t size = result.m_file.Size() / sizeof(T);
+
+	if (size < 2 || (size & (size - 1)) != 0 || size * sizeof(T) != result.m_file.Size())
+		throw std::out_of_range("The file does not hold a state vector: the size must be a power of 2 amplitudes");
+
+	while (size > 1)
+	{
+		size >>= 1;
+		result.m_qubitCount++;
+	}
+
+	result.SetChunkSize(chunkBytes);
+
+	return result;
+}
+
+template <class T> void mapped_state_vector<T>::SetChunkSize(size_t chunkBytes)
+{
+	m_chunkSize = 2;
+	while (m_chunkSize < Size() && 2 * m_chunkSize * sizeof(T) <= chunkBytes)
+		m_chunkSize *= 2;
+
+	m_file.AdviseSequential();
+}
+
+template <class T> void mapped_state_vector<T>::Load(const complex_vector<T> & state)
+{
+	if (state.size() != Size())
+		throw std::out_of_range("The state does not have the size of the mapped state vector");
+
+	std::copy(state.begin(), state.end(), Data());
+}
+
+template <class T> complex_vector<T> mapped_state_vector<T>::ToVector() const
+{
+	complex_vector<T> result(Size());
+	std::copy(Data(), Data() + Size(), result.begin());
+
+	return result;
+}
+
+template <class T> void mapped_state_vector<T>::Prefetch(size_t block, size_t stride)
+{
+	const size_t pairsPerBlock = m_chunkSize / 2;
+	const size_t first = StateVector::PairIndex(block * pairsPerBlock, stride);
+
+	if (2 * stride <= m_chunkSize) // the pairs of the block are one run of amplitudes
+		m_file.Prefetch(first * sizeof(T), m_chunkSize * sizeof(T));
+	else // a run in the lower half of the pairs, and the same run one stride later
+	{
+		m_file.Prefetch(first * sizeof(T), pairsPerBlock * sizeof(T));
+		m_file.Prefetch((first + stride) * sizeof(T), pairsPerBlock * sizeof(T));
+	}
+}
+
+template <class T> void mapped_state_vector<T>::Release(size_t block, size_t stride)
+{
+	const size_t pairsPerBlock = m_chunkSize / 2;
+	const size_t first = StateVector::PairIndex(block * pairsPerBlock, stride);
+
+	if (2 * stride <= m_chunkSize)
+		m_file.Release(first * sizeof(T), m_chunkSize * sizeof(T));
+	else
+	{
+		m_file.Release(first * sizeof(T), pairsPerBlock * sizeof(T));
+		m_file.Release((first + stride) * sizeof(T), pairsPerBlock * sizeof(T));
+	}
+}
+
+template <class T> template <class F> void mapped_state_vector<T>::ForEachPairBlock(size_t stride, F body)
+{ // pairsPerBlock and the stride are powers of 2, so the pairs of a block are whole runs of the stride or part of one
+	const size_t pairsPerBlock = m_chunkSize / 2, blocks = Size() / m_chunkSize;
+
+	Prefetch(0, stride);
+
+	for (size_t block = 0; block < blocks; block++)
+	{
+		if (block + 1 < blocks)
+			Prefetch(block + 1, stride);
+
+		Parallel::For(block * pairsPerBlock, (block + 1) * pairsPerBlock, StateVector::MIN_PAIRS_PER_THREAD, body, StateVector::CHUNK_GRANULARITY);
+
+		Release(block, stride);
+	}
+}
+
+template <class T> void mapped_state_vector<T>::ApplyGate(const complex_matrix<T> & gate, size_t qubit)
+{
+	if (qubit >= m_qubitCount)
+		throw std::out_of_range("Qubit index out of range");
+
+	if (gate.Rows() != 2 || gate[0].size() != 2 || gate[1].size() != 2)
+		throw std::out_of_range("A single-qubit gate must be a 2x2 matrix");
+
+	const T g[4] = { gate[0][0], gate[0][1], gate[1][0], gate[1][1] };
+	const size_t stride = StateVector::QubitStride(m_qubitCount, qubit);
+	T * data = Data();
+
+	ForEachPairBlock(stride, [&](size_t pairBegin, size_t pairEnd)
+	{
+		StateVector::ApplyPairKernel(data, stride, pairBegin, pairEnd, g);
+	});
+}
+
+template <class T> void mapped_state_vector<T>::ApplyGateToAll(const complex_matrix<T> & gate)
+{
+	for (size_t qubit = 0; qubit < m_qubitCount; qubit++)
+		ApplyGate(gate, qubit);
+}
+
+template <class T> size_t mapped_state_vector<T>::ControlMask(const std::vector<size_t> & controls, size_t target) const
+{
+	size_t result = 0;
+
+	for (size_t qubit : controls)
+	{
+		if (qubit >= m_qubitCount || target >= m_qubitCount)
+			throw std::out_of_range("Qubit index out of range");
+
+		size_t mask = StateVector::QubitStride(m_qubitCount, qubit);
+
+		if (qubit == target || (result & mask))
+			throw std::invalid_argument("The qubits of a gate must be different");
+
+		result |= mask;
+	}
+
+	if (target >= m_qubitCount)
+		throw std::out_of_range("Qubit index out of range");
+
+	return result;
+}
+
+template <class T> void mapped_state_vector<T>::ApplyControlledGate(const complex_matrix<T> & gate, const std::vector<size_t> & controls, size_t target)
+{ // the pairs are visited in the order of ApplyGate, which keeps the I/O sequential, and skipped unless all controls are 1
+	const size_t controlMask = ControlMask(controls, target);
+
+	if (gate.Rows() != 2 || gate[0].size() != 2 || gate[1].size() != 2)
+		throw std::out_of_range("A single-qubit gate must be a 2x2 matrix");
+
+	const T g[4] = { gate[0][0], gate[0][1], gate[1][0], gate[1][1] };
+	const size_t stride = StateVector::QubitStride(m_qubitCount, target);
+	T * data = Data();
+
+	ForEachPairBlock(stride, [&](size_t pairBegin, size_t pairEnd)
+	{
+		for (size_t pair = pairBegin; pair < pairEnd; pair++)
+		{
+			size_t i = StateVector::PairIndex(pair, stride);
+
+			if ((i & controlMask) == controlMask)
+			{
+				const T x = data[i], y = data[i + stride];
+
+				data[i] = g[0] * x + g[1] * y;
+				data[i + stride] = g[2] * x + g[3] * y;
+			}
+		}
+	});
+}
+
+template <class T> void mapped_state_vector<T>::ApplyControlledX(const std::vector<size_t> & controls, size_t target)
+{
+	const size_t controlMask = ControlMask(controls, target);
+	const size_t stride = StateVector::QubitStride(m_qubitCount, target);
+	T * data = Data();
+
+	ForEachPairBlock(stride, [&](size_t pairBegin, size_t pairEnd)
+	{
+		for (size_t pair = pairBegin; pair < pairEnd; pair++)
+		{
+			size_t i = StateVector::PairIndex(pair, stride);
+
+			if ((i & controlMask) == controlMask)
+				std::swap(data[i], data[i + stride]);
+		}
+	});
+}
+
+template <class T> T mapped_state_vector<T>::NormSquare() const
+{ // block by block in order, the blocks of a gate on the lowest bit are plain runs of amplitudes
+	auto * self = const_cast<mapped_state_vector *>(this);
+	const T * data = Data();
+	const size_t blocks = Size() / m_chunkSize;
+
+	double result = 0;
+	self->Prefetch(0, 1);
+
+	for (size_t block = 0; block < blocks; block++)
+	{
+		if (block + 1 < blocks)
+			self->Prefetch(block + 1, 1);
+
+		result += Parallel::Reduce(block * m_chunkSize, (block + 1) * m_chunkSize, Parallel::MIN_ELEMENTS_PER_THREAD, 0.0, [&](size_t begin, size_t end)
+		{
+			return ComplexKernels::SumModulusSquared(data + begin, end - begin);
+		}, [](double x, double y) { return x + y; });
+
+		self->Release(block, 1);
+	}
+
+	return T::FromReal(result);
+}
+
+template <class T> std::vector<double> mapped_state_vector<T>::MeasurementProbabilities(size_t firstIndex, size_t count) const
+{
+	if (firstIndex > Size() || count > Size() - firstIndex)
+		throw std::out_of_range("The range is not inside the state vector");
+
+	std::vector<double> result(count);
+
+	const T * amplitudes = Data() + firstIndex;
+	double * probabilities = result.data();
+
+	Parallel::For(0, count, Parallel::MIN_ELEMENTS_PER_THREAD, [&](size_t begin, size_t end)
+	{
+		ComplexKernels::ModulusSquared(amplitudes + begin, probabilities + begin, end - begin);
+	});
+
+	return result;
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		cdouble_mapped_state_vector vd("", 1);
+		vd.Load(cdouble_vector());
+		vd.ToVector();
+		vd.ApplyGate(cdouble_matrix(), 0);
+		vd.ApplyGateToAll(cdouble_matrix());
+		vd.ApplyControlledGate(cdouble_matrix(), {}, 0);
+		vd.ApplyControlledX({}, 0);
+		vd.NormSquare();
+		vd.MeasurementProbabilities(0, 0);
+		cdouble_mapped_state_vector::Open("");
+
+		cfloat_mapped_state_vector vf("", 1);
+		vf.Load(cfloat_vector());
+		vf.ToVector();
+		vf.ApplyGate(cfloat_matrix(), 0);
+		vf.ApplyGateToAll(cfloat_matrix());
+		vf.ApplyControlledGate(cfloat_matrix(), {}, 0);
+		vf.ApplyControlledX({}, 0);
+		vf.NormSquare();
+		vf.MeasurementProbabilities(0, 0);
+		cfloat_mapped_state_vector::Open("");
+	}
+}
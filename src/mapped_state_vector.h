@@ -0,0 +1,67 @@
+#pragma once
+
+#include "cmatrix.h"
+#include "memory_mapped_file.h"
+
+#include <string>
+
+// A state vector kept in a memory-mapped file, for registers whose 2^n amplitudes do not fit in the RAM
+// (33 qubits of cdouble are 128 GB). Gates are applied with the kernels of StateVector, one block of
+// ChunkSize() amplitudes after the other, so the file is read and written in order: a gate whose stride is
+// below the chunk streams through the file once, and a gate on a higher bit walks the two halves of every
+// pair of chunks side by side. The next block is prefetched while the current one is computed, across
+// Parallel's threads, and the pages of the finished blocks are released.
+//
+// The file holds the raw amplitudes, nothing else, so a vector written on one machine is only read back on a
+// machine with the same byte order.
+template <class T>
+class mapped_state_vector
+{
+public:
+	static const size_t DEFAULT_CHUNK_BYTES = size_t(1) << 26; // 64 MB, many pages of readahead but few blocks in flight
+
+	mapped_state_vector(const std::string & path, size_t qubitCount, size_t chunkBytes = DEFAULT_CHUNK_BYTES); // a new file holding |0...0>
+	static mapped_state_vector Open(const std::string & path, size_t chunkBytes = DEFAULT_CHUNK_BYTES); // an existing file
+
+	size_t QubitCount() const { return m_qubitCount; }
+	size_t Size() const { return size_t(1) << m_qubitCount; }
+	size_t ChunkSize() const { return m_chunkSize; } // amplitudes in a block, a power of 2
+
+	T * Data() { return reinterpret_cast<T *>(m_file.Data()); }
+	const T * Data() const { return reinterpret_cast<const T *>(m_file.Data()); }
+	T & operator[](size_t index) { return Data()[index]; }
+	const T & operator[](size_t index) const { return Data()[index]; }
+
+	void Load(const complex_vector<T> & state); // the size must match
+	complex_vector<T> ToVector() const;
+
+	void ApplyGate(const complex_matrix<T> & gate, size_t qubit); // as StateVector::ApplyGate
+	void ApplyGateToAll(const complex_matrix<T> & gate);
+	void ApplyControlledGate(const complex_matrix<T> & gate, const std::vector<size_t> & controls, size_t target);
+	void ApplyControlledX(const std::vector<size_t> & controls, size_t target);
+
+	T NormSquare() const; // accumulated in double, as complex_vector::NormSquare
+	std::vector<double> MeasurementProbabilities(size_t firstIndex, size_t count) const; // |amplitude|^2 of a range
+
+	void Flush() { m_file.Flush(); } // waits until the amplitudes are on the disk
+
+protected:
+	mapped_state_vector() = default;
+
+	void SetChunkSize(size_t chunkBytes);
+
+	// calls body(pairBegin, pairEnd) on the pairs of a gate with this stride, block by block, each block across threads
+	template <class F> void ForEachPairBlock(size_t stride, F body);
+
+	void Prefetch(size_t block, size_t stride); // the ranges of the amplitudes of a block
+	void Release(size_t block, size_t stride);
+
+	size_t ControlMask(const std::vector<size_t> & controls, size_t target) const;
+
+	mutable memory_mapped_file m_file;
+	size_t m_qubitCount = 0;
+	size_t m_chunkSize = 0;
+};
+
+typedef mapped_state_vector<cfloat> cfloat_mapped_state_vector;
+typedef mapped_state_vector<cdouble> cdouble_mapped_state_vector;
@@ -0,0 +1,196 @@
+#include "measurement_sampler.h"
+#include "parallel.h"
+#include "qc_algorithms.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	std::mt19937_64 BlockGenerator(uint64_t seed, size_t block)
+	{
+		std::seed_seq sequence({ uint32_t(seed), uint32_t(seed >> 32), uint32_t(block), uint32_t(uint64_t(block) >> 32) });
+		return std::mt19937_64(sequence);
+	}
+}
+
+measurement_sampler::measurement_sampler(const cdouble_vector & state)
+{
+	Build(QC_Algorithms::MeasurementProbabilitiesVector(state));
+}
+
+measurement_sampler::measurement_sampler(const std::vector<double> & weights)
+{
+	Build(weights);
+}
+
+void measurement_sampler::Build(const std::vector<double> & weights)
+{ // Vose's version: columns below the average are topped up from the ones above, one at a time
+	const size_t n = weights.size();
+
+	double total = 0;
+	for (double weight : weights)
+	{
+		if (weight < 0)
+			throw std::invalid_argument("Probabilities cannot be negative");
+
+		total += weight;
+	}
+
+	if (n == 0 || total <= 0)
+		throw std::invalid_argument("Cannot sample from a state without any nonzero amplitude");
+
+	m_probabilities.resize(n);
+	m_threshold.resize(n);
+	m_alias.resize(n);
+
+	std::vector<size_t> small, large;
+
+	for (size_t i = 0; i < n; i++)
+	{
+		m_probabilities[i] = weights[i] / total;
+		m_threshold[i] = m_probabilities[i] * n; // the column height, 1 on average
+		m_alias[i] = i;
+
+		(m_threshold[i] < 1 ? small : large).push_back(i);
+	}
+
+	while (!small.empty() && !large.empty())
+	{
+		size_t less = small.back(), more = large.back();
+		small.pop_back();
+
+		m_alias[less] = more;
+		m_threshold[more] -= 1 - m_threshold[less];
+
+		if (m_threshold[more] < 1)
+		{
+			large.pop_back();
+			small.push_back(more);
+		}
+	}
+
+	// what is left is 1 up to rounding errors
+	for (size_t i : small)
+		m_threshold[i] = 1;
+	for (size_t i : large)
+		m_threshold[i] = 1;
+}
+
+size_t measurement_sampler::Pick(double random) const
+{ // the integer part of random * n picks the column, the fraction is the coin
+	const size_t n = Size();
+	double x = random * n;
+
+	size_t column = std::min(static_cast<size_t>(x), n - 1);
+
+	return x - column < m_threshold[column] ? column : m_alias[column];
+}
+
+size_t measurement_sampler::Sample() const
+{
+	return Pick(QC_Algorithms::RandomNumber());
+}
+
+size_t measurement_sampler::Sample(std::mt19937_64 & generator) const
+{
+	return Pick(std::uniform_real_distribution<double>(0.0, 1.0)(generator));
+}
+
+size_t measurement_sampler::SampleOnce(const cdouble_vector & state)
+{
+	return PickOnce(state, QC_Algorithms::RandomNumber());
+}
+
+size_t measurement_sampler::SampleOnce(const cdouble_vector & state, std::mt19937_64 & generator)
+{
+	return PickOnce(state, std::uniform_real_distribution<double>(0.0, 1.0)(generator));
+}
+
+size_t measurement_sampler::PickOnce(const cdouble_vector & state, double random)
+{ // the first index where the running sum of the probabilities passes random
+	const double total = state.NormSquare().Real();
+
+	if (state.empty() || !(total > 0))
+		throw std::invalid_argument("Cannot sample from a state without any nonzero amplitude");
+
+	random *= total;
+
+	double sum = 0;
+	size_t last = 0; // the last index with a nonzero probability, for when rounding leaves the sum short of random
+
+	for (size_t i = 0; i < state.size(); i++)
+	{
+		double p = state[i].ModulusSquared();
+		if (p == 0)
+			continue;
+
+		sum += p;
+		if (random < sum)
+			return i;
+
+		last = i;
+	}
+
+	return last;
+}
+
+std::vector<size_t> measurement_sampler::Sample(size_t shots, uint64_t seed) const
+{
+	std::vector<size_t> result(shots);
+
+	Parallel::For(0, (shots + SHOTS_PER_BLOCK - 1) / SHOTS_PER_BLOCK, 1, [&](size_t blockBegin, size_t blockEnd)
+	{
+		for (size_t block = blockBegin; block < blockEnd; block++)
+		{
+			std::mt19937_64 generator = BlockGenerator(seed, block);
+
+			for (size_t shot = block * SHOTS_PER_BLOCK, end = std::min(shots, shot + SHOTS_PER_BLOCK); shot < end; shot++)
+				result[shot] = Sample(generator);
+		}
+	});
+
+	return result;
+}
+
+std::vector<size_t> measurement_sampler::Sample(size_t shots) const
+{
+	return Sample(shots, RandomSeed());
+}
+
+std::vector<size_t> measurement_sampler::Histogram(size_t shots, uint64_t seed) const
+{ // the same shots as Sample(shots, seed), counted in a histogram per chunk of blocks instead of being stored
+	const size_t n = Size();
+
+	return Parallel::Reduce(size_t(0), (shots + SHOTS_PER_BLOCK - 1) / SHOTS_PER_BLOCK, 1, std::vector<size_t>(n), [&](size_t blockBegin, size_t blockEnd)
+	{
+		std::vector<size_t> counts(n);
+
+		for (size_t block = blockBegin; block < blockEnd; block++)
+		{
+			std::mt19937_64 generator = BlockGenerator(seed, block);
+
+			for (size_t shot = block * SHOTS_PER_BLOCK, end = std::min(shots, shot + SHOTS_PER_BLOCK); shot < end; shot++)
+				counts[Sample(generator)]++;
+		}
+
+		return counts;
+	}, [](std::vector<size_t> a, const std::vector<size_t> & b)
+	{
+		for (size_t i = 0; i < a.size(); i++)
+			a[i] += b[i];
+
+		return a;
+	});
+}
+
+std::vector<size_t> measurement_sampler::Histogram(size_t shots) const
+{
+	return Histogram(shots, RandomSeed());
+}
+
+uint64_t measurement_sampler::RandomSeed()
+{
+	std::random_device device;
+	return (uint64_t(device()) << 32) ^ device();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "cvector.h"
+
+#include <cstdint>
+#include <random>
+
+// Repeated measurements of the same state. The probabilities |state[i]|^2 are turned once into Walker's alias
+// table in O(N); every shot then costs O(1): a uniform column, and a biased coin that keeps it or takes its alias.
+class measurement_sampler
+{
+public:
+	static const size_t SHOTS_PER_BLOCK = 1 << 16; // the shots of one random generator in the parallel methods
+
+	explicit measurement_sampler(const cdouble_vector & state); // the state does not need to be normalized
+	explicit measurement_sampler(const std::vector<double> & weights); // nonnegative, proportional to the probabilities
+
+	size_t Size() const { return m_threshold.size(); }
+	double Probability(size_t index) const { return m_probabilities[index]; }
+
+	size_t Sample() const; // with QC_Algorithms::RandomNumber()
+	size_t Sample(std::mt19937_64 & generator) const;
+
+	// Many shots, split across threads in blocks of SHOTS_PER_BLOCK. Block b draws from a generator seeded with
+	// (seed, b), so the result only depends on the seed, not on the number of threads.
+	std::vector<size_t> Sample(size_t shots, uint64_t seed) const;
+	std::vector<size_t> Sample(size_t shots) const; // with a random seed
+
+	std::vector<size_t> Histogram(size_t shots, uint64_t seed) const; // how many of the shots gave each index
+	std::vector<size_t> Histogram(size_t shots) const;
+
+	// A single shot without building the table: one uniform number and a cumulative scan of |state[i]|^2, so O(N)
+	// time and no memory. Cheaper than the sampler when a state is measured only once.
+	static size_t SampleOnce(const cdouble_vector & state); // with QC_Algorithms::RandomNumber()
+	static size_t SampleOnce(const cdouble_vector & state, std::mt19937_64 & generator);
+
+protected:
+	void Build(const std::vector<double> & weights);
+	size_t Pick(double random) const; // random is uniform in [0, 1)
+	static size_t PickOnce(const cdouble_vector & state, double random);
+
+	static uint64_t RandomSeed();
+
+	std::vector<double> m_probabilities;
+	std::vector<double> m_threshold; // column i keeps i with this probability, and gives m_alias[i] otherwise
+	std::vector<size_t> m_alias;
+};
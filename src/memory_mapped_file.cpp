@@ -0,0 +1,265 @@
+#include "memory_mapped_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	std::system_error LastError(const std::string & what) // read before anything else can change the error code
+	{
+#ifdef _WIN32
+		return std::system_error(int(GetLastError()), std::system_category(), what);
+#else
+		return std::system_error(errno, std::generic_category(), what);
+#endif
+	}
+}
+
+memory_mapped_file::memory_mapped_file(const std::string & path, size_t size)
+	: m_path(path)
+{
+	Open(true, size, true);
+}
+
+memory_mapped_file::memory_mapped_file(const std::string & path, bool writable /*= true*/)
+	: m_path(path)
+{
+	Open(false, 0, writable);
+}
+
+memory_mapped_file::~memory_mapped_file()
+{
+	Close();
+}
+
+memory_mapped_file::memory_mapped_file(memory_mapped_file && other) noexcept
+{
+	*this = std::move(other);
+}
+
+memory_mapped_file & memory_mapped_file::operator=(memory_mapped_file && other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+
+		m_path = std::move(other.m_path);
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+		m_file = std::exchange(other.m_file, nullptr);
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+#else
+		m_file = std::exchange(other.m_file, -1);
+#endif
+	}
+
+	return *this;
+}
+
+size_t memory_mapped_file::PageSize()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+#else
+	return size_t(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+#ifdef _WIN32
+
+void memory_mapped_file::Open(bool create, size_t size, bool writable)
+{
+	m_file = CreateFileA(m_path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, writable ? 0 : FILE_SHARE_READ, nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		m_file = nullptr;
+		throw LastError("Cannot open " + m_path);
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (create)
+	{
+		fileSize.QuadPart = LONGLONG(size);
+		if (!SetFilePointerEx(m_file, fileSize, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file))
+		{
+			std::system_error error = LastError("Cannot set the size of " + m_path);
+			Close();
+			throw error;
+		}
+	}
+	else if (!GetFileSizeEx(m_file, &fileSize))
+	{
+		std::system_error error = LastError("Cannot read the size of " + m_path);
+		Close();
+		throw error;
+	}
+
+	m_size = size_t(fileSize.QuadPart);
+
+	if (m_size == 0) // an empty file cannot be mapped
+		return;
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+	m_data = m_mapping ? static_cast<char *>(MapViewOfFile(m_mapping, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+	if (!m_data)
+	{
+		std::system_error error = LastError("Cannot map " + m_path);
+		Close();
+		throw error;
+	}
+}
+
+void memory_mapped_file::Close()
+{
+	if (m_data)
+		UnmapViewOfFile(m_data);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	if (m_file)
+		CloseHandle(m_file);
+
+	m_data = nullptr;
+	m_mapping = m_file = nullptr;
+	m_size = 0;
+}
+
+void memory_mapped_file::AdviseSequential()
+{ // FILE_FLAG_SEQUENTIAL_SCAN was given when the file was opened
+}
+
+void memory_mapped_file::Prefetch(size_t offset, size_t length)
+{
+	if (!PageRange(offset, length))
+		return;
+
+	WIN32_MEMORY_RANGE_ENTRY range = { m_data + offset, length };
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0); // only a hint, a failure changes nothing
+}
+
+void memory_mapped_file::Release(size_t offset, size_t length)
+{ // unlocking pages that are not locked takes them out of the working set
+	if (PageRange(offset, length))
+		VirtualUnlock(m_data + offset, length);
+}
+
+void memory_mapped_file::Flush()
+{
+	if (m_data && (!FlushViewOfFile(m_data, 0) || !FlushFileBuffers(m_file)))
+		throw LastError("Cannot write back " + m_path);
+}
+
+#else
+
+void memory_mapped_file::Open(bool create, size_t size, bool writable)
+{
+	m_file = open(m_path.c_str(), create ? O_RDWR | O_CREAT | O_TRUNC : writable ? O_RDWR : O_RDONLY, 0644);
+	if (m_file < 0)
+		throw LastError("Cannot open " + m_path);
+
+	if (create)
+	{
+		if (ftruncate(m_file, off_t(size)) != 0)
+		{
+			std::system_error error = LastError("Cannot set the size of " + m_path);
+			Close();
+			throw error;
+		}
+	}
+	else
+	{
+		struct stat status;
+		if (fstat(m_file, &status) != 0)
+		{
+			std::system_error error = LastError("Cannot read the size of " + m_path);
+			Close();
+			throw error;
+		}
+
+		size = size_t(status.st_size);
+	}
+
+	m_size = size;
+
+	if (m_size == 0) // an empty file cannot be mapped
+		return;
+
+	void * data = mmap(nullptr, m_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m_file, 0);
+	if (data == MAP_FAILED)
+	{
+		std::system_error error = LastError("Cannot map " + m_path);
+		Close();
+		throw error;
+	}
+
+	m_data = static_cast<char *>(data);
+}
+
+void memory_mapped_file::Close()
+{
+	if (m_data)
+		munmap(m_data, m_size);
+	if (m_file >= 0)
+		close(m_file);
+
+	m_data = nullptr;
+	m_file = -1;
+	m_size = 0;
+}
+
+void memory_mapped_file::AdviseSequential()
+{
+	if (m_data)
+		madvise(m_data, m_size, MADV_SEQUENTIAL); // only a hint, a failure changes nothing
+}
+
+void memory_mapped_file::Prefetch(size_t offset, size_t length)
+{
+	if (PageRange(offset, length))
+		madvise(m_data + offset, length, MADV_WILLNEED);
+}
+
+void memory_mapped_file::Release(size_t offset, size_t length)
+{ // the pages of a shared mapping stay in the page cache, so nothing written is lost
+	if (PageRange(offset, length))
+		madvise(m_data + offset, length, MADV_DONTNEED);
+}
+
+void memory_mapped_file::Flush()
+{
+	if (m_data && msync(m_data, m_size, MS_SYNC) != 0)
+		throw LastError("Cannot write back " + m_path);
+}
+
+#endif
+
+bool memory_mapped_file::PageRange(size_t & offset, size_t & length) const
+{
+	if (!m_data || offset >= m_size)
+		return false;
+
+	const size_t page = PageSize();
+	size_t end = offset + std::min(length, m_size - offset);
+
+	offset -= offset % page;
+	length = end - offset;
+
+	return length > 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+// A file mapped into memory for reading and writing, e.g. to keep a state vector larger than the RAM on a
+// local disk. The pages are loaded when they are first touched and written back by the operating system.
+// The hints tell it that the mapping is read in order, which part comes next and which part is done with.
+class memory_mapped_file
+{
+public:
+	memory_mapped_file() = default;
+	memory_mapped_file(const std::string & path, size_t size); // a new file of size zero bytes, replacing an existing one
+	explicit memory_mapped_file(const std::string & path, bool writable = true); // maps an existing file as it is; do not write to Data() unless writable
+	~memory_mapped_file();
+
+	memory_mapped_file(const memory_mapped_file &) = delete;
+	memory_mapped_file & operator=(const memory_mapped_file &) = delete;
+	memory_mapped_file(memory_mapped_file && other) noexcept;
+	memory_mapped_file & operator=(memory_mapped_file && other) noexcept;
+
+	char * Data() const { return m_data; }
+	size_t Size() const { return m_size; }
+	const std::string & Path() const { return m_path; }
+
+	void AdviseSequential(); // the whole mapping will be read in order, so read ahead aggressively
+	void Prefetch(size_t offset, size_t length); // these bytes are needed soon, start reading them
+	void Release(size_t offset, size_t length); // these bytes are not needed for a while, the pages can go
+	void Flush(); // writes the changed pages back, and waits for it
+
+	static size_t PageSize();
+
+protected:
+	void Open(bool create, size_t size, bool writable);
+	void Close();
+	bool PageRange(size_t & offset, size_t & length) const; // rounds the range out to whole pages inside the mapping
+
+	std::string m_path;
+	char * m_data = nullptr;
+	size_t m_size = 0;
+
+#ifdef _WIN32
+	void * m_file = nullptr; // HANDLE
+	void * m_mapping = nullptr; // HANDLE
+#else
+	int m_file = -1;
+#endif
+};
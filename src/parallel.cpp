@@ -0,0 +1,209 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+	thread_local bool insideChunk = false; // set while a thread runs a chunk, nested For calls then run serially
+
+	// Workers sleep until a job is posted, then every thread (the caller included) takes chunks
+	// from the job's counter until none are left, so uneven chunks balance out.
+	class ThreadPool
+	{
+	public:
+		explicit ThreadPool(size_t threadCount)
+		{
+			for (size_t i = 1; i < threadCount; i++)
+				m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+
+		~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stop = true;
+			}
+
+			m_wake.notify_all();
+
+			for (auto & worker : m_workers)
+				worker.join();
+		}
+
+		size_t ThreadCount() const { return m_workers.size() + 1; }
+
+		// runs body(0) ... body(chunkCount - 1) on the pool, one job at a time
+		void Run(size_t chunkCount, const std::function<void(size_t)> & body)
+		{
+			std::lock_guard<std::mutex> jobLock(m_jobMutex);
+
+			auto job = std::make_shared<Job>(body, chunkCount);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_job = job;
+			}
+
+			m_wake.notify_all();
+
+			TakeChunks(*job);
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_done.wait(lock, [&] { return job->m_pendingChunks == 0; });
+			m_job.reset(); // workers that wake up late find no job, or hold their own reference to this one
+
+			if (job->m_exception)
+				std::rethrow_exception(job->m_exception);
+		}
+
+	private:
+		struct Job
+		{
+			Job(const std::function<void(size_t)> & body, size_t chunkCount) : m_body(body), m_chunkCount(chunkCount), m_pendingChunks(chunkCount) {}
+
+			const std::function<void(size_t)> & m_body; // only called for a chunk still pending, so the caller is still waiting
+			const size_t m_chunkCount;
+			std::atomic<size_t> m_nextChunk{ 0 }, m_pendingChunks;
+			std::exception_ptr m_exception;
+		};
+
+		void WorkerLoop()
+		{
+			std::shared_ptr<Job> last;
+
+			for (;;)
+			{
+				std::shared_ptr<Job> job;
+
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_wake.wait(lock, [&] { return m_stop || (m_job && m_job != last); });
+
+					if (m_stop)
+						return;
+
+					job = m_job;
+				}
+
+				TakeChunks(*job);
+				last = job;
+			}
+		}
+
+		void TakeChunks(Job & job)
+		{
+			insideChunk = true;
+
+			for (size_t chunk = job.m_nextChunk++; chunk < job.m_chunkCount; chunk = job.m_nextChunk++)
+			{
+				try
+				{
+					job.m_body(chunk);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					if (!job.m_exception)
+						job.m_exception = std::current_exception();
+				}
+
+				if (--job.m_pendingChunks == 0)
+				{
+					std::lock_guard<std::mutex> lock(m_mutex); // the caller checks m_pendingChunks under the lock
+					m_done.notify_all();
+				}
+			}
+
+			insideChunk = false;
+		}
+
+		std::vector<std::thread> m_workers;
+
+		std::mutex m_jobMutex; // held by the thread that posted the current job
+		std::mutex m_mutex;
+		std::condition_variable m_wake, m_done;
+		bool m_stop = false;
+		std::shared_ptr<Job> m_job;
+	};
+
+	std::mutex poolMutex; // guards the creation and replacement of the pool
+	std::shared_ptr<ThreadPool> pool;
+	size_t requestedThreads = 0;
+
+	std::shared_ptr<ThreadPool> Pool()
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+
+		if (!pool)
+			pool = std::make_shared<ThreadPool>(requestedThreads ? requestedThreads : std::max<size_t>(1, std::thread::hardware_concurrency()));
+
+		return pool;
+	}
+}
+
+size_t Parallel::ThreadCount()
+{
+	return Pool()->ThreadCount();
+}
+
+void Parallel::SetThreadCount(size_t count)
+{
+	std::shared_ptr<ThreadPool> old;
+
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		requestedThreads = count;
+		old.swap(pool); // the next call creates the new pool; For calls still running keep the old one alive
+	}
+}
+
+size_t Parallel::ChunkSize(size_t count, size_t minChunk, size_t granularity /*= 1*/)
+{
+	granularity = std::max<size_t>(1, granularity);
+
+	size_t chunks = std::min(ThreadCount(), std::max<size_t>(1, count / std::max<size_t>(1, minChunk)));
+	size_t chunkSize = (count + chunks - 1) / chunks;
+
+	return (chunkSize + granularity - 1) / granularity * granularity;
+}
+
+void Parallel::For(size_t begin, size_t end, size_t minChunk, const std::function<void(size_t, size_t)> & body, size_t granularity /*= 1*/)
+{
+	if (end > begin)
+		ForChunks(begin, end, ChunkSize(end - begin, minChunk, granularity), body);
+}
+
+void Parallel::ForChunks(size_t begin, size_t end, size_t chunkSize, const std::function<void(size_t, size_t)> & body)
+{
+	if (end <= begin)
+		return;
+
+	chunkSize = std::max<size_t>(1, chunkSize);
+	size_t chunks = (end - begin + chunkSize - 1) / chunkSize;
+
+	if (chunks == 1)
+	{
+		body(begin, end);
+		return;
+	}
+
+	if (insideChunk) // a nested call, the pool is busy with the outer one
+	{
+		for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += chunkSize)
+			body(chunkBegin, std::min(chunkBegin + chunkSize, end));
+
+		return;
+	}
+
+	Pool()->Run(chunks, [&](size_t chunk)
+	{
+		size_t chunkBegin = begin + chunk * chunkSize;
+		body(chunkBegin, std::min(chunkBegin + chunkSize, end));
+	});
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Data-parallel loops on a pool of worker threads that is created once and reused by every call.
+namespace Parallel
+{
+	const size_t MIN_ELEMENTS_PER_THREAD = 1 << 15; // for streaming passes over vectors, below this threads cost more than they save
+
+	size_t ThreadCount(); // number of threads used for parallel work (the calling thread included), at least 1
+	void SetThreadCount(size_t count); // 0 selects the number of hardware threads, 1 runs everything on the calling thread
+
+	// size of the chunks For splits count items into: at least minChunk and a multiple of granularity
+	size_t ChunkSize(size_t count, size_t minChunk, size_t granularity = 1);
+
+	// Splits [begin, end) into contiguous chunks of ChunkSize(end - begin, minChunk, granularity) items (the last one
+	// can be smaller) and calls body(chunkBegin, chunkEnd) for each of them on the pool; returns when all chunks are
+	// done and rethrows the first exception a chunk threw. Small ranges, and calls made from inside a chunk, run on
+	// the calling thread.
+	void For(size_t begin, size_t end, size_t minChunk, const std::function<void(size_t, size_t)> & body, size_t granularity = 1);
+	void ForChunks(size_t begin, size_t end, size_t chunkSize, const std::function<void(size_t, size_t)> & body); // For with the chunk size given
+
+	// For with every chunk returning a value, which are combined in chunk order, so the result does not depend on timing
+	template <class R, class F, class C> R Reduce(size_t begin, size_t end, size_t minChunk, R init, F body, C combine)
+	{
+		if (end <= begin)
+			return init;
+
+		const size_t chunkSize = ChunkSize(end - begin, minChunk);
+		std::vector<R> partials((end - begin + chunkSize - 1) / chunkSize, init);
+
+		ForChunks(begin, end, chunkSize, [&](size_t chunkBegin, size_t chunkEnd)
+		{
+			partials[(chunkBegin - begin) / chunkSize] = body(chunkBegin, chunkEnd);
+		});
+
+		R result = init;
+		for (const auto & partial : partials)
+			result = combine(result, partial);
+
+		return result;
+	}
+}
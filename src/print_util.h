@@ -4,36 +4,29 @@
 
 #include "cvector.h"
 #include "cmatrix.h"
+#include "complex_writer.h"
 
 namespace PrintUtil
 {
+  // both stream the elements through a complex_writer, without building the strings of the whole matrix first
+
   template <typename T> void PrintMatrixToConsole(const complex_matrix<T> & matrix, const char * title = nullptr)
   {
+    complex_writer writer(std::cout);
+
     if (title)
-      std::cout << title << "\n";
-
-    std::vector<std::vector<std::string>> dbg = matrix.ToStringListList();
-    for (auto row : dbg)
-    {
-      for (auto value : row)
-      {
-        std::cout << value << " ";
-      }
-      std::cout << "\n";
-    }
+      writer.Write(title).Write("\n");
+
+    writer.Write(matrix);
   }
 
-  template <typename T> void PrintVectorToConsole(const complex_vector<T> & vector, const char * title = nullptr) // TBD: duplicate code with cvectorTest, put elsewhere
+  template <typename T> void PrintVectorToConsole(const complex_vector<T> & vector, const char * title = nullptr)
   {
+    complex_writer writer(std::cout);
+
     if (title)
-      std::cout << title << "\n";
-
-    std::vector<std::string> dbg = vector.ToStringList();
-    for (auto value : dbg)
-    {
-      std::cout << value << " ";
-    }
-    std::cout << "\n";
+      writer.Write(title).Write("\n");
+
+    writer.Write(vector);
   }
 }
-
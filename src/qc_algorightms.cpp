@@ -1,6 +1,14 @@
 #include "qc_algorithms.h"
 #include "matrix_constants.h"
-
+#include "complex_kernels.h"
+#include "parallel.h"
+#include "state_vector.h"
+#include "grover.h"
+#include "measurement_sampler.h"
+#include "fft.h"
+#include "shor.h"
+
+#include <algorithm>
 #include <random>
 
 cdouble_vector QC_Algorithms::BraFromKet(const cdouble_vector & ket)
@@ -18,38 +26,88 @@ double QC_Algorithms::ObservationProbability(const cdouble_vector & state, size_
 	return state[position].ModulusSquared() / state.NormSquare().Real();
 }
 
-static bool parity(size_t n) // from https://www.geeksforgeeks.org/write-a-c-program-to-find-the-parity-of-an-unsigned-integer/
+namespace
 {
-	bool parity = 0;
+	const size_t WALSH_HADAMARD_BLOCK = 1 << 10; // amplitudes transformed together while in cache, before the strides that span blocks
 
-	while (n)
-	{
-		parity = !parity;
-		n = n & (n - 1);
+	void WalshHadamardPass(cdouble * data, size_t stride, size_t pairBegin, size_t pairEnd)
+	{ // the butterflies of one stride for the pairs [pairBegin, pairEnd), numbered as in StateVector::PairIndex
+		if (stride < 4) // runs too short for the vectorized kernel
+		{
+			for (size_t pair = pairBegin; pair < pairEnd; pair++)
+			{
+				size_t i = StateVector::PairIndex(pair, stride);
+				ComplexKernels::Butterfly(data + i, data + i + stride, 1);
+			}
+
+			return;
+		}
+
+		for (size_t pair = pairBegin; pair < pairEnd; )
+		{
+			size_t runEnd = std::min(pairEnd, (pair / stride + 1) * stride);
+			cdouble * a = data + StateVector::PairIndex(pair, stride);
+
+			ComplexKernels::Butterfly(a, a + stride, runEnd - pair);
+
+			pair = runEnd;
+		}
 	}
-	return parity;
 }
 
 cdouble_matrix QC_Algorithms::HadamardMatrix(size_t order)
-{
+{ // Sylvester's construction: H(k+1) is [ H(k) H(k) ; H(k) -H(k) ], so the sign of element (i, j) is the parity of i & j, see pages 181-184
 	if (order == 0)
 		throw std::out_of_range("Hadamard matrix order must be at least 1");
 
-	size_t size = 1 << order;
+	size_t size = size_t(1) << order;
 
 	cdouble_matrix result(size, size);
+	result[0][0] = cdouble(1 / sqrt(double(size)));
+
+	for (size_t block = 1; block < size; block *= 2)
+		for (size_t i = 0; i < block; i++)
+			for (size_t j = 0; j < block; j++)
+			{
+				const cdouble & value = result[i][j];
+
+				result[i][j + block] = value;
+				result[i + block][j] = value;
+				result[i + block][j + block] = -value;
+			}
+
+	return result;
+}
+
+void QC_Algorithms::WalshHadamardTransform(cdouble_vector & state)
+{ // the strides within a block are done block by block in cache, then every larger stride is one pass over the vector
+	const size_t n = state.size();
+	StateVector::QubitCount(state); // throws if n is not a power of 2
 
-	double coefficient = 1 / sqrt(1 << (order));
+	const size_t block = std::min(n, WALSH_HADAMARD_BLOCK);
+	const cdouble coefficient(1 / sqrt(double(n)));
+	cdouble * data = state.data();
 
-	for (size_t i=0; i<size; i++)
-		for (size_t j = 0; j < size; j++)
+	Parallel::For(0, n / block, std::max<size_t>(1, 2 * StateVector::MIN_PAIRS_PER_THREAD / block), [&](size_t blockBegin, size_t blockEnd)
+	{
+		for (size_t b = blockBegin; b < blockEnd; b++)
 		{
-			double multiplier = parity(i & j) ? -1 : 1; // see pages 181-184
+			cdouble * p = data + b * block;
+
+			for (size_t stride = 1; stride < block; stride *= 2)
+				WalshHadamardPass(p, stride, 0, block / 2);
 
-			result[i][j] = coefficient * multiplier;
+			ComplexKernels::Scale(coefficient, p, p, block); // the normalization, while the block is still in cache
 		}
+	});
 
-	return result;
+	for (size_t stride = block; stride < n; stride *= 2)
+	{
+		Parallel::For(0, n / 2, StateVector::MIN_PAIRS_PER_THREAD, [&](size_t pairBegin, size_t pairEnd)
+		{
+			WalshHadamardPass(data, stride, pairBegin, pairEnd);
+		}, StateVector::CHUNK_GRANULARITY);
+	}
 }
 
 cdouble_matrix QC_Algorithms::AveragerMatrix(size_t size)
@@ -58,10 +116,11 @@ cdouble_matrix QC_Algorithms::AveragerMatrix(size_t size)
 }
 
 cdouble_vector QC_Algorithms::InverseAboutMean(const cdouble_vector & vector)
-{
-	cdouble_matrix A = AveragerMatrix(vector.size());
+{ // -V + 2AV, but A * V is the mean in every element, so the averager matrix is not needed, see page 198
+	cdouble_vector result(vector);
+	Grover::InverseAboutMean(result);
 
-	return -vector + 2 * A * vector;
+	return result;
 }
 
 cdouble_matrix QC_Algorithms::FillWithBinaryVectorsInOrder(size_t n) // eg. "000", "001", "010", "011", "100" etc if n == 3
@@ -93,48 +152,38 @@ cdouble_vector QC_Algorithms::CreateQubitStateVectorAndInitializeToZero(size_t n
 }
 
 size_t QC_Algorithms::Measure(const cdouble_vector & state)
-{
-	std::vector<double> probabilities = MeasurementProbabilitiesVector(state);
-
-	size_t n = probabilities.size(); // same as state.size()
-	std::vector<double> lowerBounds(n), upperBounds(n);
+{ // a single shot needs no alias table; for many measurements of the same state, keep a sampler instead
+	return measurement_sampler::SampleOnce(state);
+}
 
-	double boundary = 0.0;
-	for (size_t i = 0; i < n; i++)
-	{
-		lowerBounds[i] = boundary;
-		boundary += probabilities[i];
-		upperBounds[i] = boundary;
-	}
+std::vector<double> QC_Algorithms::MeasurementProbabilitiesVector(const cdouble_vector & state)
+{
+	size_t n = state.size();
+	std::vector<double> result(n);
 
-	double r = RandomNumber();
+	const cdouble * amplitudes = state.data();
+	double * probabilities = result.data();
 
-	for (size_t i = 0; i < n; i++)
+	Parallel::For(0, n, Parallel::MIN_ELEMENTS_PER_THREAD, [&](size_t begin, size_t end)
 	{
-		if (r >= lowerBounds[i] && r <= upperBounds[i])
-			return i;
-	}
-
-	// Should never end up here, but in case we have some rounding error this can be possible;
-	// in this case return the measurement with the highest probability.
+		ComplexKernels::ModulusSquared(amplitudes + begin, probabilities + begin, end - begin);
+	});
 
-	size_t maxIndex = 0;
-	for (size_t i = 1; i < n; i++)
-		if (probabilities[i] > probabilities[maxIndex])
-			maxIndex = i;
-
-	return maxIndex;
+	return result;
 }
 
-std::vector<double> QC_Algorithms::MeasurementProbabilitiesVector(const cdouble_vector & state)
+std::vector<double> QC_Algorithms::MeasurementProbabilitiesVector(const cfloat_vector & state)
 {
 	size_t n = state.size();
 	std::vector<double> result(n);
 
-	for (int i = 0; i < n; i++)
+	const cfloat * amplitudes = state.data();
+	double * probabilities = result.data();
+
+	Parallel::For(0, n, Parallel::MIN_ELEMENTS_PER_THREAD, [&](size_t begin, size_t end)
 	{
-		result[i] = state[i].ModulusSquared();
-	}
+		ComplexKernels::ModulusSquared(amplitudes + begin, probabilities + begin, end - begin);
+	});
 
 	return result;
 }
@@ -149,13 +198,50 @@ double QC_Algorithms::RandomNumber()
 }
 
 cint_vector QC_Algorithms::PowersOfModulo(int a, int N, size_t count)
-{
+{ // exact integer arithmetic, see Shor::ModularPowers; pow() loses digits beyond 2^53
+	if (N <= 0)
+		throw std::out_of_range("The modulus must be positive");
+
 	cint_vector result;
+	result.reserve(count);
+
+	for (uint64_t value : Shor::ModularPowers(uint64_t((a % N + N) % N), uint64_t(N), count))
+		result.push_back(cint(static_cast<int>(value)));
+
+	return result;
+}
+
+void QC_Algorithms::QuantumFourierTransform(cdouble_vector & state)
+{
+	FFT::Transform(state, FFT::BACKWARD, 1 / sqrt(double(state.size())));
+}
+
+void QC_Algorithms::InverseQuantumFourierTransform(cdouble_vector & state)
+{
+	FFT::Transform(state, FFT::FORWARD, 1 / sqrt(double(state.size())));
+}
 
-	for (size_t x = 0; x < count; x++)
+cdouble_quantum_circuit QC_Algorithms::QuantumFourierTransformCircuit(size_t qubitCount)
+{ // qubit 0 is the most significant bit, so it gets the H and the finest rotations first
+	const double pi = 3.14159265358979323846;
+
+	cdouble_quantum_circuit result(qubitCount);
+
+	for (size_t target = 0; target < qubitCount; target++)
 	{
-		result.push_back(std::llround(pow(a, x)) % N);
+		result.AddGate(MatrixConstants::HADAMARD, target);
+
+		for (size_t control = target + 1; control < qubitCount; control++)
+		{
+			cdouble phase;
+			phase.FromPolar(1, 2 * pi / double(size_t(1) << (control - target + 1))); // R_k with k = control - target + 1
+
+			result.AddControlledGate(cdouble_matrix({ { 1, 0 }, { 0, phase } }), { control }, target);
+		}
 	}
 
+	for (size_t qubit = 0; qubit < qubitCount / 2; qubit++)
+		result.AddSwap(qubit, qubitCount - 1 - qubit);
+
 	return result;
 }
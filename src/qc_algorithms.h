@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cmatrix.h"
+#include "quantum_circuit.h"
 
 namespace QC_Algorithms
 {
@@ -10,6 +11,7 @@ namespace QC_Algorithms
 	double ObservationProbability(const cdouble_vector & state, size_t position);
 
 	cdouble_matrix HadamardMatrix(size_t order);
+	void WalshHadamardTransform(cdouble_vector & state); // state = HadamardMatrix(n) * state in place, in O(n 2^n) without the matrix
 	cdouble_matrix AveragerMatrix(size_t size);
 
 	cdouble_vector InverseAboutMean(const cdouble_vector & vector);
@@ -17,9 +19,17 @@ namespace QC_Algorithms
 	cdouble_matrix FillWithBinaryVectorsInOrder(size_t n);
 	cdouble_vector CreateQubitStateVectorAndInitializeToZero(size_t numberOfQubits);
 
-	size_t Measure(const cdouble_vector & state); // returns the index of the state that got measured (random operation)
+	size_t Measure(const cdouble_vector & state); // returns the index of the state that got measured (random operation), see measurement_sampler for many shots
 	std::vector<double> MeasurementProbabilitiesVector(const cdouble_vector & state);
+	std::vector<double> MeasurementProbabilitiesVector(const cfloat_vector & state); // computed in double
 	double RandomNumber(); // between 0 and 1
 
 	cint_vector PowersOfModulo(int a, int N, size_t count); // 6.5, page 206
+
+	// QFT|x> = 1/sqrt(N) sum over y of exp(2 pi i x y / N) |y>, computed in place with an FFT in O(N log N)
+	void QuantumFourierTransform(cdouble_vector & state);
+	void InverseQuantumFourierTransform(cdouble_vector & state);
+
+	// the same transform as gates: H and controlled phase rotations on every qubit, then the swaps that reverse their order
+	cdouble_quantum_circuit QuantumFourierTransformCircuit(size_t qubitCount);
 }
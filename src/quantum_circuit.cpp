@@ -0,0 +1,214 @@
+#include "quantum_circuit.h"
+#include "state_vector.h"
+
+#include <algorithm>
+
+template <class T> quantum_circuit<T> & quantum_circuit<T>::AddGate(const complex_matrix<T> & gate, size_t qubit)
+{
+	return AddGate(gate, std::vector<size_t>({ qubit }));
+}
+
+template <class T> quantum_circuit<T> & quantum_circuit<T>::AddGate(const complex_matrix<T> & gate, const std::vector<size_t> & qubits)
+{
+	for (size_t i = 0; i < qubits.size(); i++)
+	{
+		if (qubits[i] >= m_qubitCount)
+			throw std::out_of_range("Qubit index out of range");
+
+		if (std::find(qubits.begin(), qubits.begin() + i, qubits[i]) != qubits.begin() + i)
+			throw std::invalid_argument("The qubits of a gate must be different");
+	}
+
+	size_t n = size_t(1) << qubits.size();
+
+	if (gate.Rows() != n)
+		throw std::out_of_range("The gate size does not match the number of qubits");
+
+	for (const auto & row : gate)
+		if (row.size() != n)
+			throw std::out_of_range("The gate size does not match the number of qubits");
+
+	Gate g;
+	g.m_matrix = gate;
+	g.m_qubits = qubits;
+
+	m_gates.push_back(g);
+	return *this;
+}
+
+template <class T> quantum_circuit<T> & quantum_circuit<T>::AddControlledGate(const complex_matrix<T> & gate, const std::vector<size_t> & controls, size_t target)
+{ // the controls are the most significant bits, so the gate is the bottom right block of an identity
+	std::vector<size_t> qubits(controls);
+	qubits.push_back(target);
+
+	size_t n = size_t(1) << qubits.size();
+
+	if (gate.Rows() != 2 || gate[0].size() != 2 || gate[1].size() != 2)
+		throw std::out_of_range("A controlled gate must be a 2x2 matrix");
+
+	complex_matrix<T> controlled = complex_matrix<T>::CreateIdentityMatrix(n);
+
+	for (size_t i = 0; i < 2; i++)
+		for (size_t j = 0; j < 2; j++)
+			controlled[n - 2 + i][n - 2 + j] = gate[i][j];
+
+	return AddGate(controlled, qubits);
+}
+
+template <class T> quantum_circuit<T> & quantum_circuit<T>::AddCNOT(size_t control, size_t target)
+{
+	return AddControlledGate(complex_matrix<T>({ { T(0), T(1) }, { T(1), T(0) } }), { control }, target);
+}
+
+template <class T> quantum_circuit<T> & quantum_circuit<T>::AddToffoli(size_t control1, size_t control2, size_t target)
+{
+	return AddControlledGate(complex_matrix<T>({ { T(0), T(1) }, { T(1), T(0) } }), { control1, control2 }, target);
+}
+
+template <class T> quantum_circuit<T> & quantum_circuit<T>::AddCZ(size_t qubit1, size_t qubit2)
+{
+	return AddControlledGate(complex_matrix<T>({ { T(1), T(0) }, { T(0), T(-1) } }), { qubit1 }, qubit2);
+}
+
+template <class T> quantum_circuit<T> & quantum_circuit<T>::AddSwap(size_t qubit1, size_t qubit2)
+{
+	complex_matrix<T> swap(4, 4);
+	swap[0][0] = swap[1][2] = swap[2][1] = swap[3][3] = T(1);
+
+	return AddGate(swap, { qubit1, qubit2 });
+}
+
+template <class T> quantum_circuit<T> quantum_circuit<T>::Fuse(size_t maxWidth /*= DEFAULT_FUSION_WIDTH*/) const
+{ // greedy: a gate joins the current block while their qubits together stay within maxWidth
+	quantum_circuit<T> result(m_qubitCount);
+
+	if (m_gates.empty())
+		return result;
+
+	Gate block = m_gates[0];
+
+	for (size_t i = 1; i < m_gates.size(); i++)
+	{
+		const Gate & gate = m_gates[i];
+
+		std::vector<size_t> qubits(block.m_qubits);
+		for (size_t qubit : gate.m_qubits)
+			if (std::find(qubits.begin(), qubits.end(), qubit) == qubits.end())
+				qubits.push_back(qubit);
+
+		if (qubits.size() <= maxWidth)
+		{
+			block.m_matrix = ExpandGate(gate.m_matrix, gate.m_qubits, qubits) * ExpandGate(block.m_matrix, block.m_qubits, qubits);
+			block.m_qubits = qubits;
+		}
+		else
+		{
+			result.m_gates.push_back(block);
+			block = gate;
+		}
+	}
+
+	result.m_gates.push_back(block);
+
+	return result;
+}
+
+template <class T> void quantum_circuit<T>::Run(complex_vector<T> & state) const
+{
+	if (StateVector::QubitCount(state) != m_qubitCount)
+		throw std::out_of_range("The state vector does not match the number of qubits of the circuit");
+
+	for (const auto & gate : m_gates)
+	{
+		if (gate.m_qubits.size() == 1)
+			StateVector::ApplyGate(state, gate.m_matrix, gate.m_qubits[0]); // the strided butterfly is faster than the general kernel
+		else
+			StateVector::ApplyMultiQubitGate(state, gate.m_matrix, gate.m_qubits);
+	}
+}
+
+template <class T> complex_matrix<T> quantum_circuit<T>::ToMatrix() const
+{
+	std::vector<size_t> allQubits(m_qubitCount);
+	for (size_t i = 0; i < m_qubitCount; i++)
+		allQubits[i] = i;
+
+	complex_matrix<T> result = complex_matrix<T>::CreateIdentityMatrix(size_t(1) << m_qubitCount);
+
+	for (const auto & gate : m_gates)
+		result = ExpandGate(gate.m_matrix, gate.m_qubits, allQubits) * result;
+
+	return result;
+}
+
+template <class T> complex_matrix<T> quantum_circuit<T>::ExpandGate(const complex_matrix<T> & gate, const std::vector<size_t> & qubits, const std::vector<size_t> & allQubits)
+{
+	const size_t k = qubits.size(), count = allQubits.size(), n = size_t(1) << count;
+
+	std::vector<size_t> bits(k); // bit of every gate qubit in the index over allQubits
+	size_t gateMask = 0;
+
+	for (size_t j = 0; j < k; j++)
+	{
+		auto position = std::find(allQubits.begin(), allQubits.end(), qubits[j]);
+
+		if (position == allQubits.end())
+			throw std::invalid_argument("The qubits of the gate must be a subset of the qubits to expand to");
+
+		bits[j] = size_t(1) << (count - 1 - (position - allQubits.begin()));
+		gateMask |= bits[j];
+	}
+
+	auto gateIndex = [&](size_t index)
+	{
+		size_t result = 0;
+		for (size_t bit : bits)
+			result = (result << 1) | ((index & bit) ? 1 : 0);
+
+		return result;
+	};
+
+	complex_matrix<T> result(n, n);
+
+	for (size_t r = 0; r < n; r++)
+		for (size_t c = 0; c < n; c++)
+			if (((r ^ c) & ~gateMask) == 0) // the other qubits are left alone
+				result[r][c] = gate[gateIndex(r)][gateIndex(c)];
+
+	return result;
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		cint_quantum_circuit ci(1);
+		cdouble_quantum_circuit cd(1);
+
+		ci.AddGate(cint_matrix(), 0);
+		cd.AddGate(cdouble_matrix(), 0);
+		ci.AddControlledGate(cint_matrix(), {}, 0);
+		cd.AddControlledGate(cdouble_matrix(), {}, 0);
+
+		ci.AddCNOT(0, 0);
+		cd.AddCNOT(0, 0);
+		ci.AddToffoli(0, 0, 0);
+		cd.AddToffoli(0, 0, 0);
+		ci.AddCZ(0, 0);
+		cd.AddCZ(0, 0);
+		ci.AddSwap(0, 0);
+		cd.AddSwap(0, 0);
+
+		ci.Fuse();
+		cd.Fuse();
+
+		cint_vector vi;
+		cdouble_vector vd;
+		ci.Run(vi);
+		cd.Run(vd);
+
+		ci.ToMatrix();
+		cd.ToMatrix();
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "cmatrix.h"
+
+// A sequence of gates on the qubits of a register, applied to a state vector with the StateVector kernels.
+// Fuse() merges runs of adjacent gates acting on at most maxWidth qubits together into one dense gate,
+// so a deep circuit sweeps the state vector far fewer times. Qubit numbering is the one of StateVector:
+// qubit 0 is the most significant bit of the basis state index.
+template <class T> class quantum_circuit
+{
+public:
+	struct Gate
+	{
+		complex_matrix<T> m_matrix; // 2^k x 2^k
+		std::vector<size_t> m_qubits; // k qubits, the first one is the most significant bit of the matrix index
+	};
+
+	static const size_t DEFAULT_FUSION_WIDTH = 3; // 8x8 gates, larger ones cost more per amplitude than the sweeps they save
+
+	explicit quantum_circuit(size_t qubitCount) : m_qubitCount(qubitCount) {}
+
+	size_t QubitCount() const { return m_qubitCount; }
+	size_t GateCount() const { return m_gates.size(); }
+	const std::vector<Gate> & Gates() const { return m_gates; }
+
+	quantum_circuit & AddGate(const complex_matrix<T> & gate, size_t qubit);
+	quantum_circuit & AddGate(const complex_matrix<T> & gate, const std::vector<size_t> & qubits);
+	quantum_circuit & AddControlledGate(const complex_matrix<T> & gate, const std::vector<size_t> & controls, size_t target);
+
+	quantum_circuit & AddCNOT(size_t control, size_t target);
+	quantum_circuit & AddToffoli(size_t control1, size_t control2, size_t target);
+	quantum_circuit & AddCZ(size_t qubit1, size_t qubit2);
+	quantum_circuit & AddSwap(size_t qubit1, size_t qubit2);
+
+	quantum_circuit Fuse(size_t maxWidth = DEFAULT_FUSION_WIDTH) const;
+
+	void Run(complex_vector<T> & state) const;
+
+	complex_matrix<T> ToMatrix() const; // the whole circuit as one operator, only meant for small circuits and checks
+
+	// gate, acting on qubits, as the equivalent gate on allQubits (a superset of qubits, in the order given)
+	static complex_matrix<T> ExpandGate(const complex_matrix<T> & gate, const std::vector<size_t> & qubits, const std::vector<size_t> & allQubits);
+
+protected:
+	size_t m_qubitCount;
+	std::vector<Gate> m_gates;
+};
+
+
+typedef quantum_circuit<cint> cint_quantum_circuit;
+typedef quantum_circuit<cdouble> cdouble_quantum_circuit;
@@ -0,0 +1,297 @@
+#include "shor.h"
+#include "parallel.h"
+#include "qc_algorithms.h"
+#include "measurement_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+	void CheckModulus(uint64_t modulus)
+	{
+		if (modulus == 0 || modulus >= (uint64_t(1) << 32))
+			throw std::out_of_range("The modulus must be between 1 and 2^32, so that products fit in 64 bits");
+	}
+
+	uint64_t LeastCommonMultiple(uint64_t a, uint64_t b)
+	{
+		return a / Shor::GreatestCommonDivisor(a, b) * b;
+	}
+
+	uint64_t SmallestOrder(uint64_t base, uint64_t modulus, uint64_t multiple)
+	{ // base^multiple = 1, so the order divides multiple: drop every prime factor that is not needed
+		uint64_t result = multiple, rest = multiple;
+
+		for (uint64_t p = 2; p * p <= rest; p++)
+		{
+			if (rest % p != 0)
+				continue;
+
+			while (rest % p == 0)
+				rest /= p;
+
+			while (result % p == 0 && Shor::ModularPower(base, result / p, modulus) == 1)
+				result /= p;
+		}
+
+		if (rest > 1 && Shor::ModularPower(base, result / rest, modulus) == 1)
+			result /= rest;
+
+		return result;
+	}
+
+	std::mt19937_64 IndexedGenerator(uint64_t seed, size_t index)
+	{
+		std::seed_seq sequence({ uint32_t(seed), uint32_t(seed >> 32), uint32_t(index), uint32_t(uint64_t(index) >> 32) });
+		return std::mt19937_64(sequence);
+	}
+}
+
+uint64_t Shor::ModularPower(uint64_t base, uint64_t exponent, uint64_t modulus)
+{
+	CheckModulus(modulus);
+
+	uint64_t result = 1 % modulus;
+	base %= modulus;
+
+	for (; exponent; exponent >>= 1)
+	{
+		if (exponent & 1)
+			result = result * base % modulus;
+
+		base = base * base % modulus;
+	}
+
+	return result;
+}
+
+std::vector<uint64_t> Shor::ModularPowers(uint64_t base, uint64_t modulus, size_t count)
+{ // every chunk starts from its own power, then multiplies its way up
+	CheckModulus(modulus);
+	base %= modulus;
+
+	std::vector<uint64_t> result(count);
+
+	Parallel::For(0, count, Parallel::MIN_ELEMENTS_PER_THREAD, [&](size_t begin, size_t end)
+	{
+		uint64_t value = ModularPower(base, begin, modulus);
+
+		for (size_t x = begin; x < end; x++)
+		{
+			result[x] = value;
+			value = value * base % modulus;
+		}
+	});
+
+	return result;
+}
+
+uint64_t Shor::GreatestCommonDivisor(uint64_t a, uint64_t b)
+{
+	while (b)
+	{
+		uint64_t rest = a % b;
+		a = b;
+		b = rest;
+	}
+
+	return a;
+}
+
+std::vector<uint64_t> Shor::ConvergentDenominators(uint64_t numerator, uint64_t denominator)
+{ // k(n) = a(n) k(n-1) + k(n-2), starting with k(-1) = 0 and k(-2) = 1
+	std::vector<uint64_t> result;
+	uint64_t previous = 0, beforePrevious = 1;
+
+	while (denominator)
+	{
+		uint64_t term = numerator / denominator, rest = numerator % denominator;
+		numerator = denominator;
+		denominator = rest;
+
+		uint64_t current = term * previous + beforePrevious;
+		beforePrevious = previous;
+		previous = current;
+
+		result.push_back(current);
+	}
+
+	return result;
+}
+
+size_t Shor::RegisterQubits(uint64_t modulus)
+{
+	size_t bits = 0;
+	while (bits < 64 && (uint64_t(1) << bits) < modulus)
+		bits++;
+
+	return std::min(std::max<size_t>(2 * bits, 1), MAX_REGISTER_QUBITS);
+}
+
+cdouble_vector Shor::PrepareRegister(uint64_t base, uint64_t modulus, size_t registerQubits, uint64_t target)
+{
+	CheckModulus(modulus);
+	base %= modulus;
+
+	cdouble_vector result(size_t(1) << registerQubits);
+	cdouble * data = result.data();
+
+	size_t count = Parallel::Reduce(size_t(0), result.size(), Parallel::MIN_ELEMENTS_PER_THREAD, size_t(0), [&](size_t begin, size_t end)
+	{
+		size_t matches = 0;
+		uint64_t value = ModularPower(base, begin, modulus);
+
+		for (size_t x = begin; x < end; x++)
+		{
+			if (value == target)
+			{
+				data[x] = cdouble(1);
+				matches++;
+			}
+
+			value = value * base % modulus;
+		}
+
+		return matches;
+	}, [](size_t a, size_t b) { return a + b; });
+
+	if (count == 0)
+		throw std::invalid_argument("The target is not a power of the base");
+
+	result.MultiplyWith(cdouble(1 / sqrt(double(count))));
+
+	return result;
+}
+
+uint64_t Shor::FindOrder(uint64_t base, uint64_t modulus, std::mt19937_64 & generator, size_t maxMeasurements /*= 10*/, size_t registerQubits /*= 0*/)
+{
+	CheckModulus(modulus);
+
+	if (GreatestCommonDivisor(base % modulus, modulus) != 1)
+		throw std::invalid_argument("The base must be coprime to the modulus");
+
+	if (registerQubits == 0)
+		registerQubits = RegisterQubits(modulus);
+
+	const uint64_t size = uint64_t(1) << registerQubits;
+	std::vector<uint64_t> earlier; // denominators of the earlier measurements, r / gcd(k, r) for the good ones
+
+	for (size_t measurement = 0; measurement < maxMeasurements; measurement++)
+	{
+		uint64_t x0 = std::uniform_int_distribution<uint64_t>(0, size - 1)(generator);
+
+		cdouble_vector state = PrepareRegister(base, modulus, registerQubits, ModularPower(base, x0, modulus));
+		QC_Algorithms::QuantumFourierTransform(state);
+
+		uint64_t y = measurement_sampler::SampleOnce(state, generator); // close to k 2^t / r for a random k
+		if (y == 0)
+			continue;
+
+		std::vector<uint64_t> denominators;
+
+		for (uint64_t d : ConvergentDenominators(y, size))
+		{
+			if (d > modulus)
+				break;
+
+			std::vector<uint64_t> candidates = { d };
+			for (uint64_t e : earlier)
+				candidates.push_back(LeastCommonMultiple(d, e)); // the orders lost to a common factor of k and r
+
+			for (uint64_t candidate : candidates)
+				if (candidate <= modulus && ModularPower(base, candidate, modulus) == 1)
+					return SmallestOrder(base, modulus, candidate);
+
+			denominators.push_back(d);
+		}
+
+		earlier.insert(earlier.end(), denominators.begin(), denominators.end());
+	}
+
+	return 0;
+}
+
+std::vector<uint64_t> Shor::FindOrders(const std::vector<uint64_t> & bases, uint64_t modulus, uint64_t seed, size_t maxMeasurements /*= 10*/, size_t registerQubits /*= 0*/)
+{ // one base per chunk; the QFT and the other passes inside run on the thread of their base
+	std::vector<uint64_t> result(bases.size());
+
+	Parallel::For(0, bases.size(), 1, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			std::mt19937_64 generator = IndexedGenerator(seed, i);
+			result[i] = FindOrder(bases[i], modulus, generator, maxMeasurements, registerQubits);
+		}
+	});
+
+	return result;
+}
+
+uint64_t Shor::Factor(uint64_t modulus, uint64_t seed, size_t maxBases /*= 64*/)
+{
+	CheckModulus(modulus);
+
+	if (modulus < 4)
+		return 0;
+
+	if (modulus % 2 == 0)
+		return 2;
+
+	for (size_t power = 2; (uint64_t(1) << power) <= modulus; power++) // the order of a prime power base does not help
+	{
+		uint64_t root = static_cast<uint64_t>(llround(pow(double(modulus), 1.0 / power)));
+
+		for (uint64_t candidate = std::max<uint64_t>(root, 2) - 1; candidate <= root + 1; candidate++)
+		{
+			uint64_t value = 1;
+			for (size_t i = 0; i < power && value <= modulus; i++)
+				value *= candidate;
+
+			if (value == modulus)
+				return candidate;
+		}
+	}
+
+	std::mt19937_64 generator(seed);
+	std::uniform_int_distribution<uint64_t> distribution(2, modulus - 2);
+
+	const size_t registerBytes = sizeof(cdouble) << RegisterQubits(modulus);
+	const size_t batch = std::max<size_t>(1, std::min(Parallel::ThreadCount(), MAX_BATCH_BYTES / registerBytes));
+
+	for (size_t tried = 0; tried < maxBases; )
+	{
+		std::vector<uint64_t> bases;
+
+		for (size_t i = 0; i < batch && tried < maxBases; i++, tried++)
+		{
+			uint64_t base = distribution(generator);
+			uint64_t divisor = GreatestCommonDivisor(base, modulus);
+
+			if (divisor > 1) // a lucky guess
+				return divisor;
+
+			bases.push_back(base);
+		}
+
+		std::vector<uint64_t> orders = FindOrders(bases, modulus, seed + tried);
+
+		for (size_t i = 0; i < bases.size(); i++)
+		{
+			if (orders[i] == 0 || orders[i] % 2 != 0)
+				continue;
+
+			uint64_t half = ModularPower(bases[i], orders[i] / 2, modulus); // a square root of 1 other than 1
+
+			if (half == modulus - 1)
+				continue;
+
+			for (uint64_t divisor : { GreatestCommonDivisor(half - 1, modulus), GreatestCommonDivisor(half + 1, modulus) })
+				if (divisor > 1 && divisor < modulus)
+					return divisor;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "cvector.h"
+
+#include <cstdint>
+#include <random>
+
+// Shor's algorithm, see section 6.5: the order r of a modulo N (the smallest r > 0 with a^r = 1 mod N) is read
+// from the QFT of the input register after the output register of f(x) = a^x mod N has been measured, and a
+// factor of N follows from gcd(a^(r/2) +- 1, N). Measuring the output register first leaves the input register
+// in the uniform superposition of the x with f(x) = f(x0), so only that register is simulated: 2^t amplitudes.
+//
+// The arithmetic is exact with 64-bit integers, so moduli are limited to N < 2^32. The register needs 2^t >= N^2
+// to recover every order; t is capped at MAX_REGISTER_QUBITS to bound the memory, so for large N only orders up
+// to about 2^(t/2) are found reliably.
+namespace Shor
+{
+	const size_t MAX_REGISTER_QUBITS = 24; // 2^24 amplitudes, 256 MB
+
+	// FindOrder holds one register at a time: the QFT is in place, with a twiddle table of half a register shared
+	// by all bases, and a measurement needs no extra table. Factor keeps at most this many bytes of registers in flight.
+	const size_t MAX_BATCH_BYTES = size_t(1) << 30;
+
+	uint64_t ModularPower(uint64_t base, uint64_t exponent, uint64_t modulus); // square and multiply
+	std::vector<uint64_t> ModularPowers(uint64_t base, uint64_t modulus, size_t count); // base^x mod modulus for x < count, in parallel
+	uint64_t GreatestCommonDivisor(uint64_t a, uint64_t b);
+
+	// the denominators of the convergents of numerator / denominator, in increasing order
+	std::vector<uint64_t> ConvergentDenominators(uint64_t numerator, uint64_t denominator);
+
+	size_t RegisterQubits(uint64_t modulus); // 2 * ceil(log2 N), at most MAX_REGISTER_QUBITS
+
+	// the input register after the measurement of f(x0) = target, already normalized
+	cdouble_vector PrepareRegister(uint64_t base, uint64_t modulus, size_t registerQubits, uint64_t target);
+
+	// the quantum part up to maxMeasurements times, each followed by the continued fraction expansion of the
+	// measured y / 2^t; returns the order of base modulo modulus, or 0 if it was not found; base must be coprime to modulus
+	uint64_t FindOrder(uint64_t base, uint64_t modulus, std::mt19937_64 & generator, size_t maxMeasurements = 10, size_t registerQubits = 0);
+
+	// FindOrder for every base, the bases in parallel; base i draws from a generator seeded with (seed, i)
+	std::vector<uint64_t> FindOrders(const std::vector<uint64_t> & bases, uint64_t modulus, uint64_t seed, size_t maxMeasurements = 10, size_t registerQubits = 0);
+
+	// a nontrivial factor of an odd composite modulus that is not a prime power, trying random bases in batches of
+	// Parallel::ThreadCount(), fewer when their registers would take more than MAX_BATCH_BYTES; returns 0 if maxBases
+	// bases did not give one
+	uint64_t Factor(uint64_t modulus, uint64_t seed, size_t maxBases = 64);
+}
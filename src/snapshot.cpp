@@ -0,0 +1,444 @@
+#include "snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+	const char MAGIC[8] = { 'Q', 'C', 'S', 'N', 'A', 'P', 'S', 'H' };
+	const uint32_t BYTE_ORDER_MARK = 0x01020304;
+	const size_t BLOCK_BYTES = size_t(1) << 20; // the payload is checksummed and copied in blocks that stay in the cache
+
+	const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+	const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+	uint32_t Swap32(uint32_t x)
+	{
+		return (x >> 24) | ((x >> 8) & 0xff00) | ((x << 8) & 0xff0000) | (x << 24);
+	}
+
+	uint64_t Swap64(uint64_t x)
+	{
+		return (uint64_t(Swap32(uint32_t(x))) << 32) | Swap32(uint32_t(x >> 32));
+	}
+
+	void SwapScalars(char * data, size_t bytes, size_t scalarSize) // reverses the bytes of every real and imaginary part
+	{
+		for (char * p = data, * end = data + bytes; p < end; p += scalarSize)
+			std::reverse(p, p + scalarSize);
+	}
+
+	class fnv_lanes
+	{
+	public:
+		explicit fnv_lanes(bool swapped = false) : m_swapped(swapped) {}
+
+		void Add(const char * data, size_t bytes)
+		{ // word i goes to lane i % 4 of the whole payload, so the blocks may have any size that is a multiple of 8
+			for (size_t k = 0; k + 8 <= bytes; k += 8)
+			{
+				uint64_t word;
+				memcpy(&word, data + k, 8);
+
+				if (m_swapped)
+					word = Swap64(word);
+
+				uint64_t & lane = m_lanes[m_words++ & 3];
+				lane = (lane ^ word) * FNV_PRIME;
+			}
+		}
+
+		uint64_t Value() const
+		{
+			uint64_t result = FNV_OFFSET_BASIS;
+
+			for (uint64_t lane : m_lanes)
+				result = (result ^ lane) * FNV_PRIME;
+
+			return (result ^ m_words) * FNV_PRIME;
+		}
+
+	protected:
+		bool m_swapped;
+		uint64_t m_words = 0;
+		uint64_t m_lanes[4] = { FNV_OFFSET_BASIS, FNV_OFFSET_BASIS, FNV_OFFSET_BASIS, FNV_OFFSET_BASIS };
+	};
+
+	template <class U> void Put(char * buffer, size_t offset, U value)
+	{
+		memcpy(buffer + offset, &value, sizeof(U));
+	}
+
+	template <class U> U Get(const char * buffer, size_t offset)
+	{
+		U value;
+		memcpy(&value, buffer + offset, sizeof(U));
+		return value;
+	}
+
+	template <class T> void WriteHeader(std::ostream & stream, uint32_t kind, uint64_t rows, uint64_t columns, bool checksum)
+	{
+		char buffer[Snapshot::HEADER_SIZE] = {};
+
+		memcpy(buffer, MAGIC, sizeof(MAGIC));
+		Put<uint32_t>(buffer, 8, Snapshot::VERSION);
+		Put<uint32_t>(buffer, 12, BYTE_ORDER_MARK);
+		Put<uint32_t>(buffer, 16, Snapshot::ElementType<T>());
+		Put<uint32_t>(buffer, 20, uint32_t(sizeof(T)));
+		Put<uint32_t>(buffer, 24, kind);
+		Put<uint32_t>(buffer, 28, checksum ? Snapshot::HAS_CHECKSUM : 0);
+		Put<uint64_t>(buffer, 32, rows);
+		Put<uint64_t>(buffer, 40, columns);
+		Put<uint64_t>(buffer, 48, rows * columns * sizeof(T));
+
+		stream.write(buffer, sizeof(buffer));
+	}
+
+	void WritePayload(std::ostream & stream, const char * data, size_t bytes, fnv_lanes & checksum)
+	{
+		for (size_t offset = 0; offset < bytes; offset += BLOCK_BYTES)
+		{
+			size_t n = std::min(BLOCK_BYTES, bytes - offset);
+
+			checksum.Add(data + offset, n);
+			stream.write(data + offset, std::streamsize(n));
+		}
+	}
+
+	void WriteTrailer(std::ostream & stream, const fnv_lanes & checksum, bool enabled)
+	{
+		if (enabled)
+		{
+			uint64_t value = checksum.Value();
+			stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+		}
+
+		if (!stream)
+			throw std::runtime_error("Cannot write the snapshot");
+	}
+
+	void ReadPayload(std::istream & stream, char * data, size_t bytes, const Snapshot::header & header, fnv_lanes & checksum)
+	{
+		for (size_t offset = 0; offset < bytes; offset += BLOCK_BYTES)
+		{
+			size_t n = std::min(BLOCK_BYTES, bytes - offset);
+
+			if (!stream.read(data + offset, std::streamsize(n)))
+				throw std::runtime_error("The snapshot is truncated");
+
+			checksum.Add(data + offset, n); // over the bytes as written
+
+			if (header.swapped)
+				SwapScalars(data + offset, n, header.elementSize / 2);
+		}
+	}
+
+	void ReadTrailer(std::istream & stream, const Snapshot::header & header, const fnv_lanes & checksum)
+	{
+		if (!(header.flags & Snapshot::HAS_CHECKSUM))
+			return;
+
+		uint64_t value;
+		if (!stream.read(reinterpret_cast<char *>(&value), sizeof(value)))
+			throw std::runtime_error("The snapshot is truncated");
+
+		if ((header.swapped ? Swap64(value) : value) != checksum.Value())
+			throw std::runtime_error("The checksum of the snapshot does not match");
+	}
+
+	template <class T> void CheckHeader(const Snapshot::header & header, uint32_t kind)
+	{
+		if (header.elementType != Snapshot::ElementType<T>() || header.elementSize != sizeof(T))
+			throw std::invalid_argument("The snapshot holds another element type");
+
+		if (header.kind != kind)
+			throw std::invalid_argument(kind == Snapshot::KIND_VECTOR ? "The snapshot does not hold a vector" : "The snapshot does not hold a matrix");
+	}
+
+	Snapshot::header ParseHeader(const char * buffer, size_t available)
+	{
+		if (available < Snapshot::HEADER_SIZE || memcmp(buffer, MAGIC, sizeof(MAGIC)) != 0)
+			throw std::runtime_error("Not a snapshot");
+
+		Snapshot::header result;
+
+		uint32_t mark = Get<uint32_t>(buffer, 12);
+		if (mark != BYTE_ORDER_MARK && mark != Swap32(BYTE_ORDER_MARK))
+			throw std::runtime_error("Not a snapshot");
+
+		result.swapped = mark != BYTE_ORDER_MARK;
+
+		auto get32 = [&](size_t offset) { uint32_t x = Get<uint32_t>(buffer, offset); return result.swapped ? Swap32(x) : x; };
+		auto get64 = [&](size_t offset) { uint64_t x = Get<uint64_t>(buffer, offset); return result.swapped ? Swap64(x) : x; };
+
+		result.version = get32(8);
+		result.elementType = get32(16);
+		result.elementSize = get32(20);
+		result.kind = get32(24);
+		result.flags = get32(28);
+		result.rows = get64(32);
+		result.columns = get64(40);
+		result.payloadBytes = get64(48);
+
+		if (result.version == 0 || result.version > Snapshot::VERSION)
+			throw std::runtime_error("The snapshot was written by a newer version");
+
+		if (result.elementSize == 0 || result.elementSize % 8 != 0 || (result.kind != Snapshot::KIND_VECTOR && result.kind != Snapshot::KIND_MATRIX))
+			throw std::runtime_error("The snapshot header is corrupt");
+
+		if (result.kind == Snapshot::KIND_VECTOR && result.columns != 1)
+			throw std::runtime_error("The snapshot header is corrupt");
+
+		if ((result.columns != 0 && result.rows > UINT64_MAX / result.columns) || result.rows * result.columns > UINT64_MAX / result.elementSize ||
+			result.rows * result.columns * result.elementSize != result.payloadBytes || result.payloadBytes > SIZE_MAX)
+			throw std::runtime_error("The snapshot header is corrupt");
+
+		return result;
+	}
+
+	void CheckAvailable(std::istream & stream, const Snapshot::header & header)
+	{ // before the elements are allocated, so that a corrupt size cannot ask for more memory than the snapshot has
+		const std::streampos position = stream.tellg();
+		if (position == std::streampos(-1)) // a stream that cannot seek is only found short while it is read
+			return;
+
+		stream.seekg(0, std::ios::end);
+		const std::streampos end = stream.tellg();
+		stream.seekg(position);
+
+		if (end == std::streampos(-1) || !stream)
+			throw std::runtime_error("Cannot read the snapshot");
+
+		if (uint64_t(end - position) < header.payloadBytes)
+			throw std::runtime_error("The snapshot is truncated");
+	}
+
+	std::ofstream OpenForWriting(const std::string & path)
+	{
+		std::ofstream result(path, std::ios::binary | std::ios::trunc);
+		if (!result)
+			throw std::runtime_error("Cannot create " + path);
+
+		return result;
+	}
+
+	std::ifstream OpenForReading(const std::string & path)
+	{
+		std::ifstream result(path, std::ios::binary);
+		if (!result)
+			throw std::runtime_error("Cannot open " + path);
+
+		return result;
+	}
+}
+
+template <> uint32_t Snapshot::ElementType<cint>() { return 1; }
+template <> uint32_t Snapshot::ElementType<cfloat>() { return 2; }
+template <> uint32_t Snapshot::ElementType<cdouble>() { return 3; }
+
+uint64_t Snapshot::Checksum(const void * data, size_t bytes)
+{
+	fnv_lanes checksum;
+	checksum.Add(static_cast<const char *>(data), bytes);
+
+	return checksum.Value();
+}
+
+template <class T> void Snapshot::Write(std::ostream & stream, const complex_vector<T> & vector, bool checksum /*= true*/)
+{
+	WriteHeader<T>(stream, KIND_VECTOR, vector.size(), 1, checksum);
+
+	fnv_lanes lanes;
+	WritePayload(stream, reinterpret_cast<const char *>(vector.data()), vector.size() * sizeof(T), lanes);
+	WriteTrailer(stream, lanes, checksum);
+}
+
+template <class T> void Snapshot::Write(std::ostream & stream, const complex_matrix<T> & matrix, bool checksum /*= true*/)
+{
+	const size_t columns = matrix.empty() ? 0 : matrix.Cols();
+
+	for (const auto & row : matrix)
+		if (row.size() != columns)
+			throw std::invalid_argument("The rows of the matrix must have the same size");
+
+	WriteHeader<T>(stream, KIND_MATRIX, matrix.Rows(), columns, checksum);
+
+	fnv_lanes lanes;
+	for (const auto & row : matrix)
+		WritePayload(stream, reinterpret_cast<const char *>(row.data()), columns * sizeof(T), lanes);
+
+	WriteTrailer(stream, lanes, checksum);
+}
+
+template <class T> void Snapshot::Save(const std::string & path, const complex_vector<T> & vector, bool checksum /*= true*/)
+{
+	std::ofstream stream = OpenForWriting(path);
+	Write(stream, vector, checksum);
+}
+
+template <class T> void Snapshot::Save(const std::string & path, const complex_matrix<T> & matrix, bool checksum /*= true*/)
+{
+	std::ofstream stream = OpenForWriting(path);
+	Write(stream, matrix, checksum);
+}
+
+Snapshot::header Snapshot::ReadHeader(std::istream & stream)
+{
+	char buffer[HEADER_SIZE];
+	stream.read(buffer, sizeof(buffer));
+
+	return ParseHeader(buffer, size_t(stream.gcount()));
+}
+
+template <class T> complex_vector<T> Snapshot::ReadVector(std::istream & stream)
+{
+	header info = ReadHeader(stream);
+	CheckHeader<T>(info, KIND_VECTOR);
+	CheckAvailable(stream, info);
+
+	complex_vector<T> result(size_t(info.rows));
+
+	fnv_lanes lanes(info.swapped);
+	ReadPayload(stream, reinterpret_cast<char *>(result.data()), size_t(info.payloadBytes), info, lanes);
+	ReadTrailer(stream, info, lanes);
+
+	return result;
+}
+
+template <class T> complex_matrix<T> Snapshot::ReadMatrix(std::istream & stream)
+{
+	header info = ReadHeader(stream);
+	CheckHeader<T>(info, KIND_MATRIX);
+	CheckAvailable(stream, info);
+
+	complex_matrix<T> result;
+	result.reserve(size_t(info.rows));
+
+	fnv_lanes lanes(info.swapped);
+
+	for (uint64_t row = 0; row < info.rows; row++)
+	{
+		result.emplace_back(size_t(info.columns));
+		ReadPayload(stream, reinterpret_cast<char *>(result.back().data()), size_t(info.columns) * sizeof(T), info, lanes);
+	}
+
+	ReadTrailer(stream, info, lanes);
+
+	return result;
+}
+
+template <class T> complex_vector<T> Snapshot::LoadVector(const std::string & path)
+{
+	std::ifstream stream = OpenForReading(path);
+	return ReadVector<T>(stream);
+}
+
+template <class T> complex_matrix<T> Snapshot::LoadMatrix(const std::string & path)
+{
+	std::ifstream stream = OpenForReading(path);
+	return ReadMatrix<T>(stream);
+}
+
+template <class T> Snapshot::mapped_snapshot<T>::mapped_snapshot(const std::string & path)
+	: m_file(path, false)
+{
+	m_header = ParseHeader(m_file.Data(), m_file.Size());
+
+	if (m_header.swapped)
+		throw std::runtime_error("The snapshot was written in the other byte order, read it from a stream instead");
+
+	size_t checksumBytes = (m_header.flags & HAS_CHECKSUM) ? sizeof(uint64_t) : 0;
+
+	if (m_file.Size() - HEADER_SIZE < checksumBytes || m_file.Size() - HEADER_SIZE - checksumBytes < m_header.payloadBytes)
+		throw std::runtime_error("The snapshot is truncated");
+
+	CheckHeader<T>(m_header, m_header.kind); // either kind, a vector is a matrix of 1 column
+}
+
+template <class T> bool Snapshot::mapped_snapshot<T>::Verify() const
+{
+	if (!(m_header.flags & HAS_CHECKSUM))
+		return true;
+
+	const char * payload = m_file.Data() + HEADER_SIZE;
+	return Get<uint64_t>(payload, size_t(m_header.payloadBytes)) == Checksum(payload, size_t(m_header.payloadBytes));
+}
+
+template <class T> complex_vector<T> Snapshot::mapped_snapshot<T>::ToVector() const
+{
+	complex_vector<T> result(Size());
+	std::copy(Data(), Data() + Size(), result.begin());
+
+	return result;
+}
+
+template <class T> complex_matrix<T> Snapshot::mapped_snapshot<T>::ToMatrix() const
+{
+	complex_matrix<T> result;
+	result.reserve(Rows());
+
+	for (size_t row = 0; row < Rows(); row++)
+	{
+		result.emplace_back(Cols());
+		std::copy(Row(row), Row(row) + Cols(), result.back().begin());
+	}
+
+	return result;
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		std::ifstream in;
+		std::ofstream out;
+
+		cint_vector vi;
+		cint_matrix mi;
+		Snapshot::Write(out, vi);
+		Snapshot::Write(out, mi);
+		Snapshot::Save("", vi);
+		Snapshot::Save("", mi);
+		Snapshot::ReadVector<cint>(in);
+		Snapshot::ReadMatrix<cint>(in);
+		Snapshot::LoadVector<cint>("");
+		Snapshot::LoadMatrix<cint>("");
+		Snapshot::mapped_snapshot<cint> si("");
+		si.Verify();
+		si.ToVector();
+		si.ToMatrix();
+
+		cfloat_vector vf;
+		cfloat_matrix mf;
+		Snapshot::Write(out, vf);
+		Snapshot::Write(out, mf);
+		Snapshot::Save("", vf);
+		Snapshot::Save("", mf);
+		Snapshot::ReadVector<cfloat>(in);
+		Snapshot::ReadMatrix<cfloat>(in);
+		Snapshot::LoadVector<cfloat>("");
+		Snapshot::LoadMatrix<cfloat>("");
+		Snapshot::mapped_snapshot<cfloat> sf("");
+		sf.Verify();
+		sf.ToVector();
+		sf.ToMatrix();
+
+		cdouble_vector vd;
+		cdouble_matrix md;
+		Snapshot::Write(out, vd);
+		Snapshot::Write(out, md);
+		Snapshot::Save("", vd);
+		Snapshot::Save("", md);
+		Snapshot::ReadVector<cdouble>(in);
+		Snapshot::ReadMatrix<cdouble>(in);
+		Snapshot::LoadVector<cdouble>("");
+		Snapshot::LoadMatrix<cdouble>("");
+		Snapshot::mapped_snapshot<cdouble> sd("");
+		sd.Verify();
+		sd.ToVector();
+		sd.ToMatrix();
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "cmatrix.h"
+#include "memory_mapped_file.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Binary snapshots of vectors and matrices, to checkpoint a long simulation and resume it in about the time
+// the disk needs for the bytes. A snapshot is a header of HEADER_SIZE bytes, the raw elements in row-major
+// order, and the checksum of the elements if the header has HAS_CHECKSUM:
+//
+//    0  "QCSNAPSH"
+//    8  version, byte order mark 0x01020304 (uint32 each)
+//   16  element type (see ElementType), element size in bytes (uint32 each)
+//   24  kind (KIND_VECTOR or KIND_MATRIX), flags (uint32 each)
+//   32  rows, columns (uint64 each; a vector has 1 column)
+//   48  payload size in bytes, 0 (uint64 each)
+//   64  the payload, then the checksum (uint64)
+//
+// The numbers are in the byte order of the writer, which the mark shows; the stream readers swap them when
+// needed, the mapped reader only takes snapshots in the byte order of this machine. The checksum is FNV-1a on
+// the 64-bit words of the payload dealt in turn to 4 lanes, which are hashed together at the end: 4 chains of
+// multiplications instead of one per byte, so checking it keeps up with the disk.
+namespace Snapshot
+{
+	const uint32_t VERSION = 1;
+	const size_t HEADER_SIZE = 64; // keeps the payload of a mapped snapshot aligned
+
+	const uint32_t KIND_VECTOR = 1;
+	const uint32_t KIND_MATRIX = 2;
+
+	const uint32_t HAS_CHECKSUM = 1; // flag
+
+	struct header
+	{
+		uint32_t version = VERSION;
+		uint32_t elementType = 0;
+		uint32_t elementSize = 0;
+		uint32_t kind = 0;
+		uint32_t flags = 0;
+		uint64_t rows = 0;
+		uint64_t columns = 0;
+		uint64_t payloadBytes = 0;
+		bool swapped = false; // written in the other byte order, only set by the readers
+	};
+
+	template <class T> uint32_t ElementType(); // 1 for cint, 2 for cfloat, 3 for cdouble
+	template <> uint32_t ElementType<cint>();
+	template <> uint32_t ElementType<cfloat>();
+	template <> uint32_t ElementType<cdouble>();
+
+	uint64_t Checksum(const void * data, size_t bytes); // of a whole payload, bytes is a multiple of 8
+
+	// The writers stream the elements straight from the vector or the matrix, the stream must be binary.
+	// All the functions here throw std::runtime_error when a stream fails or does not hold a valid snapshot,
+	// and std::invalid_argument when it holds another type or kind than the one asked for. The readers check the
+	// payload size of the header against what a stream that can seek still holds before allocating anything.
+
+	template <class T> void Write(std::ostream & stream, const complex_vector<T> & vector, bool checksum = true);
+	template <class T> void Write(std::ostream & stream, const complex_matrix<T> & matrix, bool checksum = true); // the rows must have the same size
+	template <class T> void Save(const std::string & path, const complex_vector<T> & vector, bool checksum = true);
+	template <class T> void Save(const std::string & path, const complex_matrix<T> & matrix, bool checksum = true);
+
+	header ReadHeader(std::istream & stream);
+	template <class T> complex_vector<T> ReadVector(std::istream & stream); // checks the checksum, if there is one
+	template <class T> complex_matrix<T> ReadMatrix(std::istream & stream);
+	template <class T> complex_vector<T> LoadVector(const std::string & path);
+	template <class T> complex_matrix<T> LoadMatrix(const std::string & path);
+
+	// A snapshot mapped read-only into memory: the elements are used where they are, without reading the file
+	// first or copying it, and the pages are loaded when touched. The checksum is only checked by Verify().
+	template <class T>
+	class mapped_snapshot
+	{
+	public:
+		explicit mapped_snapshot(const std::string & path);
+
+		const header & Header() const { return m_header; }
+		size_t Rows() const { return size_t(m_header.rows); }
+		size_t Cols() const { return size_t(m_header.columns); }
+		size_t Size() const { return size_t(m_header.rows * m_header.columns); }
+
+		const T * Data() const { return reinterpret_cast<const T *>(m_file.Data() + HEADER_SIZE); }
+		const T * Row(size_t row) const { return Data() + row * Cols(); }
+		const T & operator[](size_t index) const { return Data()[index]; }
+
+		bool Verify() const; // true if the checksum matches, or there is none
+
+		complex_vector<T> ToVector() const; // all the elements, also of a matrix
+		complex_matrix<T> ToMatrix() const;
+
+	protected:
+		memory_mapped_file m_file;
+		header m_header;
+	};
+}
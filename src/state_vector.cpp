@@ -0,0 +1,304 @@
+#include "state_vector.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+namespace
+{
+	template <class T> void ReadGate(const complex_matrix<T> & gate, T g[4])
+	{
+		if (gate.Rows() != 2 || gate[0].size() != 2 || gate[1].size() != 2)
+			throw std::out_of_range("A single-qubit gate must be a 2x2 matrix");
+
+		g[0] = gate[0][0];
+		g[1] = gate[0][1];
+		g[2] = gate[1][0];
+		g[3] = gate[1][1];
+	}
+
+	template <class T> std::vector<size_t> QubitMasks(const complex_vector<T> & state, const std::vector<size_t> & qubits)
+	{ // the bits of the qubits, sorted from the lowest
+		size_t qubitCount = StateVector::QubitCount(state);
+		std::vector<size_t> result;
+
+		for (size_t qubit : qubits)
+		{
+			if (qubit >= qubitCount)
+				throw std::out_of_range("Qubit index out of range");
+
+			result.push_back(StateVector::QubitStride(qubitCount, qubit));
+		}
+
+		std::sort(result.begin(), result.end());
+
+		if (std::adjacent_find(result.begin(), result.end()) != result.end())
+			throw std::invalid_argument("The qubits of a gate must be different");
+
+		return result;
+	}
+
+	// calls body(i) for every index i whose bits in sortedMasks are set as in setMask, in parallel
+	template <class F> void ForEachMaskedIndex(size_t size, const std::vector<size_t> & sortedMasks, size_t setMask, F body)
+	{
+		Parallel::For(0, size >> sortedMasks.size(), StateVector::MIN_PAIRS_PER_THREAD, [&](size_t begin, size_t end)
+		{
+			for (size_t k = begin; k < end; k++)
+			{
+				size_t i = k;
+				for (size_t mask : sortedMasks) // insert a zero bit at every fixed position, lowest first
+					i = StateVector::PairIndex(i, mask);
+
+				body(i | setMask);
+			}
+		}, StateVector::CHUNK_GRANULARITY);
+	}
+}
+
+template <class T> size_t StateVector::QubitCount(const complex_vector<T> & state)
+{
+	size_t size = state.size();
+
+	if (size == 0 || (size & (size - 1)) != 0)
+		throw std::out_of_range("The size of a state vector must be a power of 2");
+
+	size_t result = 0;
+	while (size > 1)
+	{
+		size >>= 1;
+		result++;
+	}
+
+	return result;
+}
+
+template <class T> void StateVector::ApplyPairKernel(T * state, size_t stride, size_t pairBegin, size_t pairEnd, const T g[4])
+{
+	const T g0 = g[0], g1 = g[1], g2 = g[2], g3 = g[3];
+
+	if (g1.IsZero() && g2.IsZero()) // diagonal gates (phases, Z, T) only scale the two halves
+	{
+		for (size_t pair = pairBegin; pair < pairEnd; pair++)
+		{
+			size_t i = PairIndex(pair, stride);
+
+			state[i] *= g0;
+			state[i + stride] *= g3;
+		}
+
+		return;
+	}
+
+	for (size_t pair = pairBegin; pair < pairEnd; )
+	{ // runs of consecutive pairs are contiguous in memory, up to the next multiple of the stride
+		size_t runEnd = std::min(pairEnd, (pair / stride + 1) * stride);
+
+		T * a = state + PairIndex(pair, stride);
+		T * b = a + stride;
+
+		for (size_t k = 0, n = runEnd - pair; k < n; k++)
+		{
+			const T x = a[k], y = b[k];
+
+			a[k] = g0 * x + g1 * y;
+			b[k] = g2 * x + g3 * y;
+		}
+
+		pair = runEnd;
+	}
+}
+
+template <class T> void StateVector::ApplyGate(complex_vector<T> & state, const complex_matrix<T> & gate, size_t qubit)
+{
+	size_t qubitCount = QubitCount(state);
+
+	if (qubit >= qubitCount)
+		throw std::out_of_range("Qubit index out of range");
+
+	T g[4];
+	ReadGate(gate, g);
+
+	const size_t stride = QubitStride(qubitCount, qubit);
+	T * data = state.data();
+
+	Parallel::For(0, state.size() / 2, MIN_PAIRS_PER_THREAD, [&](size_t pairBegin, size_t pairEnd)
+	{
+		ApplyPairKernel(data, stride, pairBegin, pairEnd, g);
+	}, CHUNK_GRANULARITY);
+}
+
+template <class T> void StateVector::ApplyGateToAll(complex_vector<T> & state, const complex_matrix<T> & gate)
+{
+	size_t qubitCount = QubitCount(state);
+
+	for (size_t qubit = 0; qubit < qubitCount; qubit++)
+		ApplyGate(state, gate, qubit);
+}
+
+template <class T> void StateVector::ApplyMultiQubitGate(complex_vector<T> & state, const complex_matrix<T> & gate, const std::vector<size_t> & qubits)
+{ // every group of 2^k amplitudes that differ only in the gate's qubits is gathered, multiplied and scattered back
+	std::vector<size_t> masks = QubitMasks(state, qubits);
+
+	const size_t qubitCount = QubitCount(state), k = qubits.size(), n = size_t(1) << k;
+
+	if (gate.Rows() != n)
+		throw std::out_of_range("The gate size does not match the number of qubits");
+
+	std::vector<T> g(n * n); // row-major copy of the gate
+	for (size_t i = 0; i < n; i++)
+	{
+		if (gate[i].size() != n)
+			throw std::out_of_range("The gate size does not match the number of qubits");
+
+		std::copy(gate[i].begin(), gate[i].end(), g.begin() + i * n);
+	}
+
+	std::vector<size_t> offsets(n, 0); // offset of every local index from the group's base index
+	for (size_t local = 0; local < n; local++)
+		for (size_t j = 0; j < k; j++)
+			if (local & (size_t(1) << (k - 1 - j)))
+				offsets[local] |= QubitStride(qubitCount, qubits[j]);
+
+	T * data = state.data();
+
+	Parallel::For(0, state.size() >> k, std::max<size_t>(1, (2 * MIN_PAIRS_PER_THREAD) >> k), [&](size_t begin, size_t end)
+	{
+		std::vector<T> x(n);
+
+		for (size_t group = begin; group < end; group++)
+		{
+			size_t base = group;
+			for (size_t mask : masks)
+				base = PairIndex(base, mask);
+
+			for (size_t l = 0; l < n; l++)
+				x[l] = data[base + offsets[l]];
+
+			for (size_t l = 0; l < n; l++)
+			{
+				const T * row = g.data() + l * n;
+
+				T sum;
+				for (size_t m = 0; m < n; m++)
+					sum += row[m] * x[m];
+
+				data[base + offsets[l]] = sum;
+			}
+		}
+	}, CHUNK_GRANULARITY);
+}
+
+template <class T> void StateVector::ApplyControlledGate(complex_vector<T> & state, const complex_matrix<T> & gate, const std::vector<size_t> & controls, size_t target)
+{
+	std::vector<size_t> qubits(controls);
+	qubits.push_back(target);
+
+	std::vector<size_t> masks = QubitMasks(state, qubits);
+	size_t targetMask = QubitStride(QubitCount(state), target), controlMask = 0;
+
+	for (size_t mask : masks)
+		if (mask != targetMask)
+			controlMask |= mask;
+
+	T g[4];
+	ReadGate(gate, g);
+
+	T * data = state.data();
+
+	ForEachMaskedIndex(state.size(), masks, controlMask, [&](size_t i)
+	{
+		const T x = data[i], y = data[i + targetMask];
+
+		data[i] = g[0] * x + g[1] * y;
+		data[i + targetMask] = g[2] * x + g[3] * y;
+	});
+}
+
+template <class T> void StateVector::ApplyControlledX(complex_vector<T> & state, const std::vector<size_t> & controls, size_t target)
+{
+	std::vector<size_t> qubits(controls);
+	qubits.push_back(target);
+
+	std::vector<size_t> masks = QubitMasks(state, qubits);
+	size_t targetMask = QubitStride(QubitCount(state), target), controlMask = 0;
+
+	for (size_t mask : masks)
+		if (mask != targetMask)
+			controlMask |= mask;
+
+	T * data = state.data();
+
+	ForEachMaskedIndex(state.size(), masks, controlMask, [&](size_t i)
+	{
+		std::swap(data[i], data[i + targetMask]);
+	});
+}
+
+template <class T> void StateVector::ApplyControlledZ(complex_vector<T> & state, const std::vector<size_t> & qubits)
+{
+	std::vector<size_t> masks = QubitMasks(state, qubits);
+	size_t setMask = 0;
+
+	for (size_t mask : masks)
+		setMask |= mask;
+
+	T * data = state.data();
+
+	ForEachMaskedIndex(state.size(), masks, setMask, [&](size_t i)
+	{
+		data[i] = -data[i];
+	});
+}
+
+template <class T> void StateVector::ApplySwap(complex_vector<T> & state, size_t qubit1, size_t qubit2)
+{ // exchanges the amplitudes of |..1..0..> and |..0..1..>
+	std::vector<size_t> masks = QubitMasks(state, { qubit1, qubit2 });
+
+	T * data = state.data();
+
+	ForEachMaskedIndex(state.size(), masks, masks[1], [&](size_t i)
+	{
+		std::swap(data[i], data[i - masks[1] + masks[0]]);
+	});
+}
+
+
+namespace
+{
+	void dummy() // we must create dummy objects and call methods of template classes to avoid linker errors, see https://www.codeproject.com/Articles/48575/How-to-define-a-template-class-in-a-h-file-and-imp
+	{
+		cint_vector vi;
+		cdouble_vector vd;
+		cfloat_vector vf;
+
+		StateVector::QubitCount(vi);
+		StateVector::QubitCount(vd);
+		StateVector::QubitCount(vf);
+
+		StateVector::ApplyPairKernel<cint>(nullptr, 1, 0, 0, nullptr);
+		StateVector::ApplyPairKernel<cdouble>(nullptr, 1, 0, 0, nullptr);
+		StateVector::ApplyPairKernel<cfloat>(nullptr, 1, 0, 0, nullptr);
+
+		StateVector::ApplyGate(vi, cint_matrix(), 0);
+		StateVector::ApplyGate(vd, cdouble_matrix(), 0);
+		StateVector::ApplyGate(vf, cfloat_matrix(), 0);
+		StateVector::ApplyGateToAll(vi, cint_matrix());
+		StateVector::ApplyGateToAll(vd, cdouble_matrix());
+		StateVector::ApplyGateToAll(vf, cfloat_matrix());
+
+		StateVector::ApplyMultiQubitGate(vi, cint_matrix(), {});
+		StateVector::ApplyMultiQubitGate(vd, cdouble_matrix(), {});
+		StateVector::ApplyMultiQubitGate(vf, cfloat_matrix(), {});
+		StateVector::ApplyControlledGate(vi, cint_matrix(), {}, 0);
+		StateVector::ApplyControlledGate(vd, cdouble_matrix(), {}, 0);
+		StateVector::ApplyControlledGate(vf, cfloat_matrix(), {}, 0);
+		StateVector::ApplyControlledX(vi, {}, 0);
+		StateVector::ApplyControlledX(vd, {}, 0);
+		StateVector::ApplyControlledX(vf, {}, 0);
+		StateVector::ApplyControlledZ(vi, {});
+		StateVector::ApplyControlledZ(vd, {});
+		StateVector::ApplyControlledZ(vf, {});
+		StateVector::ApplySwap(vi, 0, 0);
+		StateVector::ApplySwap(vd, 0, 0);
+		StateVector::ApplySwap(vf, 0, 0);
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "cmatrix.h"
+
+// State-vector simulation: gates are applied to the amplitudes of an n-qubit register in place, without
+// building the 2^n x 2^n operator. Qubit 0 is the most significant bit of the basis state index, so applying
+// a gate to qubit 0 of a 2-qubit register is the same as multiplying with gate (x) I, as in the book.
+namespace StateVector
+{
+	const size_t MIN_PAIRS_PER_THREAD = 1 << 14; // amplitude pairs, below this threads cost more than they save
+
+	// The kernels split their pairs (or groups) across Parallel's pool in chunks that are a multiple of this. The
+	// amplitudes of such a chunk are whole runs of the gate stride when the stride is smaller, and whole aligned
+	// blocks of it otherwise, so two threads never write to the same cache line.
+	const size_t CHUNK_GRANULARITY = 64;
+
+	template <class T> size_t QubitCount(const complex_vector<T> & state); // throws if the size is not a power of 2
+
+	// distance between the two amplitudes a single-qubit gate on this qubit mixes, i.e. the bit of the qubit
+	inline size_t QubitStride(size_t qubitCount, size_t qubit) { return size_t(1) << (qubitCount - 1 - qubit); }
+
+	// index of the pair-th amplitude whose stride bit is 0, i.e. pair with a zero bit inserted at the stride bit
+	inline size_t PairIndex(size_t pair, size_t stride) { return ((pair & ~(stride - 1)) << 1) | (pair & (stride - 1)); }
+
+	// the butterfly: for the pairs [pairBegin, pairEnd), (a, b) = (state[i], state[i + stride]) becomes
+	// (g[0] * a + g[1] * b, g[2] * a + g[3] * b); g is the 2x2 gate in row-major order
+	template <class T> void ApplyPairKernel(T * state, size_t stride, size_t pairBegin, size_t pairEnd, const T g[4]);
+
+	template <class T> void ApplyGate(complex_vector<T> & state, const complex_matrix<T> & gate, size_t qubit); // gate is 2x2
+	template <class T> void ApplyGateToAll(complex_vector<T> & state, const complex_matrix<T> & gate); // the same gate on every qubit, e.g. H (x) ... (x) H
+
+	// a dense 2^k x 2^k gate on k qubits; qubits[0] is the most significant bit of the gate's own index,
+	// so ApplyMultiQubitGate(state, MatrixConstants::CNOT, { c, t }) is a CNOT with control c and target t
+	template <class T> void ApplyMultiQubitGate(complex_vector<T> & state, const complex_matrix<T> & gate, const std::vector<size_t> & qubits);
+
+	// Controlled gates only touch the amplitudes whose control bits are all 1, which are enumerated directly
+	// by inserting the fixed bits into a counter; the qubits passed to one call must all be different.
+
+	template <class T> void ApplyControlledGate(complex_vector<T> & state, const complex_matrix<T> & gate, const std::vector<size_t> & controls, size_t target);
+	template <class T> void ApplyControlledX(complex_vector<T> & state, const std::vector<size_t> & controls, size_t target); // swaps amplitude pairs
+	template <class T> void ApplyControlledZ(complex_vector<T> & state, const std::vector<size_t> & qubits); // negates the amplitudes with all these bits set
+	template <class T> void ApplySwap(complex_vector<T> & state, size_t qubit1, size_t qubit2);
+
+	template <class T> void ApplyCNOT(complex_vector<T> & state, size_t control, size_t target) { ApplyControlledX(state, { control }, target); }
+	template <class T> void ApplyToffoli(complex_vector<T> & state, size_t control1, size_t control2, size_t target) { ApplyControlledX(state, { control1, control2 }, target); }
+	template <class T> void ApplyCZ(complex_vector<T> & state, size_t qubit1, size_t qubit2) { ApplyControlledZ(state, { qubit1, qubit2 }); }
+}
@@ -0,0 +1,76 @@
+#include <gtest\gtest.h>
+
+#include "cdiagonal.h"
+
+using namespace testing;
+
+class cdiagonalTest : public Test
+{
+public:
+	cdiagonalTest() = default;
+};
+
+
+TEST_F(cdiagonalTest, FromMatrix_ToMatrix)
+{
+	cint_matrix A({ { "3+2i", "0", "0" }, { "0", "-1", "0" }, { "0", "0", "i" } });
+
+	cint_diagonal_operator D;
+	D.FromMatrix(A);
+
+	EXPECT_EQ(3, D.Size());
+	EXPECT_EQ(cint(-1), D[1]);
+	EXPECT_EQ(A, D.ToMatrix());
+
+	EXPECT_ANY_THROW(D.FromMatrix(cint_matrix({ { "1", "0", "0" }, { "0", "1", "0" }, { "0", "1", "1" } })));
+	EXPECT_ANY_THROW(D.FromMatrix(cint_matrix(2, 3)));
+}
+
+TEST_F(cdiagonalTest, Multiply)
+{
+	cint_diagonal_operator D(cint_vector({ "3+2i", "-1", "i" }));
+	cint_matrix A = D.ToMatrix();
+	cint_matrix B({ { "5", "2-i", "6-4i" }, { "0", "4+5i", "2" }, { "7-4i", "2+7i", "0" } });
+	cint_vector v({ "1", "2-i", "3i" });
+
+	EXPECT_EQ(A * v, D * v);
+	EXPECT_EQ(A * B, D * B);
+	EXPECT_EQ(A * A, (D * D).ToMatrix());
+
+	D.Apply(v);
+	EXPECT_EQ(A * cint_vector({ "1", "2-i", "3i" }), v);
+
+	EXPECT_ANY_THROW(D * cint_vector(2));
+}
+
+TEST_F(cdiagonalTest, Invert_and_adjoint)
+{
+	cdouble_diagonal_operator D(cdouble_vector({ cdouble(0, 1), cdouble(-1), cdouble(M_SQRT1_2, M_SQRT1_2) }));
+
+	EXPECT_TRUE((D * D.Invert()).Diagonal().NearEquals(cdouble_vector(3, cdouble(1)), 1e-12));
+	EXPECT_EQ(D.ToMatrix().Adjoint(), D.Adjoint().ToMatrix());
+
+	EXPECT_ANY_THROW(cdouble_diagonal_operator(cdouble_vector({ 1, 0, 2 })).Invert());
+	EXPECT_DOUBLE_EQ(1e20, cdouble_diagonal_operator(cdouble_vector({ cdouble(1e-20) })).Invert().Diagonal()[0].Real());
+}
+
+TEST_F(cdiagonalTest, TensorProduct)
+{
+	cint_diagonal_operator A(cint_vector({ "2", "i", "1-i" })), B(cint_vector({ "1", "-1", "3" }));
+
+	EXPECT_EQ(A.ToMatrix().TensorProduct(B.ToMatrix()), A.TensorProduct(B).ToMatrix());
+}
+
+TEST_F(cdiagonalTest, PhaseFlip) // marking a state like in Grover's search, see page 198
+{
+	cdouble_vector state(8, cdouble(1.0 / sqrt(8)));
+
+	cdouble_diagonal_operator oracle = cdouble_diagonal_operator::CreatePhaseFlip(8, { 5 });
+	oracle.Apply(state);
+
+	for (size_t i = 0; i < 8; i++)
+		EXPECT_EQ(cdouble((i == 5 ? -1.0 : 1.0) / sqrt(8)), state[i]);
+
+	EXPECT_EQ(oracle, oracle.Invert());
+	EXPECT_ANY_THROW(cdouble_diagonal_operator::CreatePhaseFlip(8, { 8 }));
+}
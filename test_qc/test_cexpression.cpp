@@ -0,0 +1,83 @@
+#include <gtest\gtest.h>
+
+#include "cexpression.h"
+
+using namespace ComplexExpression;
+using namespace testing;
+
+class cexpressionTest : public Test
+{
+public:
+	cexpressionTest() = default;
+};
+
+
+TEST_F(cexpressionTest, Vector_expressions_match_eager_operators)
+{
+	cint_vector a({ "5+13i", "6+2i", "-6i", "12" });
+	cint_vector b({ "7-8i", "4i", "2", "9+3i" });
+	cint c("2-i");
+
+	cint_vector result = Lazy(a) + Lazy(b);
+	EXPECT_EQ(a + b, result);
+
+	result = -Lazy(a) + c * Lazy(b) - Lazy(b) * c;
+	EXPECT_EQ(-a + c * b - b * c, result);
+
+	result = Conjugate(Lazy(a) - Lazy(b));
+	EXPECT_EQ((a - b).Conjugate(), result);
+
+	EXPECT_ANY_THROW(cint_vector(Lazy(a) + Lazy(cint_vector(3))));
+}
+
+TEST_F(cexpressionTest, Assign_to_operand)
+{
+	cint_vector a({ "1", "2", "3" });
+	cint_vector b({ "i", "2i", "3i" });
+
+	a = Lazy(a) + Lazy(b) + Lazy(a); // element-wise, evaluated in place
+	EXPECT_EQ(cint_vector({ "2+i", "4+2i", "6+3i" }), a);
+
+	cint_matrix M({ { "0", "1", "0" }, { "0", "0", "1" }, { "1", "0", "0" } });
+	cint_vector expected = M * a;
+
+	a = Lazy(M) * Lazy(a); // a is read while the product is computed, so a temporary is used
+	EXPECT_EQ(expected, a);
+}
+
+TEST_F(cexpressionTest, Matrix_expressions)
+{
+	cint_matrix A({ { "3+2i", "0", "5-6i" }, { "1", "4+2i", "i" }, { "4-i", "0", "4" } });
+	cint_matrix B({ { "5", "2-i", "6-4i" }, { "0", "4+5i", "2" }, { "7-4i", "2+7i", "0" } });
+	cint c("1+2i");
+
+	cint_matrix result = Lazy(A) - c * Lazy(B);
+	EXPECT_EQ(A - c * B, result);
+
+	result = -Conjugate(Lazy(A)) + Lazy(B) * c;
+	EXPECT_EQ(-A.Conjugate() + B * c, result);
+
+	cint_vector v({ "1", "2-i", "3i" });
+	cint_vector w = Lazy(A) * Lazy(v) - (Lazy(B) + Lazy(A)) * (c * Lazy(v));
+	EXPECT_EQ(A * v - (B + A) * (c * v), w);
+}
+
+TEST_F(cexpressionTest, inversion_about_mean) // same as in QC_Algorithms_Test, see page 198
+{
+	cdouble_vector V({ 53, 38, 17, 23, 79 });
+	cdouble_matrix A(5, 5, cdouble(1.0 / 5));
+
+	cdouble_vector Vprime = -Lazy(V) + 2.0 * (Lazy(A) * Lazy(V));
+	EXPECT_EQ(cdouble_vector({ 31, 46, 67, 61, 5 }), Vprime);
+}
+
+TEST_F(cexpressionTest, Large_vector)
+{
+	const size_t n = 1 << 18;
+	cdouble_vector a(n, cdouble(1, 2)), b(n, cdouble(-3, 0.5));
+
+	cdouble_vector result = Lazy(a) * cdouble(2) - Lazy(b);
+
+	EXPECT_EQ(n, result.size());
+	EXPECT_EQ(a * cdouble(2) - b, result);
+}
@@ -0,0 +1,128 @@
+#include <gtest\gtest.h>
+#include <cstdint>
+
+#include "cflatmatrix.h"
+
+using namespace testing;
+
+class cflatmatrixTest : public Test
+{
+public:
+	cflatmatrixTest() = default;
+};
+
+
+namespace
+{
+	std::vector<std::vector<std::string>> MATRIX_DATA_MULTIPLY_A // from 2.33
+	(
+		{ { "3+2i", "0", "5-6i" },{ "1", "4+2i", "i" },{ "4-i", "0", "4" } }
+	);
+	std::vector<std::vector<std::string>> MATRIX_DATA_MULTIPLY_B
+	(
+		{ { "5", "2-i", "6-4i" },{ "0", "4+5i", "2" },{ "7-4i", "2+7i", "0" } }
+	);
+	std::vector<std::vector<std::string>> MATRIX_DATA_MULTIPLY_AB
+	(
+		{ { "26-52i", "60+24i", "26" },{ "9+7i", "1+29i", "14" },{ "48-21i", "15+22i", "20-22i" } }
+	);
+}
+
+
+TEST_F(cflatmatrixTest, Layout)
+{
+	cdouble_flat_matrix m(3, 5, cdouble(1, 1));
+
+	EXPECT_EQ(3, m.Rows());
+	EXPECT_EQ(5, m.Cols());
+	EXPECT_LE(m.Cols(), m.Stride());
+	EXPECT_EQ(0, m.Stride() * sizeof(cdouble) % cdouble_flat_matrix::ALIGNMENT);
+
+	for (size_t i = 0; i < m.Rows(); i++)
+	{
+		EXPECT_EQ(0, reinterpret_cast<uintptr_t>(m[i]) % cdouble_flat_matrix::ALIGNMENT);
+		EXPECT_EQ(&m(i, 0), m.Data() + i * m.Stride());
+
+		for (size_t j = m.Cols(); j < m.Stride(); j++)
+			EXPECT_EQ(cdouble(), m[i][j]); // padding is not touched by the initial value
+	}
+}
+
+TEST_F(cflatmatrixTest, FromMatrix_ToMatrix)
+{
+	cint_matrix A(MATRIX_DATA_MULTIPLY_A);
+	cint_flat_matrix F(A);
+
+	ASSERT_EQ(3, F.Rows());
+	ASSERT_EQ(3, F.Cols());
+	EXPECT_EQ(cint("4+2i"), F(1, 1));
+	EXPECT_EQ(cint("4-i"), F[2][0]);
+
+	EXPECT_EQ(A, F.ToMatrix());
+
+	cint_vector V({ "2+i", "3-4i", "23" });
+	F.FromVector(V);
+	EXPECT_EQ(3, F.Rows());
+	EXPECT_EQ(1, F.Cols());
+	EXPECT_EQ(V, F.ToVector());
+}
+
+TEST_F(cflatmatrixTest, Multiply)
+{
+	cint_flat_matrix A = cint_matrix(MATRIX_DATA_MULTIPLY_A), B = cint_matrix(MATRIX_DATA_MULTIPLY_B);
+
+	EXPECT_EQ(cint_flat_matrix(cint_matrix(MATRIX_DATA_MULTIPLY_AB)), A * B);
+	EXPECT_EQ((A * B).ToMatrix(), A.ToMatrix() * B.ToMatrix());
+	EXPECT_EQ((A * B).Adjoint(), B.Adjoint() * A.Adjoint());
+	EXPECT_EQ(A, A * cint_flat_matrix::CreateIdentityMatrix(3));
+
+	cint_vector v({ "1", "i", "2-i" });
+	EXPECT_EQ(A.ToMatrix() * v, A * v);
+
+	cint_vector result;
+	A.Multiply(v, result);
+	EXPECT_EQ(A.ToMatrix() * v, result);
+
+	EXPECT_ANY_THROW(A * cint_flat_matrix(2, 2));
+}
+
+TEST_F(cflatmatrixTest, ElementWise)
+{
+	cint_flat_matrix A = cint_matrix(MATRIX_DATA_MULTIPLY_A), B = cint_matrix(MATRIX_DATA_MULTIPLY_B);
+	cint c("2-3i");
+
+	EXPECT_EQ((A + B).ToMatrix(), A.ToMatrix() + B.ToMatrix());
+	EXPECT_EQ(A, (A + B) - B);
+	EXPECT_EQ(cint_flat_matrix::CreateZeroMatrix(3, 3), A + (-A));
+	EXPECT_EQ((c * A).ToMatrix(), c * A.ToMatrix());
+	EXPECT_EQ(A.Conjugate().ToMatrix(), A.ToMatrix().Conjugate());
+	EXPECT_EQ(A.ToMatrix().Trace(), A.Trace());
+}
+
+TEST_F(cflatmatrixTest, Transpose)
+{
+	cint_flat_matrix m(40, 70);
+	for (size_t i = 0; i < m.Rows(); i++)
+		for (size_t j = 0; j < m.Cols(); j++)
+			m(i, j) = cint(static_cast<int>(i), static_cast<int>(j));
+
+	cint_flat_matrix t = m.Transpose();
+	ASSERT_EQ(70, t.Rows());
+	ASSERT_EQ(40, t.Cols());
+	EXPECT_EQ(m.ToMatrix().Transpose(), t.ToMatrix());
+	EXPECT_EQ(m, t.Transpose());
+}
+
+TEST_F(cflatmatrixTest, TensorProduct)
+{
+	cint_flat_matrix A = cint_matrix(MATRIX_DATA_MULTIPLY_A), B = cint_matrix(MATRIX_DATA_MULTIPLY_B);
+	EXPECT_EQ(A.ToMatrix().TensorProduct(B.ToMatrix()), A.TensorProduct(B).ToMatrix());
+
+	cint_flat_matrix row(cint_matrix({ { "1", "2", "3" } })); // rectangular factors
+	cint_flat_matrix col(cint_matrix(std::vector<std::vector<std::string>>({ { "1" }, { "i" } })));
+
+	cint_flat_matrix P = row.TensorProduct(col);
+	ASSERT_EQ(2, P.Rows());
+	ASSERT_EQ(3, P.Cols());
+	EXPECT_EQ(cint_matrix(std::vector<std::vector<std::string>>({ { "1", "2", "3" }, { "i", "2i", "3i" } })), P.ToMatrix());
+}
@@ -0,0 +1,79 @@
+#include <gtest\gtest.h>
+
+#include "cmatrix.h"
+#include "complex_kernels.h"
+#include "matrix_constants.h"
+#include "qc_algorithms.h"
+#include "state_vector.h"
+#include "test_util.h"
+
+using namespace testing;
+
+class cfloatTest : public Test
+{
+public:
+	cfloatTest() = default;
+};
+
+TEST_F(cfloatTest, Parse_and_convert)
+{
+	cfloat c("1.5-2i");
+	EXPECT_EQ(cfloat(1.5f, -2.0f), c);
+
+	cdouble d(c);
+	EXPECT_EQ(cdouble(1.5, -2.0), d);
+	EXPECT_EQ(c, cfloat(d));
+
+	cfloat third(cdouble(1.0 / 3));
+	EXPECT_TRUE(third.NearEquals(cfloat(1.0f / 3)));
+	EXPECT_FALSE(cfloat(1.0f).NearEquals(cfloat(1.001f)));
+}
+
+TEST_F(cfloatTest, Convert_vectors_and_matrices)
+{
+	cdouble_vector v = CreateTestState(3, true);
+	cfloat_vector vf(v);
+
+	ASSERT_EQ(v.size(), vf.size());
+	EXPECT_TRUE(cdouble_vector(vf).NearEquals(v, 1e-6));
+
+	cfloat_matrix hf(MatrixConstants::HADAMARD);
+	EXPECT_TRUE(hf.IsUnitary());
+	EXPECT_TRUE(cdouble_matrix(hf).NearEquals(MatrixConstants::HADAMARD, 1e-6));
+}
+
+TEST_F(cfloatTest, Sums_accumulate_in_double)
+{ // 2^24 + 1 is not representable in float, so a float accumulator would stop growing at 2^24
+	const size_t n = (size_t(1) << 24) + 1024;
+	cfloat_vector v(n, cfloat(1.0f));
+
+	EXPECT_EQ(double(n), ComplexKernels::SumModulusSquared(v.data(), n));
+	EXPECT_EQ(cfloat(float(n)), ComplexKernels::Dot(v.data(), v.data(), n));
+	EXPECT_EQ(float(n), v.NormSquare().Real());
+}
+
+TEST_F(cfloatTest, Gates_match_double_precision)
+{
+	const size_t qubitCount = 10;
+	cdouble_vector state = CreateTestState(qubitCount, true);
+	cfloat_vector statef(state);
+
+	for (size_t qubit = 0; qubit < qubitCount; qubit++)
+	{
+		StateVector::ApplyGate(state, MatrixConstants::HADAMARD, qubit);
+		StateVector::ApplyGate(statef, cfloat_matrix(MatrixConstants::HADAMARD), qubit);
+	}
+
+	StateVector::ApplyControlledX(state, { 0, 3 }, 7);
+	StateVector::ApplyControlledX(statef, { 0, 3 }, 7);
+
+	EXPECT_TRUE(cdouble_vector(statef).NearEquals(state, 1e-5));
+	EXPECT_NEAR(1.0, statef.NormSquare().Real(), 1e-6);
+
+	std::vector<double> probabilities = QC_Algorithms::MeasurementProbabilitiesVector(state);
+	std::vector<double> probabilitiesf = QC_Algorithms::MeasurementProbabilitiesVector(statef);
+
+	ASSERT_EQ(probabilities.size(), probabilitiesf.size());
+	for (size_t i = 0; i < probabilities.size(); i++)
+		EXPECT_NEAR(probabilities[i], probabilitiesf[i], 1e-6);
+}
@@ -0,0 +1,75 @@
+#include <gtest\gtest.h>
+
+#include "ckronecker.h"
+#include "matrix_constants.h"
+#include "qc_algorithms.h"
+
+using namespace testing;
+
+class ckroneckerTest : public Test
+{
+public:
+	ckroneckerTest() = default;
+};
+
+
+TEST_F(ckroneckerTest, Sizes)
+{
+	cint_kronecker_operator K;
+	EXPECT_EQ(1, K.Rows());
+	EXPECT_EQ(1, K.Cols());
+
+	K.Append(cint_matrix({ { "1", "2", "3" } })).AppendIdentity(4);
+	EXPECT_EQ(2, K.FactorCount());
+	EXPECT_EQ(4, K.Rows());
+	EXPECT_EQ(12, K.Cols());
+
+	EXPECT_ANY_THROW(K.AppendIdentity(0));
+	EXPECT_ANY_THROW(K * cint_vector(5));
+}
+
+TEST_F(ckroneckerTest, Multiply_matches_dense_product)
+{
+	cint_matrix A({ { "1", "2", "3" } }); // 1x3
+	cint_matrix B(std::vector<std::vector<std::string>>({ { "1", "i" }, { "2", "0" } }));
+	cint_matrix C({ { "1-i" }, { "3" }, { "2i" } }); // 3x1
+
+	cint_kronecker_operator K(B);
+	K.Append(A).AppendIdentity(2).Append(C);
+
+	cint_matrix dense = B.TensorProduct(A).TensorProduct(cint_matrix::CreateIdentityMatrix(2)).TensorProduct(C);
+	EXPECT_EQ(dense, K.ToMatrix());
+
+	cint_vector v(K.Cols());
+	for (size_t i = 0; i < v.size(); i++)
+		v[i] = cint(static_cast<int>(i % 5) - 2, static_cast<int>(i % 3));
+
+	cint_vector expected = dense * v;
+	EXPECT_EQ(expected, K * v);
+
+	K.Multiply(v, v); // output may be the input
+	EXPECT_EQ(expected, v);
+}
+
+TEST_F(ckroneckerTest, TensorProduct)
+{
+	cint_matrix B(std::vector<std::vector<std::string>>({ { "1", "i" }, { "2", "0" } }));
+
+	cint_kronecker_operator left(B), right(B);
+	right.AppendIdentity(3);
+
+	cint_kronecker_operator K = left.TensorProduct(right).TensorProduct(B);
+	EXPECT_EQ(4, K.FactorCount());
+	EXPECT_EQ(B.TensorProduct(B).TensorProduct(cint_matrix::CreateIdentityMatrix(3)).TensorProduct(B), K.ToMatrix());
+}
+
+TEST_F(ckroneckerTest, exercise_7_2_4) // same first step as in QC_Algorithms_Test, without building the 4x4 operator
+{
+	cdouble_vector R = QC_Algorithms::CreateQubitStateVectorAndInitializeToZero(2);
+
+	cdouble_kronecker_operator U(MatrixConstants::HADAMARD);
+	U.AppendIdentity(2);
+
+	cdouble_matrix denseU = QC_Algorithms::HadamardMatrix(1).TensorProduct(cdouble_matrix::CreateIdentityMatrix(2));
+	EXPECT_EQ(denseU * R, U * R);
+}
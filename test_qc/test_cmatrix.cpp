@@ -2,6 +2,7 @@
 #include <iostream>
 
 #include "cmatrix.h"
+#include "gemm.h"
 #include "print_util.h"
 
 using namespace testing;
@@ -195,6 +196,100 @@ TEST_F(cmatrixTest, Multiply_matrix_invalid)
 	EXPECT_ANY_THROW(M1 * M2);
 }
 
+TEST_F(cmatrixTest, Multiply_vector)
+{
+	cint_matrix A(MATRIX_DATA_MULTIPLY_A);
+	cint_vector v({ "1", "2-i", "3i" });
+
+	cint_vector expected = (A * cint_matrix::CreateFromVector(v)).ToVector();
+	EXPECT_EQ(expected, A * v);
+
+	cint_vector result(7); // wrong size on purpose, it is resized
+	A.Multiply(v, result);
+	EXPECT_EQ(expected, result);
+
+	A.Multiply(v, v); // output may be the input
+	EXPECT_EQ(expected, v);
+
+	EXPECT_ANY_THROW(A * cint_vector({ std::string("1"), "2" }));
+}
+
+TEST_F(cmatrixTest, In_place_operations)
+{
+	cint_matrix A(MATRIX_DATA_MULTIPLY_A), B(MATRIX_DATA_MULTIPLY_B);
+	cint c("2-i");
+
+	cint_matrix M = A;
+	M += B;
+	EXPECT_EQ(A + B, M);
+	M -= A;
+	EXPECT_EQ(B, M);
+	M.AddScaled(c, A);
+	EXPECT_EQ(B + c * A, M);
+
+	M = A;
+	M *= c; // used to leave the matrix unchanged
+	EXPECT_EQ(A * c, M);
+
+	M = A;
+	M.ConjugateInPlace().InverseInPlace();
+	EXPECT_EQ(-A.Conjugate(), M);
+
+	M = A;
+	cint_matrix workspace;
+	M.MultiplyWith(B, workspace);
+	EXPECT_EQ(cint_matrix(MATRIX_DATA_MULTIPLY_AB), M);
+	M.MultiplyWith(B, workspace); // the old product's rows are reused for the next one
+	EXPECT_EQ(A * B * B, M);
+
+	M = A;
+	M *= M;
+	EXPECT_EQ(A * A, M);
+
+	EXPECT_ANY_THROW(M += cint_matrix(2, 3));
+}
+
+TEST_F(cmatrixTest, Rvalue_operations_reuse_storage)
+{
+	cint_matrix A(MATRIX_DATA_MULTIPLY_A), B(MATRIX_DATA_MULTIPLY_B);
+
+	cint_matrix temp = A;
+	const cint * row0 = temp[0].data();
+
+	cint_matrix result = std::move(temp) + B;
+	EXPECT_EQ(row0, result[0].data());
+	EXPECT_EQ(cint_matrix(MATRIX_DATA_MULTIPLY_A) + B, result);
+
+	result = (A * B).Conjugate() * cint(2);
+	EXPECT_EQ(cint(2) * cint_matrix(MATRIX_DATA_MULTIPLY_AB).Conjugate(), result);
+}
+
+TEST_F(cmatrixTest, Large_products_reuse_the_workspace_rows)
+{ // above the GEMM threshold the engine writes straight into the rows of the result
+	cint_matrix A(40, 40), B(40, 40);
+	for (size_t i = 0; i < 40; i++)
+		for (size_t j = 0; j < 40; j++)
+		{
+			A[i][j] = cint(static_cast<int>(i + 2 * j) % 5 - 2, static_cast<int>(i * j) % 3 - 1);
+			B[i][j] = cint(static_cast<int>(3 * i + j) % 7 - 3, static_cast<int>(i + j) % 2);
+		}
+	ASSERT_FALSE(Gemm::IsSmall(40, 40, 40));
+
+	cint_matrix expected(40, 40);
+	for (size_t i = 0; i < 40; i++)
+		for (size_t k = 0; k < 40; k++)
+			for (size_t j = 0; j < 40; j++)
+				expected[i][j] += A[i][k] * B[k][j];
+
+	cint_matrix result(40, 40);
+	const cint * row0 = result[0].data();
+
+	A.Multiply(B, result);
+	EXPECT_EQ(expected, result);
+	EXPECT_EQ(row0, result[0].data());
+	EXPECT_EQ(expected * B, (A * B).MultiplyWith(B, result));
+}
+
 TEST_F(cmatrixTest, Power)
 {
 	cint_matrix M({ // 3.4
@@ -233,6 +328,46 @@ TEST_F(cmatrixTest, Power)
 	EXPECT_EQ(M, M.Power(1));
 }
 
+TEST_F(cmatrixTest, Power_large_exponent)
+{
+	cint_matrix A({ { "1", "i", "0" }, { "0", "1", "1" }, { "1", "0", "-i" } });
+
+	cint_matrix expected = cint_matrix::CreateIdentityMatrix(3);
+	for (size_t k = 0; k <= 13; k++)
+	{
+		EXPECT_EQ(expected, A.Power(k));
+		expected = expected * A;
+	}
+
+	EXPECT_ANY_THROW(cint_matrix(2, 3).Power(2));
+}
+
+TEST_F(cmatrixTest, ApplyPower)
+{
+	cint_matrix A({ { "1", "i", "0" }, { "0", "1", "1" }, { "1", "0", "-i" } });
+	cint_vector v({ "1", "2-i", "3i" });
+
+	for (size_t k : { 0, 1, 2, 5, 6, 7, 40 }) // both the repeated product and the squaring paths
+		EXPECT_EQ(A.Power(k) * v, A.ApplyPower(k, v));
+}
+
+TEST_F(cmatrixTest, Evolve_stops_early)
+{
+	cint_matrix P({ { "0", "0", "1" }, { "1", "0", "0" }, { "0", "1", "0" } }); // cyclic shift, period 3
+	cint_vector v({ "1", "2-i", "3i" });
+
+	size_t stepsDone = 0;
+	EXPECT_EQ(P.Power(1000) * v, P.Evolve(1000, v, 0, &stepsDone));
+	EXPECT_EQ(4, stepsDone); // one full period, then the remaining single step
+
+	cdouble_matrix averager(4, 4, cdouble(0.25)); // doubly stochastic, reaches its fixed point at once
+	cdouble_vector state({ 1, 0, 0, 0 });
+
+	cdouble_vector result = averager.Evolve(1000000, state, 1e-12, &stepsDone);
+	EXPECT_EQ(2, stepsDone);
+	EXPECT_TRUE(result.NearEquals(cdouble_vector(4, cdouble(0.25)), 1e-12));
+}
+
 TEST_F(cmatrixTest, Conjugate) // exercise 2.2.5
 {
 	cdouble_matrix m(MATRIX_DATA_2_2_5);
@@ -300,6 +435,25 @@ TEST_F(cmatrixTest, TensorProduct) // exercise 2.7.3
 	EXPECT_EQ(C, A.TensorProduct(B));
 }
 
+TEST_F(cmatrixTest, TensorProduct_rectangular)
+{
+	cint_matrix A({ { "1", "2", "3" } }); // 1x3
+	cint_matrix B(std::vector<std::vector<std::string>>({ { "1", "i" }, { "2", "0" } })); // 2x2
+
+	cint_matrix expected(std::vector<std::vector<std::string>>({
+		{ "1", "i", "2", "2i", "3", "3i" },
+		{ "2", "0", "4", "0", "6", "0" }
+		}));
+
+	EXPECT_EQ(expected, A.TensorProduct(B));
+	EXPECT_EQ(A.Transpose().TensorProduct(B.Transpose()), expected.Transpose());
+
+	cint_matrix H2 = B.TensorProduct(B); // 4x4 (x) 2x2, square factors of different sizes
+	EXPECT_EQ(cint(4), H2.TensorProduct(B)[6][0]);
+	EXPECT_EQ(cint(0, 1), H2.TensorProduct(B)[0][1]);
+	EXPECT_EQ(cint(0, -1), H2.TensorProduct(B)[0][7]);
+}
+
 
 TEST_F(cmatrixTest, exercise_2_4_6) // tests Norm
 {
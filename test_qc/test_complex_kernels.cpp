@@ -0,0 +1,130 @@
+#include <gtest\gtest.h>
+
+#include "complex_kernels.h"
+#include "cvector.h"
+#include "test_util.h"
+
+using namespace testing;
+
+class ComplexKernelsTest : public Test
+{
+public:
+	ComplexKernelsTest() = default;
+
+	static cdouble_vector ToDouble(const cint_vector & vector)
+	{
+		cdouble_vector result(vector.size());
+
+		for (size_t i = 0; i < vector.size(); i++)
+			result[i] = cdouble(vector[i].Real(), vector[i].Imag());
+
+		return result;
+	}
+
+	// lengths around the register widths, to exercise the scalar tails as well
+	const std::vector<size_t> m_lengths = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 100, 1001 };
+};
+
+
+TEST_F(ComplexKernelsTest, Dot_and_multiply_accumulate)
+{
+	for (size_t n : m_lengths)
+	{
+		cint_vector a = CreateTestVector<cint>(n, 1), b = CreateTestVector<cint>(n, 4);
+		cdouble_vector da = ToDouble(a), db = ToDouble(b);
+
+		cint dot, product;
+		for (size_t i = 0; i < n; i++)
+		{
+			dot += a[i].Conjugate() * b[i];
+			product += a[i] * b[i];
+		}
+
+		EXPECT_EQ(dot, ComplexKernels::Dot(a.data(), b.data(), n));
+		EXPECT_EQ(product, ComplexKernels::MultiplyAccumulate(a.data(), b.data(), n));
+		EXPECT_EQ(cdouble(dot.Real(), dot.Imag()), ComplexKernels::Dot(da.data(), db.data(), n));
+		EXPECT_EQ(cdouble(product.Real(), product.Imag()), ComplexKernels::MultiplyAccumulate(da.data(), db.data(), n));
+	}
+}
+
+TEST_F(ComplexKernelsTest, Element_wise)
+{
+	const cint alpha(3, -2);
+
+	for (size_t n : m_lengths)
+	{
+		cint_vector a = CreateTestVector<cint>(n, 2), b = CreateTestVector<cint>(n, 5);
+		cdouble_vector da = ToDouble(a), db = ToDouble(b), dy(n);
+
+		cint_vector sum(n), difference(n), scaled(n), axpy(b);
+		for (size_t i = 0; i < n; i++)
+		{
+			sum[i] = a[i] + b[i];
+			difference[i] = a[i] - b[i];
+			scaled[i] = alpha * a[i];
+			axpy[i] += alpha * a[i];
+		}
+
+		ComplexKernels::Add(da.data(), db.data(), dy.data(), n);
+		EXPECT_EQ(ToDouble(sum), dy);
+
+		ComplexKernels::Subtract(da.data(), db.data(), dy.data(), n);
+		EXPECT_EQ(ToDouble(difference), dy);
+
+		ComplexKernels::Scale(cdouble(3, -2), da.data(), dy.data(), n);
+		EXPECT_EQ(ToDouble(scaled), dy);
+
+		ComplexKernels::Axpy(cdouble(3, -2), da.data(), db.data(), n);
+		EXPECT_EQ(ToDouble(axpy), db);
+
+		cint_vector y(n);
+		ComplexKernels::Scale(alpha, a.data(), y.data(), n);
+		EXPECT_EQ(scaled, y);
+
+		ComplexKernels::Add(a.data(), a.data(), a.data(), n); // output may be one of the inputs
+		EXPECT_EQ(sum - b + sum - b, a);
+	}
+}
+
+TEST_F(ComplexKernelsTest, Butterfly)
+{
+	for (size_t n : m_lengths)
+	{
+		cint_vector a = CreateTestVector<cint>(n, 1), b = CreateTestVector<cint>(n, 4);
+		cint_vector sum = a + b, difference = a - b;
+
+		cdouble_vector da = ToDouble(a), db = ToDouble(b);
+		ComplexKernels::Butterfly(da.data(), db.data(), n);
+		EXPECT_EQ(ToDouble(sum), da);
+		EXPECT_EQ(ToDouble(difference), db);
+
+		ComplexKernels::Butterfly(a.data(), b.data(), n);
+		EXPECT_EQ(sum, a);
+		EXPECT_EQ(difference, b);
+	}
+}
+
+TEST_F(ComplexKernelsTest, Modulus_squared)
+{
+	for (size_t n : m_lengths)
+	{
+		cint_vector a = CreateTestVector<cint>(n, 3);
+		cdouble_vector da = ToDouble(a);
+
+		std::vector<double> expected(n), result(n);
+		double total = 0;
+
+		for (size_t i = 0; i < n; i++)
+		{
+			expected[i] = a[i].ModulusSquared();
+			total += expected[i];
+		}
+
+		ComplexKernels::ModulusSquared(da.data(), result.data(), n);
+		EXPECT_EQ(expected, result);
+		EXPECT_EQ(total, ComplexKernels::SumModulusSquared(da.data(), n));
+		EXPECT_EQ(total, ComplexKernels::SumModulusSquared(a.data(), n));
+	}
+
+	EXPECT_NE(nullptr, ComplexKernels::InstructionSet());
+}
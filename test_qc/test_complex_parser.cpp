@@ -0,0 +1,114 @@
+#include <gtest\gtest.h>
+
+#include "complex_parser.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace testing;
+
+class ComplexParserTest : public Test
+{
+public:
+	ComplexParserTest() = default;
+	~ComplexParserTest() { std::remove(m_path.c_str()); }
+
+	template <class F> static ComplexParser::parse_error CatchError(F parse)
+	{
+		try
+		{
+			parse();
+		}
+		catch (const ComplexParser::parse_error & error)
+		{
+			return error;
+		}
+
+		ADD_FAILURE() << "no parse_error";
+		return ComplexParser::parse_error("", 0, "");
+	}
+
+	const std::string m_path = "test_complex_parser.txt";
+};
+
+TEST_F(ComplexParserTest, Literals_as_in_the_book) // the notation of complex(const std::string &)
+{
+	for (const char * literal : { "3+14i", "0", "-1", "2-17i", "-34-17i", "3-i", "i", "-i", "47", "3i", "+5", "-7i", "4+i" })
+		EXPECT_EQ(cint(literal), ComplexParser::ParseValue<cint>(literal)) << literal;
+
+	EXPECT_EQ(cdouble(12.3, -45.6), ComplexParser::ParseValue<cdouble>("12.3-45.6i"));
+	EXPECT_EQ(cdouble(-0.5, 2e-3), ComplexParser::ParseValue<cdouble>(" -.5+2e-3i\n"));
+	EXPECT_EQ(cdouble(1e10, 0), ComplexParser::ParseValue<cdouble>("1E+10"));
+	EXPECT_EQ(cfloat(0.25f, -1.0f), ComplexParser::ParseValue<cfloat>("0.25-i"));
+	EXPECT_EQ(cint(-2147483647 - 1, 0), ComplexParser::ParseValue<cint>("-2147483648"));
+}
+
+TEST_F(ComplexParserTest, Vector)
+{
+	cdouble_vector expected({ cdouble(1, 2), cdouble(-3), cdouble(0, 4.5), cdouble(0, -1), cdouble(6, 1) });
+
+	EXPECT_EQ(expected, ComplexParser::ParseVector<cdouble>("1+2i, -3, 4.5i,\n-i\t6+i\n"));
+	EXPECT_EQ(expected, ComplexParser::ParseVector<cdouble>("1+2i\r\n-3\r\n4.5i\r\n-i\r\n6+i"));
+	EXPECT_TRUE(ComplexParser::ParseVector<cdouble>(" \n, ").empty());
+
+	cdouble_vector preallocated(5);
+	const cdouble * data = preallocated.data();
+
+	ComplexParser::ParseVector("1+2i -3 4.5i -i 6+i", preallocated);
+	EXPECT_EQ(expected, preallocated);
+	EXPECT_EQ(data, preallocated.data());
+
+	EXPECT_EQ(1, CatchError([&] { ComplexParser::ParseVector("1 2 3 4", preallocated); }).Line());
+	EXPECT_EQ(10, CatchError([&] { ComplexParser::ParseVector("1 2 3 4 5 6", preallocated); }).Offset());
+}
+
+TEST_F(ComplexParserTest, Matrix)
+{
+	cint_matrix expected({ { cint(1), cint(0, 1) }, { cint(2, -3), cint(-4) } });
+
+	EXPECT_EQ(expected, ComplexParser::ParseMatrix<cint>("1 i\n\n2-3i, -4\n"));
+
+	cint_matrix preallocated(2, 2);
+	ComplexParser::ParseMatrix("\n1 i\n2-3i -4", preallocated);
+	EXPECT_EQ(expected, preallocated);
+
+	ComplexParser::parse_error ragged = CatchError([] { ComplexParser::ParseMatrix<cint>("1 2\n3 4\n5\n"); });
+	EXPECT_EQ(3, ragged.Line());
+	EXPECT_EQ(1, ragged.Column());
+
+	EXPECT_EQ(2, CatchError([&] { ComplexParser::ParseMatrix("1 i\n2 3 4", preallocated); }).Line());
+	EXPECT_EQ(3, CatchError([&] { ComplexParser::ParseMatrix("1 i\n2 3\n4 5", preallocated); }).Line());
+	EXPECT_THROW(ComplexParser::ParseMatrix("1 i", preallocated), ComplexParser::parse_error);
+}
+
+TEST_F(ComplexParserTest, Error_locations)
+{
+	ComplexParser::parse_error error = CatchError([] { ComplexParser::ParseVector<cdouble>("1 2\n3+4 5"); });
+	EXPECT_EQ(2, error.Line());
+	EXPECT_EQ(4, error.Column());
+	EXPECT_EQ(7, error.Offset());
+	EXPECT_STREQ("line 2, column 4: expected 'i'", error.what());
+
+	EXPECT_EQ(1, CatchError([] { ComplexParser::ParseValue<cint>("1.5"); }).Offset()); // not an integer
+	EXPECT_EQ(1, CatchError([] { ComplexParser::ParseValue<cint>("+-1"); }).Offset());
+	EXPECT_EQ(4, CatchError([] { ComplexParser::ParseValue<cint>("3 + 4i"); }).Column());
+	EXPECT_EQ(0, CatchError([] { ComplexParser::ParseValue<cint>("99999999999"); }).Offset());
+	EXPECT_EQ(0, CatchError([] { ComplexParser::ParseValue<cdouble>("abc"); }).Offset());
+	EXPECT_EQ(2, CatchError([] { ComplexParser::ParseValue<cdouble>("2ij"); }).Offset());
+	EXPECT_EQ(0, CatchError([] { ComplexParser::ParseValue<cdouble>(""); }).Offset());
+	EXPECT_EQ(2, CatchError([] { ComplexParser::ParseValue<cdouble>("1 2"); }).Offset());
+}
+
+TEST_F(ComplexParserTest, Load)
+{
+	std::ofstream(m_path) << "1 2\n3 4i\n";
+
+	EXPECT_EQ(cdouble_matrix({ { cdouble(1), cdouble(2) }, { cdouble(3), cdouble(0, 4) } }), ComplexParser::LoadMatrix<cdouble>(m_path));
+	EXPECT_EQ(cdouble_vector({ cdouble(1), cdouble(2), cdouble(3), cdouble(0, 4) }), ComplexParser::LoadVector<cdouble>(m_path));
+
+	std::ofstream(m_path) << "1 2\n3 x\n";
+	EXPECT_STREQ((m_path + ", line 2, column 3: expected a number").c_str(), CatchError([&] { ComplexParser::LoadVector<cdouble>(m_path); }).what());
+
+	std::ofstream(m_path).close();
+	EXPECT_TRUE(ComplexParser::LoadVector<cdouble>(m_path).empty());
+}
@@ -0,0 +1,100 @@
+#include <gtest\gtest.h>
+
+#include "complex_writer.h"
+#include "complex_parser.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace testing;
+
+class complex_writerTest : public Test
+{
+public:
+	complex_writerTest() = default;
+	~complex_writerTest() { std::remove(m_path.c_str()); }
+
+	template <class V> static std::string ToText(const V & value, int format = complex_writer::BOOK, int precision = 0)
+	{
+		std::ostringstream stream;
+		complex_writer(stream, format, precision).Write(value);
+
+		return stream.str();
+	}
+
+	const std::string m_path = "test_complex_writer.txt";
+};
+
+TEST_F(complex_writerTest, Book_notation) // as complex::ToString
+{
+	for (const char * literal : { "3+14i", "0", "-1", "2-17i", "-34-17i", "3-i", "i", "-i", "47", "3i", "1" })
+		EXPECT_EQ(cint(literal).ToString(), ToText(cint(literal)));
+
+	EXPECT_EQ("12.3-45.6i", ToText(cdouble(12.3, -45.6)));
+	EXPECT_EQ("0.1", ToText(cdouble(0.1)));
+	EXPECT_EQ("0.1+0.2i", ToText(cfloat(0.1f, 0.2f)));
+	EXPECT_EQ("0.333", ToText(cdouble(1.0 / 3), complex_writer::BOOK, 3));
+	EXPECT_EQ("1e+100i", ToText(cdouble(0, 1e100)));
+}
+
+TEST_F(complex_writerTest, Vectors_and_matrices)
+{
+	cint_vector v({ cint(1, 2), cint(0, -1), cint(3) });
+	EXPECT_EQ("1+2i -i 3\n", ToText(v));
+	EXPECT_EQ("1,2\n0,-1\n3,0\n", ToText(v, complex_writer::CSV));
+
+	cint_matrix m({ { cint(1), cint(0, 1) }, { cint(2, -3), cint(-4) } });
+	EXPECT_EQ("1 i\n2-3i -4\n", ToText(m));
+	EXPECT_EQ("1,0,0,1\n2,-3,-4,0\n", ToText(m, complex_writer::CSV));
+
+	EXPECT_EQ("(2,0) (1,1.5707963267948966)\n", ToText(cdouble_vector({ cdouble(2), cdouble(0, 1) }), complex_writer::POLAR));
+	EXPECT_EQ("(5,0.927)\n", ToText(cint_vector({ cint(3, 4) }), complex_writer::POLAR, 3));
+
+	EXPECT_EQ("\n", ToText(cdouble_vector(0)));
+}
+
+TEST_F(complex_writerTest, Round_trip_through_the_parser)
+{ // larger than the buffer, so it is flushed on the way
+	cdouble_matrix m(300, 200);
+	for (size_t i = 0; i < m.Rows(); i++)
+		for (size_t j = 0; j < m.Cols(); j++)
+			m[i][j] = cdouble(1.0 / (1.0 + i), -double(j) / 7.0);
+
+	std::string text = ToText(m);
+	EXPECT_GT(text.size(), size_t(complex_writer::BUFFER_SIZE));
+
+	cdouble_matrix parsed = ComplexParser::ParseMatrix<cdouble>(text);
+	ASSERT_EQ(m.Rows(), parsed.Rows());
+	for (size_t i = 0; i < m.Rows(); i++)
+		for (size_t j = 0; j < m.Cols(); j++)
+		{
+			ASSERT_EQ(m[i][j].Real(), parsed[i][j].Real());
+			ASSERT_EQ(m[i][j].Imag(), parsed[i][j].Imag());
+		}
+}
+
+TEST_F(complex_writerTest, File_descriptor_and_settings)
+{
+	FILE * file = fopen(m_path.c_str(), "wb");
+	ASSERT_NE(nullptr, file);
+
+	{
+		complex_writer writer(fileno(file), complex_writer::CSV);
+		writer.Write("re,im\n").Write(cdouble_vector({ cdouble(0.5, -2) }));
+
+		writer.SetFormat(complex_writer::BOOK);
+		writer.SetPrecision(2);
+		writer.Write(cdouble(3.14159, 1)).Write("\n");
+
+		EXPECT_THROW(writer.SetFormat(3), std::invalid_argument);
+		EXPECT_THROW(writer.SetPrecision(-1), std::out_of_range);
+	}
+
+	fclose(file);
+
+	std::ifstream input(m_path, std::ios::binary);
+	std::stringstream content;
+	content << input.rdbuf();
+	EXPECT_EQ("re,im\n0.5,-2\n3.1+i\n", content.str());
+}
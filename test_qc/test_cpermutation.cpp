@@ -0,0 +1,78 @@
+#include <gtest\gtest.h>
+
+#include "cpermutation.h"
+#include "matrix_constants.h"
+
+using namespace testing;
+
+class cpermutationTest : public Test
+{
+public:
+	cpermutationTest() = default;
+};
+
+
+TEST_F(cpermutationTest, FromMatrix_ToMatrix)
+{
+	cdouble_permutation_operator P;
+	P.FromMatrix(MatrixConstants::CNOT);
+
+	EXPECT_EQ(std::vector<size_t>({ 0, 1, 3, 2 }), P.Targets());
+	EXPECT_EQ(MatrixConstants::CNOT, P.ToMatrix());
+
+	EXPECT_ANY_THROW(P.FromMatrix(MatrixConstants::HADAMARD));
+	EXPECT_ANY_THROW(P.FromMatrix(cdouble_matrix({ { 1, 1 }, { 0, 0 } })));
+	EXPECT_ANY_THROW(P.FromMatrix(cdouble_matrix({ { 1, 1e-17 }, { 0, 1 } }))); // not dropped as a zero
+	EXPECT_ANY_THROW(cdouble_permutation_operator(std::vector<size_t>({ 0, 0 })));
+	EXPECT_ANY_THROW(cdouble_permutation_operator(std::vector<size_t>({ 0, 2 })));
+}
+
+TEST_F(cpermutationTest, Multiply)
+{
+	cint_permutation_operator P(std::vector<size_t>({ 2, 0, 1 }));
+	cint_permutation_operator Q(std::vector<size_t>({ 1, 0, 2 }));
+	cint_matrix A = P.ToMatrix();
+	cint_matrix B({ { "5", "2-i", "6-4i" }, { "0", "4+5i", "2" }, { "7-4i", "2+7i", "0" } });
+	cint_vector v({ "1", "2-i", "3i" });
+
+	EXPECT_EQ(A * v, P * v);
+	EXPECT_EQ(A * B, P * B);
+	EXPECT_EQ(A * Q.ToMatrix(), (P * Q).ToMatrix());
+
+	P.Apply(v);
+	EXPECT_EQ(cint_vector({ "2-i", "3i", "1" }), v);
+}
+
+TEST_F(cpermutationTest, Invert_and_tensor_product)
+{
+	cint_permutation_operator P(std::vector<size_t>({ 2, 0, 3, 1 }));
+	cint_permutation_operator Q(std::vector<size_t>({ 1, 0 }));
+
+	EXPECT_EQ(cint_permutation_operator(4), P * P.Invert());
+	EXPECT_EQ(P.ToMatrix().Adjoint(), P.Adjoint().ToMatrix());
+	EXPECT_EQ(P.ToMatrix().TensorProduct(Q.ToMatrix()), P.TensorProduct(Q).ToMatrix());
+}
+
+TEST_F(cpermutationTest, Oracle) // the Uf matrix from pages 196-197, which finds '10'
+{
+	cdouble_matrix Uf
+		({
+			{ 1, 0, 0, 0, 0, 0, 0, 0 },
+			{ 0, 1, 0, 0, 0, 0, 0, 0 },
+			{ 0, 0, 1, 0, 0, 0, 0, 0 },
+			{ 0, 0, 0, 1, 0, 0, 0, 0 },
+			{ 0, 0, 0, 0, 0, 1, 0, 0 },
+			{ 0, 0, 0, 0, 1, 0, 0, 0 },
+			{ 0, 0, 0, 0, 0, 0, 1, 0 },
+			{ 0, 0, 0, 0, 0, 0, 0, 1 }
+		});
+
+	cdouble_permutation_operator oracle = cdouble_permutation_operator::CreateOracle(2, 1, [](size_t x) { return x == 2 ? 1 : 0; });
+	EXPECT_EQ(Uf, oracle.ToMatrix());
+	EXPECT_EQ(oracle, oracle.Invert());
+
+	cdouble_permutation_operator CNOT = cdouble_permutation_operator::CreateOracle(1, 1, [](size_t x) { return x; });
+	EXPECT_EQ(MatrixConstants::CNOT, CNOT.ToMatrix());
+
+	EXPECT_ANY_THROW(cdouble_permutation_operator::CreateOracle(1, 1, [](size_t) { return 2; }));
+}
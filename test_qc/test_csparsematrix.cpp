@@ -0,0 +1,118 @@
+#include <gtest\gtest.h>
+
+#include "csparsematrix.h"
+#include "matrix_constants.h"
+#include "qc_algorithms.h"
+
+using namespace testing;
+
+class csparsematrixTest : public Test
+{
+public:
+	csparsematrixTest() = default;
+};
+
+
+TEST_F(csparsematrixTest, FromMatrix_ToMatrix)
+{
+	cint_matrix A({ { "3+2i", "0", "5-6i" }, { "0", "0", "0" }, { "4-i", "0", "4" } });
+
+	cint_sparse_matrix S = A;
+	EXPECT_EQ(3, S.Rows());
+	EXPECT_EQ(3, S.Cols());
+	EXPECT_EQ(4, S.NonZeros());
+	EXPECT_EQ(A, S.ToMatrix());
+
+	EXPECT_EQ(cint("5-6i"), S.Get(0, 2));
+	EXPECT_EQ(cint(), S.Get(1, 1));
+	EXPECT_ANY_THROW(S.Get(3, 0));
+
+	EXPECT_ANY_THROW(cint_sparse_matrix(cint_matrix({ { 1, 2 }, { 3 } })));
+}
+
+TEST_F(csparsematrixTest, FromTriplets)
+{
+	cint_sparse_matrix S;
+	S.FromTriplets(2, 3, { { 1, 2, cint(4) }, { 0, 1, cint(1, 1) }, { 1, 0, cint(2) }, { 0, 1, cint(2) }, { 1, 1, cint(3) }, { 1, 1, cint(-3) } });
+
+	EXPECT_EQ(3, S.NonZeros()); // duplicates summed, the zero sum dropped
+	EXPECT_EQ(cint_matrix({ { "0", "3+i", "0" }, { "2", "0", "4" } }), S.ToMatrix());
+
+	EXPECT_ANY_THROW(S.FromTriplets(2, 2, { { 0, 2, cint(1) } }));
+}
+
+TEST_F(csparsematrixTest, Multiply_vector_and_matrix)
+{
+	cint_matrix A({ { "0", "1", "0", "0" }, { "2i", "0", "0", "3" }, { "0", "0", "0", "0" }, { "1-i", "0", "5", "0" } });
+	cint_matrix B({ { "1", "2", "3" }, { "i", "-i", "0" }, { "4", "0", "1+i" }, { "0", "7", "2" } });
+	cint_vector v({ "1", "2-i", "3i", "-4" });
+
+	cint_sparse_matrix S = A;
+
+	EXPECT_EQ(A * v, S * v);
+	EXPECT_EQ(A * B, S * B);
+	EXPECT_EQ(A * B, (S * cint_sparse_matrix(B)).ToMatrix());
+	EXPECT_EQ(cint_sparse_matrix(A * A), S * S);
+	EXPECT_EQ(A * cint(2, 1), (S * cint(2, 1)).ToMatrix());
+	EXPECT_EQ(0, (S * cint()).NonZeros());
+
+	cint_vector w(v);
+	S.Multiply(w, w); // result may be the input
+	EXPECT_EQ(A * v, w);
+
+	EXPECT_ANY_THROW(S * cint_vector(3));
+	EXPECT_ANY_THROW(S * cint_matrix(3, 3));
+}
+
+TEST_F(csparsematrixTest, Tiny_values_are_not_zeros)
+{ // small amplitudes, far below the epsilon cdouble's == allows, must survive the conversions and products
+	cdouble_matrix A({ { cdouble(1e-20), cdouble(0) }, { cdouble(0, -3e-18), cdouble(1) } });
+
+	cdouble_sparse_matrix S = A;
+	EXPECT_EQ(3, S.NonZeros());
+	EXPECT_EQ(1e-20, S.Get(0, 0).Real());
+
+	cdouble_sparse_matrix P = S * S;
+	EXPECT_EQ(3, P.NonZeros());
+	EXPECT_DOUBLE_EQ(1e-40, P.Get(0, 0).Real());
+	EXPECT_EQ(3, (S * cdouble(1e-30)).NonZeros());
+}
+
+TEST_F(csparsematrixTest, Transpose_and_adjoint)
+{
+	cint_matrix A({ { "0", "1+i", "0" }, { "2i", "0", "3" } });
+	cint_sparse_matrix S = A;
+
+	EXPECT_EQ(cint_sparse_matrix(A.Transpose()), S.Transpose());
+	EXPECT_EQ(cint_sparse_matrix(A.Adjoint()), S.Adjoint());
+}
+
+TEST_F(csparsematrixTest, TensorProduct)
+{
+	cint_matrix A({ { cint(1), cint(0) }, { cint(0, 1), cint(2) }, { cint(0), cint(-1) } });
+	cint_matrix B({ { "0", "3", "1-i" }, { "2", "0", "0" } });
+
+	cint_sparse_matrix result = cint_sparse_matrix(A).TensorProduct(B);
+
+	EXPECT_EQ(A.TensorProduct(B), result.ToMatrix());
+	EXPECT_EQ(cint_sparse_matrix(A.TensorProduct(B)), result);
+}
+
+TEST_F(csparsematrixTest, Phase_inversion_oracle) // the oracle from pages 196-197, padded with identities
+{
+	cdouble_sparse_matrix Uf;
+	Uf.FromTriplets(8, 8, { { 0, 0, 1 }, { 1, 1, 1 }, { 2, 2, 1 }, { 3, 3, 1 }, { 4, 5, 1 }, { 5, 4, 1 }, { 6, 6, 1 }, { 7, 7, 1 } });
+
+	cdouble_sparse_matrix padded = cdouble_sparse_matrix::CreateIdentityMatrix(4).TensorProduct(Uf).TensorProduct(cdouble_sparse_matrix(MatrixConstants::CNOT));
+	EXPECT_EQ(4 * 8 * 4, padded.NonZeros());
+
+	cdouble_matrix dense = cdouble_matrix::CreateIdentityMatrix(4).TensorProduct(Uf.ToMatrix()).TensorProduct(MatrixConstants::CNOT);
+	EXPECT_EQ(dense, padded.ToMatrix());
+
+	cdouble_vector state = QC_Algorithms::CreateQubitStateVectorAndInitializeToZero(7);
+	for (size_t i = 0; i < state.size(); i++)
+		state[i] = cdouble(static_cast<double>(i), 1);
+
+	EXPECT_EQ(dense * state, padded * state);
+	EXPECT_EQ(cdouble_sparse_matrix::CreateIdentityMatrix(128), padded * padded.Adjoint());
+}
@@ -234,6 +234,57 @@ TEST_F(cvectorTest, Normalize) // example 4.1.3
 	EXPECT_TRUE(normalized.NearEquals(v.Normalize(), 0.00001));
 }
 
+TEST_F(cvectorTest, In_place_operations)
+{
+	cint_vector a({ "5+13i", "6+2i", "-6i", "12" });
+	cint_vector b({ "7-8i", "4i", "2", "9+3i" });
+	cint c("2-i");
+
+	cint_vector v = a;
+	v += b;
+	EXPECT_EQ(a + b, v);
+	v -= a;
+	EXPECT_EQ(b, v);
+	v.AddScaled(c, a);
+	EXPECT_EQ(b + c * a, v);
+
+	v = a;
+	cint_vector & same = (v *= c);
+	EXPECT_EQ(&v, &same);
+	EXPECT_EQ(a * c, v);
+
+	v = a;
+	v.ConjugateInPlace().InverseInPlace();
+	EXPECT_EQ(-a.Conjugate(), v);
+
+	cdouble_vector d({ "2-3i", "1+2i", "-4i" });
+	cdouble_vector expected = d.Normalize();
+	d.NormalizeInPlace();
+	EXPECT_TRUE(expected.NearEquals(d, 1e-12));
+	EXPECT_NEAR(1.0, d.Norm().Real(), 1e-12);
+
+	EXPECT_ANY_THROW(v += cint_vector(3));
+}
+
+TEST_F(cvectorTest, Rvalue_operations_reuse_storage)
+{
+	cint_vector a({ "5+13i", "6+2i", "-6i", "12" });
+	cint_vector b({ "7-8i", "4i", "2", "9+3i" });
+
+	cint_vector temp = a;
+	const cint * data = temp.data();
+
+	cint_vector result = (std::move(temp) - b).Conjugate() * cint(3);
+	EXPECT_EQ(data, result.data());
+	EXPECT_EQ((a - b).Conjugate() * cint(3), result);
+
+	temp = a;
+	data = temp.data();
+	result = cint(2) * -std::move(temp);
+	EXPECT_EQ(data, result.data());
+	EXPECT_EQ(cint(-2) * a, result);
+}
+
 TEST_F(cvectorTest, example_4_1_4)
 {
 	cdouble_vector ket;
@@ -0,0 +1,150 @@
+#include <gtest\gtest.h>
+
+#include "density_matrix.h"
+#include "matrix_constants.h"
+#include "parallel.h"
+#include "state_vector.h"
+#include "test_util.h"
+
+using namespace testing;
+
+class density_matrixTest : public ThreadCountTest
+{
+public:
+	density_matrixTest() = default;
+
+	static cdouble_matrix Outer(const cdouble_vector & a, const cdouble_vector & b) // |a><b|
+	{
+		cdouble_matrix result(a.size(), b.size());
+
+		for (size_t i = 0; i < a.size(); i++)
+			for (size_t j = 0; j < b.size(); j++)
+				result[i][j] = a[i] * b[j].Conjugate();
+
+		return result;
+	}
+
+	static cdouble_matrix ApplyChannelDensely(const cdouble_density_matrix & rho, const std::vector<cdouble_matrix> & kraus, size_t qubit)
+	{ // sum of K rho K* with the dense operators I (x) ... (x) K (x) ... (x) I
+		const size_t n = rho.QubitCount();
+		cdouble_matrix result(rho.Size(), rho.Size());
+
+		for (const auto & k : kraus)
+		{
+			cdouble_matrix op({ { cdouble(1) } });
+			for (size_t q = 0; q < n; q++)
+				op = op.TensorProduct(q == qubit ? k : cdouble_matrix({ { cdouble(1), cdouble(0) }, { cdouble(0), cdouble(1) } }));
+
+			result = result + op * rho.ToMatrix() * op.Adjoint();
+		}
+
+		return result;
+	}
+};
+
+TEST_F(density_matrixTest, Pure_states)
+{
+	cdouble_vector state = CreateTestState(3, true);
+	cdouble_density_matrix rho(state);
+
+	EXPECT_TRUE(rho.ToMatrix().NearEquals(Outer(state, state), 1e-12));
+	EXPECT_EQ(36, rho.Packed().size());
+	EXPECT_NEAR(1, rho.Trace(), 1e-12);
+	EXPECT_NEAR(1, rho.Purity(), 1e-12);
+	EXPECT_NEAR(1, rho.Fidelity(state), 1e-12);
+	EXPECT_TRUE(rho(1, 6).NearEquals(state[1] * state[6].Conjugate(), 1e-12));
+
+	cdouble_density_matrix ground(3);
+	EXPECT_EQ(cdouble(1), ground(0, 0));
+	EXPECT_NEAR(state[0].ModulusSquared(), ground.Fidelity(state), 1e-12);
+
+	EXPECT_TRUE(cdouble_density_matrix(rho.ToMatrix()).ToMatrix().NearEquals(rho.ToMatrix(), 1e-15));
+}
+
+TEST_F(density_matrixTest, Gates_match_the_state_vector)
+{
+	Parallel::SetThreadCount(4);
+
+	const size_t qubitCount = 6;
+	cdouble_vector state = CreateTestState(qubitCount, true);
+	cdouble_density_matrix rho(state);
+
+	for (size_t qubit = 0; qubit < qubitCount; qubit++)
+	{
+		StateVector::ApplyGate(state, MatrixConstants::SQRT_NOT, qubit);
+		rho.ApplyGate(MatrixConstants::SQRT_NOT, qubit);
+	}
+
+	StateVector::ApplyControlledGate(state, MatrixConstants::HADAMARD, { 0, 4 }, 2);
+	rho.ApplyControlledGate(MatrixConstants::HADAMARD, { 0, 4 }, 2);
+
+	StateVector::ApplyCNOT(state, 5, 1);
+	rho.ApplyControlledGate(cdouble_matrix({ { cdouble(0), cdouble(1) }, { cdouble(1), cdouble(0) } }), { 5 }, 1);
+
+	EXPECT_TRUE(rho.ToMatrix().NearEquals(Outer(state, state), 1e-12));
+	EXPECT_THROW(rho.ApplyControlledGate(MatrixConstants::HADAMARD, { 1 }, 1), std::invalid_argument);
+	EXPECT_THROW(rho.ApplyGate(MatrixConstants::HADAMARD, 6), std::out_of_range);
+}
+
+TEST_F(density_matrixTest, Channels_match_the_Kraus_sum)
+{
+	const size_t qubitCount = 3;
+	const cdouble_vector state = CreateTestState(qubitCount, true);
+
+	const std::vector<std::vector<cdouble_matrix>> channels = {
+		cdouble_density_matrix::DepolarizingChannel(0.3),
+		cdouble_density_matrix::AmplitudeDampingChannel(0.25),
+		cdouble_density_matrix::PhaseDampingChannel(0.6) };
+
+	for (const auto & channel : channels)
+		for (size_t qubit = 0; qubit < qubitCount; qubit++)
+		{
+			cdouble_density_matrix rho(state);
+			cdouble_matrix expected = ApplyChannelDensely(rho, channel, qubit);
+
+			rho.ApplyChannel(channel, qubit);
+			EXPECT_TRUE(rho.ToMatrix().NearEquals(expected, 1e-12));
+			EXPECT_NEAR(1, rho.Trace(), 1e-12);
+			EXPECT_LT(rho.Purity(), 1);
+		}
+}
+
+TEST_F(density_matrixTest, Noise)
+{
+	cdouble_density_matrix rho(1);
+	rho.ApplyGate(MatrixConstants::HADAMARD, 0); // |+>
+
+	rho.ApplyPhaseDamping(0.36, 0); // the coherences shrink by 0.8
+	EXPECT_TRUE(rho(1, 0).NearEquals(cdouble(0.4), 1e-12));
+	EXPECT_NEAR(0.5, rho.MeasurementProbabilities()[1], 1e-12);
+
+	rho.ApplyDepolarizing(1, 0); // fully mixed
+	EXPECT_NEAR(0.5, rho.Purity(), 1e-12);
+
+	cdouble_density_matrix excited(cdouble_vector({ cdouble(0), cdouble(1) }));
+	excited.ApplyAmplitudeDamping(0.1, 0);
+	excited.ApplyAmplitudeDamping(0.1, 0);
+	EXPECT_NEAR(0.81, excited.MeasurementProbabilities()[1], 1e-12);
+
+	EXPECT_THROW(cdouble_density_matrix::DepolarizingChannel(1.5), std::out_of_range);
+}
+
+TEST_F(density_matrixTest, Single_precision)
+{
+	const size_t qubitCount = 5;
+	cdouble_vector state = CreateTestState(qubitCount, true);
+
+	cdouble_density_matrix rho(state);
+	cfloat_density_matrix rhof((cfloat_vector(state)));
+
+	for (size_t qubit = 0; qubit < qubitCount; qubit++)
+	{
+		rho.ApplyGate(MatrixConstants::HADAMARD, qubit);
+		rhof.ApplyGate(cfloat_matrix(MatrixConstants::HADAMARD), qubit);
+		rho.ApplyAmplitudeDamping(0.05, qubit);
+		rhof.ApplyAmplitudeDamping(0.05, qubit);
+	}
+
+	EXPECT_TRUE(cdouble_matrix(rhof.ToMatrix()).NearEquals(rho.ToMatrix(), 1e-6));
+	EXPECT_NEAR(rho.Purity(), rhof.Purity(), 1e-5);
+}
@@ -0,0 +1,85 @@
+#include <gtest\gtest.h>
+
+#include "fft.h"
+#include "parallel.h"
+#include "test_util.h"
+
+using namespace testing;
+
+class FFTTest : public ThreadCountTest
+{
+public:
+	FFTTest() = default;
+
+	static cdouble_vector NaiveTransform(const cdouble_vector & data, int sign, double scale)
+	{
+		const double pi = 3.14159265358979323846;
+		const size_t n = data.size();
+
+		cdouble_vector result(n);
+
+		for (size_t k = 0; k < n; k++)
+			for (size_t j = 0; j < n; j++)
+			{
+				cdouble w;
+				w.FromPolar(scale, sign * 2 * pi * double((j * k) % n) / double(n));
+
+				result[k] += data[j] * w;
+			}
+
+		return result;
+	}
+};
+
+TEST_F(FFTTest, Matches_the_definition)
+{
+	for (size_t size = 1; size <= 256; size *= 2)
+		for (int sign : { FFT::FORWARD, FFT::BACKWARD })
+		{
+			cdouble_vector data = CreateTestVector<cdouble>(size);
+			cdouble_vector expected = NaiveTransform(data, sign, 0.5);
+
+			FFT::Transform(data, sign, 0.5);
+			EXPECT_TRUE(data.NearEquals(expected, 1e-9)) << "size " << size << ", sign " << sign;
+		}
+}
+
+TEST_F(FFTTest, Twiddles)
+{
+	auto twiddles = FFT::Twiddles(8);
+	ASSERT_EQ(4, twiddles->size()); // the tables of the other tests are gone with them
+
+	const size_t stride = twiddles->size() / 4;
+	EXPECT_TRUE((*twiddles)[0].NearEquals(cdouble(1, 0), 1e-15));
+	EXPECT_TRUE((*twiddles)[2 * stride].NearEquals(cdouble(0, -1), 1e-15));
+	EXPECT_EQ(twiddles, FFT::Twiddles(8)); // computed once
+	EXPECT_EQ(twiddles, FFT::Twiddles(4)); // smaller sizes share it
+
+	auto larger = FFT::Twiddles(8 * twiddles->size());
+	ASSERT_EQ(4 * twiddles->size(), larger->size());
+	EXPECT_EQ(larger, FFT::Twiddles(8)); // the smaller table is not kept
+	EXPECT_TRUE((*larger)[larger->size() / 2].NearEquals(cdouble(0, -1), 1e-15));
+
+	twiddles.reset();
+	larger.reset();
+	EXPECT_EQ(4, FFT::Twiddles(8)->size()); // the large table went with its last user
+}
+
+TEST_F(FFTTest, Round_trip_in_parallel)
+{
+	Parallel::SetThreadCount(4);
+
+	const size_t size = size_t(1) << 17;
+	cdouble_vector data = CreateTestVector<cdouble>(size);
+
+	FFT::Transform(data, FFT::FORWARD);
+	FFT::Transform(data, FFT::BACKWARD, 1.0 / size);
+
+	EXPECT_TRUE(data.NearEquals(CreateTestVector<cdouble>(size), 1e-9));
+}
+
+TEST_F(FFTTest, Size_must_be_a_power_of_2)
+{
+	cdouble_vector data(12);
+	EXPECT_THROW(FFT::Transform(data, FFT::FORWARD), std::out_of_range);
+}
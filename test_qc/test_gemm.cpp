@@ -0,0 +1,76 @@
+#include <gtest\gtest.h>
+
+#include "gemm.h"
+#include "cflatmatrix.h"
+#include "parallel.h"
+#include "test_util.h"
+
+using namespace testing;
+
+class GemmTest : public ThreadCountTest
+{
+public:
+	GemmTest() = default;
+
+	template <class T> static complex_flat_matrix<T> MultiplyNaive(const complex_flat_matrix<T> & a, const complex_flat_matrix<T> & b)
+	{
+		complex_flat_matrix<T> result(a.Rows(), b.Cols());
+		Gemm::MultiplyNaive(a.Rows(), a.Cols(), b.Cols(), a.Data(), a.Stride(), b.Data(), b.Stride(), result.Data(), result.Stride());
+		return result;
+	}
+};
+
+
+TEST_F(GemmTest, Tiled_matches_naive)
+{
+	const size_t sizes[][3] = { { 1, 1, 1 }, { 3, 5, 2 }, { 65, 129, 67 }, { 131, 257, 600 }, { 200, 1, 300 } };
+
+	for (const auto & size : sizes)
+	{
+		cint_flat_matrix A = CreateTestMatrix<cint>(size[0], size[1], 1);
+		cint_flat_matrix B = CreateTestMatrix<cint>(size[1], size[2], 2);
+
+		EXPECT_EQ(MultiplyNaive(A, B), A * B);
+	}
+
+	cdouble_flat_matrix A = CreateTestMatrix<cdouble>(150, 170, 3);
+	cdouble_flat_matrix B = CreateTestMatrix<cdouble>(170, 190, 4);
+
+	EXPECT_TRUE(MultiplyNaive(A, B).NearEquals(A * B, 1e-9));
+}
+
+TEST_F(GemmTest, Threads_share_the_packed_panels)
+{ // several panels of B in both directions, with the rows split across more threads than there are cores
+	cint_flat_matrix A = CreateTestMatrix<cint>(150, 260, 7);
+	cint_flat_matrix B = CreateTestMatrix<cint>(260, 600, 8);
+	cint_flat_matrix expected = MultiplyNaive(A, B);
+
+	for (size_t threads : { 1, 3, 8 })
+	{
+		Parallel::SetThreadCount(threads);
+		EXPECT_EQ(expected, A * B);
+	}
+}
+
+TEST_F(GemmTest, Large_complex_matrix)
+{
+	cdouble_matrix A = CreateTestMatrix<cdouble>(96, 80, 5).ToMatrix();
+	cdouble_matrix B = CreateTestMatrix<cdouble>(80, 72, 6).ToMatrix();
+	ASSERT_FALSE(Gemm::IsSmall(A.Rows(), A.Cols(), B.Cols()));
+
+	cdouble_matrix C = A * B;
+	ASSERT_EQ(96, C.Rows());
+	ASSERT_EQ(72, C.Cols());
+
+	for (size_t i = 0; i < C.Rows(); i += 13)
+		for (size_t j = 0; j < C.Cols(); j += 7)
+		{
+			cdouble sum;
+			for (size_t k = 0; k < A.Cols(); k++)
+				sum += A[i][k] * B[k][j];
+
+			EXPECT_EQ(sum, C[i][j]);
+		}
+
+	EXPECT_EQ(cdouble_matrix::CreateIdentityMatrix(96) * A, A);
+}
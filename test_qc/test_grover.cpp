@@ -0,0 +1,105 @@
+#include <gtest\gtest.h>
+
+#include "grover.h"
+#include "qc_algorithms.h"
+
+#include <tuple>
+
+using namespace testing;
+
+class GroverTest : public Test
+{
+public:
+	GroverTest() = default;
+
+	static double MarkedProbability(const cdouble_vector & state, const Grover::Oracle & oracle)
+	{
+		double result = 0;
+		for (size_t i = 0; i < state.size(); i++)
+			if (oracle.IsMarked(i))
+				result += state[i].ModulusSquared();
+
+		return result;
+	}
+};
+
+TEST_F(GroverTest, Oracle)
+{
+	Grover::Oracle list({ 6, 2, 6, 9 });
+	Grover::Oracle predicate([](size_t i) { return i % 4 == 2; });
+
+	EXPECT_TRUE(list.IsMarked(2));
+	EXPECT_FALSE(list.IsMarked(3));
+	EXPECT_EQ(3, list.MarkedCount(16)); // duplicates count once
+	EXPECT_EQ(2, list.MarkedCount(8));
+	EXPECT_EQ(4, predicate.MarkedCount(16));
+
+	std::vector<std::tuple<size_t, size_t, bool>> runs;
+	list.ForEachRun(1, 9, [&](size_t begin, size_t end, bool marked) { runs.emplace_back(begin, end, marked); });
+
+	std::vector<std::tuple<size_t, size_t, bool>> expected = { { 1, 2, false }, { 2, 3, true }, { 3, 6, false }, { 6, 7, true }, { 7, 9, false } };
+	EXPECT_EQ(expected, runs);
+
+	runs.clear();
+	predicate.ForEachRun(0, 7, [&](size_t begin, size_t end, bool marked) { runs.emplace_back(begin, end, marked); });
+
+	expected = { { 0, 2, false }, { 2, 3, true }, { 3, 6, false }, { 6, 7, true } };
+	EXPECT_EQ(expected, runs);
+
+	cdouble_vector v({ 1, 2, 3, 4, 5, 6, 7, 8 });
+	predicate.Apply(v);
+	EXPECT_EQ(cdouble_vector({ 1, 2, -3, 4, 5, 6, -7, 8 }), v);
+}
+
+TEST_F(GroverTest, InverseAboutMean) // see page 198
+{
+	cdouble_vector v({ 53, 38, 17, 23, 79 });
+	Grover::InverseAboutMean(v);
+
+	EXPECT_TRUE(v.NearEquals(cdouble_vector({ 31, 46, 67, 61, 5 }), 1e-12));
+}
+
+TEST_F(GroverTest, Iterate_matches_the_steps_of_the_book) // see the Grovers_algorithm test of QC_Algorithms
+{
+	cdouble_vector s(8, cdouble(1 / sqrt(8.0)));
+	cdouble_vector expected(s);
+
+	for (size_t iteration = 0; iteration < 2; iteration++)
+	{
+		expected[5] = -expected[5];
+		expected = QC_Algorithms::InverseAboutMean(expected);
+	}
+
+	Grover::Iterate(s, Grover::Oracle({ 5 }), 2);
+
+	EXPECT_TRUE(s.NearEquals(expected, 1e-12));
+	EXPECT_TRUE(s.NearEquals(cdouble_vector({ -0.08839, -0.08839, -0.08839, -0.08839, -0.08839, 0.97227, -0.08839, -0.08839 }), 0.0001));
+}
+
+TEST_F(GroverTest, OptimalIterations)
+{
+	EXPECT_EQ(2, Grover::OptimalIterations(8, 1));
+	EXPECT_EQ(1, Grover::OptimalIterations(4, 1)); // lands exactly on the marked state
+	EXPECT_EQ(804, Grover::OptimalIterations(size_t(1) << 20, 1));
+	EXPECT_EQ(0, Grover::OptimalIterations(16, 0));
+	EXPECT_EQ(0, Grover::OptimalIterations(16, 16));
+}
+
+TEST_F(GroverTest, Run)
+{
+	Grover::Oracle single({ 12345 });
+	cdouble_vector state = Grover::Run(16, single);
+
+	EXPECT_NEAR(1.0, state.NormSquare().Real(), 1e-9);
+	EXPECT_LT(0.999, MarkedProbability(state, single));
+
+	Grover::Oracle predicate([](size_t i) { return i % 1000 == 7; });
+	state = Grover::Run(14, predicate);
+
+	EXPECT_NEAR(1.0, state.NormSquare().Real(), 1e-9);
+	EXPECT_LT(0.99, MarkedProbability(state, predicate));
+
+	Grover::Oracle four({ 3 });
+	EXPECT_TRUE(Grover::Run(2, four).NearEquals(cdouble_vector({ 0, 0, 0, 1 }), 1e-12));
+	EXPECT_EQ(3, Grover::Search(2, four));
+}
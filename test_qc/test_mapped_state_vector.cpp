@@ -0,0 +1,97 @@
+#include <gtest\gtest.h>
+
+#include "mapped_state_vector.h"
+#include "matrix_constants.h"
+#include "parallel.h"
+#include "state_vector.h"
+#include "test_util.h"
+
+#include <cstdio>
+
+using namespace testing;
+
+class mapped_state_vectorTest : public ThreadCountTest
+{
+public:
+	mapped_state_vectorTest() = default;
+	~mapped_state_vectorTest() { std::remove(m_path.c_str()); }
+
+	const std::string m_path = "test_mapped_state_vector.bin";
+};
+
+TEST_F(mapped_state_vectorTest, Starts_in_the_ground_state)
+{
+	cdouble_mapped_state_vector state(m_path, 5);
+
+	EXPECT_EQ(5, state.QubitCount());
+	EXPECT_EQ(32, state.Size());
+	EXPECT_EQ(cdouble(1), state[0]);
+
+	cdouble_vector expected(32);
+	expected[0] = cdouble(1);
+	EXPECT_EQ(expected, state.ToVector());
+	EXPECT_EQ(cdouble(1), state.NormSquare());
+}
+
+TEST_F(mapped_state_vectorTest, Gates_match_StateVector_for_every_chunk_size)
+{ // with chunks of 2 to 1024 amplitudes, every qubit is once below and once above the chunk
+	Parallel::SetThreadCount(4);
+
+	const size_t qubitCount = 10;
+
+	for (size_t chunkBytes = 2 * sizeof(cdouble); chunkBytes <= (sizeof(cdouble) << qubitCount); chunkBytes *= 4)
+	{
+		cdouble_vector expected = CreateTestState(qubitCount);
+
+		cdouble_mapped_state_vector state(m_path, qubitCount, chunkBytes);
+		state.Load(expected);
+
+		for (size_t qubit = 0; qubit < qubitCount; qubit++)
+		{
+			StateVector::ApplyGate(expected, MatrixConstants::HADAMARD, qubit);
+			state.ApplyGate(MatrixConstants::HADAMARD, qubit);
+
+			StateVector::ApplyGate(expected, MatrixConstants::SQRT_NOT, qubitCount - 1 - qubit);
+			state.ApplyGate(MatrixConstants::SQRT_NOT, qubitCount - 1 - qubit);
+		}
+
+		StateVector::ApplyControlledGate(expected, MatrixConstants::SQRT_NOT, { 1, 8 }, 4);
+		state.ApplyControlledGate(MatrixConstants::SQRT_NOT, { 1, 8 }, 4);
+
+		StateVector::ApplyControlledX(expected, { 9 }, 0);
+		state.ApplyControlledX({ 9 }, 0);
+
+		EXPECT_TRUE(state.ToVector().NearEquals(expected, 1e-9)) << "chunk " << state.ChunkSize();
+		EXPECT_TRUE(state.NormSquare().NearEquals(expected.NormSquare(), 1e-6));
+	}
+}
+
+TEST_F(mapped_state_vectorTest, Reopen_and_measure)
+{
+	{
+		cfloat_mapped_state_vector state(m_path, 3);
+		state.ApplyGateToAll(cfloat_matrix(MatrixConstants::HADAMARD));
+		state.Flush();
+	}
+
+	cfloat_mapped_state_vector state = cfloat_mapped_state_vector::Open(m_path);
+	ASSERT_EQ(3, state.QubitCount());
+
+	std::vector<double> probabilities = state.MeasurementProbabilities(2, 4);
+	ASSERT_EQ(4, probabilities.size());
+	for (double p : probabilities)
+		EXPECT_NEAR(0.125, p, 1e-6);
+
+	EXPECT_THROW(state.MeasurementProbabilities(6, 4), std::out_of_range);
+	EXPECT_THROW(state.ApplyGate(cfloat_matrix(MatrixConstants::HADAMARD), 3), std::out_of_range);
+	EXPECT_THROW(state.ApplyControlledX({ 1 }, 1), std::invalid_argument);
+}
+
+TEST_F(mapped_state_vectorTest, Errors)
+{
+	EXPECT_THROW(cdouble_mapped_state_vector("no_such_directory/state.bin", 4), std::system_error);
+	EXPECT_THROW(cfloat_mapped_state_vector state(m_path, 64), std::out_of_range);
+
+	memory_mapped_file(m_path, 3 * sizeof(cdouble));
+	EXPECT_THROW(cdouble_mapped_state_vector::Open(m_path), std::out_of_range);
+}
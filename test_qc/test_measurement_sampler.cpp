@@ -0,0 +1,117 @@
+#include <gtest\gtest.h>
+
+#include "measurement_sampler.h"
+#include "parallel.h"
+#include "qc_algorithms.h"
+#include "test_util.h"
+
+using namespace testing;
+
+class MeasurementSamplerTest : public ThreadCountTest
+{
+public:
+	MeasurementSamplerTest() = default;
+};
+
+TEST_F(MeasurementSamplerTest, Probabilities)
+{
+	measurement_sampler sampler(cdouble_vector({ cdouble(1, 1), cdouble(0, 0), cdouble(2, 0), cdouble(0, -1) })); // not normalized
+
+	EXPECT_EQ(4, sampler.Size());
+	EXPECT_DOUBLE_EQ(2.0 / 7, sampler.Probability(0));
+	EXPECT_DOUBLE_EQ(0.0, sampler.Probability(1));
+	EXPECT_DOUBLE_EQ(4.0 / 7, sampler.Probability(2));
+	EXPECT_DOUBLE_EQ(1.0 / 7, sampler.Probability(3));
+
+	EXPECT_THROW(measurement_sampler(cdouble_vector(4)), std::invalid_argument);
+	EXPECT_THROW(measurement_sampler(cdouble_vector(0)), std::invalid_argument);
+	EXPECT_THROW(measurement_sampler(std::vector<double>({ 0.5, -0.5, 1.0 })), std::invalid_argument);
+}
+
+TEST_F(MeasurementSamplerTest, Histogram_follows_the_distribution)
+{
+	std::vector<double> weights = { 1, 0, 5, 2, 0, 0, 9, 3, 4, 0, 1, 7 };
+	double total = 32;
+
+	measurement_sampler sampler(weights);
+
+	const size_t shots = 1000000;
+	std::vector<size_t> histogram = sampler.Histogram(shots, 12345);
+
+	ASSERT_EQ(weights.size(), histogram.size());
+
+	size_t sum = 0;
+	for (size_t i = 0; i < weights.size(); i++)
+	{
+		sum += histogram[i];
+
+		if (weights[i] == 0)
+			EXPECT_EQ(0, histogram[i]);
+		else
+			EXPECT_NEAR(weights[i] / total, double(histogram[i]) / shots, 0.003); // more than 5 standard deviations
+	}
+
+	EXPECT_EQ(shots, sum);
+}
+
+TEST_F(MeasurementSamplerTest, SampleOnce_follows_the_distribution)
+{
+	cdouble_vector state({ cdouble(1, 1), cdouble(0, 0), cdouble(2, 0), cdouble(0, -1) }); // probabilities 2/7, 0, 4/7, 1/7
+	std::mt19937_64 generator(777);
+
+	const size_t shots = 100000;
+	std::vector<size_t> histogram(4);
+	for (size_t shot = 0; shot < shots; shot++)
+		histogram[measurement_sampler::SampleOnce(state, generator)]++;
+
+	EXPECT_EQ(0, histogram[1]);
+	EXPECT_NEAR(2.0 / 7, double(histogram[0]) / shots, 0.008); // more than 5 standard deviations
+	EXPECT_NEAR(4.0 / 7, double(histogram[2]) / shots, 0.008);
+	EXPECT_NEAR(1.0 / 7, double(histogram[3]) / shots, 0.008);
+
+	for (size_t shot = 0; shot < 1000; shot++) // Measure takes single shots the same way
+		EXPECT_NE(1, QC_Algorithms::Measure(state));
+
+	EXPECT_THROW(measurement_sampler::SampleOnce(cdouble_vector(4), generator), std::invalid_argument);
+	EXPECT_THROW(QC_Algorithms::Measure(cdouble_vector(4)), std::invalid_argument);
+}
+
+TEST_F(MeasurementSamplerTest, Certain_outcome)
+{
+	cdouble_vector state(16);
+	state[11] = cdouble(0, 1);
+
+	measurement_sampler sampler(state);
+
+	for (size_t shot : sampler.Sample(1000))
+		EXPECT_EQ(11, shot);
+
+	EXPECT_EQ(11, sampler.Sample());
+	EXPECT_EQ(11, QC_Algorithms::Measure(state));
+}
+
+TEST_F(MeasurementSamplerTest, Results_do_not_depend_on_thread_count)
+{
+	cdouble_vector state(64);
+	for (size_t i = 0; i < state.size(); i++)
+		state[i] = cdouble(double(i % 5), double(i % 3));
+
+	measurement_sampler sampler(state);
+	const size_t shots = 3 * measurement_sampler::SHOTS_PER_BLOCK + 17;
+
+	Parallel::SetThreadCount(1);
+	std::vector<size_t> serial = sampler.Sample(shots, 42);
+	std::vector<size_t> serialHistogram = sampler.Histogram(shots, 42);
+
+	Parallel::SetThreadCount(4);
+	EXPECT_EQ(serial, sampler.Sample(shots, 42));
+	EXPECT_EQ(serialHistogram, sampler.Histogram(shots, 42));
+
+	std::vector<size_t> counted(state.size());
+	for (size_t shot : serial)
+		counted[shot]++;
+
+	EXPECT_EQ(counted, serialHistogram); // the histogram counts the very same shots
+
+	EXPECT_NE(serial, sampler.Sample(shots, 43));
+}
@@ -0,0 +1,157 @@
+#include <gtest\gtest.h>
+
+#include "parallel.h"
+#include "state_vector.h"
+#include "qc_algorithms.h"
+#include "matrix_constants.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <tuple>
+
+using namespace testing;
+
+class ParallelTest : public ThreadCountTest
+{
+public:
+	ParallelTest() = default;
+};
+
+TEST_F(ParallelTest, SetThreadCount)
+{
+	Parallel::SetThreadCount(3);
+	EXPECT_EQ(3, Parallel::ThreadCount());
+
+	Parallel::SetThreadCount(1);
+	EXPECT_EQ(1, Parallel::ThreadCount());
+
+	Parallel::SetThreadCount(0);
+	EXPECT_LE(1, Parallel::ThreadCount());
+}
+
+TEST_F(ParallelTest, ForVisitsEveryIndexOnce)
+{
+	Parallel::SetThreadCount(4);
+
+	const size_t n = 10007;
+	std::vector<std::atomic<int>> visits(n);
+	for (auto & visit : visits)
+		visit = 0;
+
+	std::atomic<size_t> chunks(0);
+
+	Parallel::For(0, n, 100, [&](size_t begin, size_t end)
+	{
+		EXPECT_EQ(0, begin % 64);
+		chunks++;
+
+		for (size_t i = begin; i < end; i++)
+			visits[i]++;
+	}, 64);
+
+	EXPECT_EQ(4, chunks.load());
+	for (size_t i = 0; i < n; i++)
+		EXPECT_EQ(1, visits[i].load());
+}
+
+TEST_F(ParallelTest, ChunkSize)
+{
+	Parallel::SetThreadCount(4);
+
+	EXPECT_EQ(250, Parallel::ChunkSize(1000, 10));
+	EXPECT_EQ(256, Parallel::ChunkSize(1000, 10, 64));
+	EXPECT_EQ(1000, Parallel::ChunkSize(1000, 600)); // too small to split
+	EXPECT_EQ(500, Parallel::ChunkSize(1000, 500));
+}
+
+TEST_F(ParallelTest, Reduce)
+{
+	Parallel::SetThreadCount(4);
+
+	size_t sum = Parallel::Reduce(size_t(1), size_t(100001), 1000, size_t(0), [](size_t begin, size_t end)
+	{
+		size_t result = 0;
+		for (size_t i = begin; i < end; i++)
+			result += i;
+
+		return result;
+	}, [](size_t x, size_t y) { return x + y; });
+
+	EXPECT_EQ(size_t(5000050000), sum);
+
+	EXPECT_EQ(7, Parallel::Reduce(size_t(5), size_t(5), 1, 7, [](size_t, size_t) { return 1; }, [](int x, int y) { return x + y; }));
+}
+
+TEST_F(ParallelTest, ExceptionsReachTheCaller)
+{
+	Parallel::SetThreadCount(4);
+
+	EXPECT_THROW(Parallel::For(0, 1000, 10, [](size_t begin, size_t end)
+	{
+		if (begin <= 500 && 500 < end)
+			throw std::runtime_error("chunk failed");
+	}), std::runtime_error);
+
+	// the pool is still usable afterwards
+	std::atomic<size_t> count(0);
+	Parallel::For(0, 1000, 10, [&](size_t begin, size_t end) { count += end - begin; });
+	EXPECT_EQ(1000, count.load());
+}
+
+TEST_F(ParallelTest, NestedForRunsInline)
+{
+	Parallel::SetThreadCount(4);
+
+	std::atomic<size_t> count(0);
+
+	Parallel::For(0, 8, 1, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			Parallel::For(0, 1000, 10, [&](size_t innerBegin, size_t innerEnd) { count += innerEnd - innerBegin; });
+	});
+
+	EXPECT_EQ(8000, count.load());
+}
+
+TEST_F(ParallelTest, StateVectorResultsDoNotDependOnThreadCount)
+{ // 2^18 amplitudes, enough for every kernel below to be split
+	const size_t qubitCount = 18;
+	const cdouble_matrix hadamard = MatrixConstants::HADAMARD;
+
+	auto run = [&](size_t threadCount)
+	{
+		Parallel::SetThreadCount(threadCount);
+
+		cdouble_vector state = CreateTestState(qubitCount);
+		cdouble_vector other = CreateTestState(qubitCount).Conjugate();
+
+		StateVector::ApplyGate(state, hadamard, 0);
+		StateVector::ApplyGate(state, hadamard, qubitCount - 1);
+		StateVector::ApplyCNOT(state, 3, 9);
+		StateVector::ApplyMultiQubitGate(state, MatrixConstants::CNOT, { 10, 2 });
+
+		cdouble inner = state.InnerProduct(other);
+		cdouble norm = state.NormSquare();
+
+		cdouble_vector normalized(state);
+		normalized.NormalizeInPlace();
+
+		std::vector<double> probabilities = QC_Algorithms::MeasurementProbabilitiesVector(normalized);
+
+		return std::make_tuple(state, inner, norm, probabilities);
+	};
+
+	auto serial = run(1);
+	auto parallel = run(4);
+
+	EXPECT_TRUE(std::get<0>(serial) == std::get<0>(parallel)); // every amplitude is computed the same way
+
+	// the sums are added up in a different order
+	EXPECT_TRUE(std::get<1>(serial).NearEquals(std::get<1>(parallel), 1e-6));
+	EXPECT_TRUE(std::get<2>(serial).NearEquals(std::get<2>(parallel), 1e-6));
+
+	const std::vector<double> & probabilities = std::get<3>(serial);
+	for (size_t i = 0; i < probabilities.size(); i++)
+		EXPECT_NEAR(probabilities[i], std::get<3>(parallel)[i], 1e-15);
+}
@@ -4,11 +4,15 @@
 #include "qc_algorithms.h"
 #include "matrix_constants.h"
 #include "print_util.h"
+#include "parallel.h"
+#include "state_vector.h"
+#include "measurement_sampler.h"
+#include "test_util.h"
 
 using namespace QC_Algorithms;
 using namespace testing;
 
-class QC_Algorithms_Test : public Test
+class QC_Algorithms_Test : public ThreadCountTest
 {
 public:
 	QC_Algorithms_Test() = default;
@@ -208,6 +212,53 @@ TEST_F(QC_Algorithms_Test, HadamardMatrix)
 	h = HadamardMatrix(2);
 	//PrintUtil::PrintMatrixToConsole(h, "H2");
 	EXPECT_EQ(MatrixConstants::HADAMARD.TensorProduct(MatrixConstants::HADAMARD), h);
+
+	h = HadamardMatrix(5);
+	for (size_t i = 0; i < 32; i++)
+		for (size_t j = 0; j < 32; j++)
+		{
+			size_t bits = i & j, parity = 0;
+			for (; bits; bits &= bits - 1)
+				parity ^= 1;
+
+			EXPECT_EQ(cdouble((parity ? -1.0 : 1.0) / sqrt(32.0)), h[i][j]);
+		}
+
+	EXPECT_THROW(HadamardMatrix(0), std::out_of_range);
+}
+
+TEST_F(QC_Algorithms_Test, WalshHadamardTransform)
+{
+	for (size_t order = 1; order <= 8; order++)
+	{
+		cdouble_vector v = CreateTestVector<cdouble>(size_t(1) << order);
+		cdouble_vector expected = HadamardMatrix(order) * v;
+
+		WalshHadamardTransform(v);
+		EXPECT_TRUE(v.NearEquals(expected, 1e-12));
+	}
+
+	cdouble_vector single({ cdouble(3, 4) });
+	WalshHadamardTransform(single);
+	EXPECT_EQ(cdouble(3, 4), single[0]);
+
+	cdouble_vector notPowerOf2(3);
+	EXPECT_THROW(WalshHadamardTransform(notPowerOf2), std::out_of_range);
+}
+
+TEST_F(QC_Algorithms_Test, WalshHadamardTransform_large)
+{ // larger than a block, split across threads; H on every qubit is the same transform
+	Parallel::SetThreadCount(4);
+
+	cdouble_vector v = CreateTestVector<cdouble>(size_t(1) << 16);
+	cdouble_vector expected(v);
+
+	StateVector::ApplyGateToAll(expected, MatrixConstants::HADAMARD);
+	WalshHadamardTransform(v);
+	EXPECT_TRUE(v.NearEquals(expected, 1e-10));
+
+	WalshHadamardTransform(v); // H is its own inverse
+	EXPECT_TRUE(v.NearEquals(CreateTestVector<cdouble>(size_t(1) << 16), 1e-10));
 }
 
 TEST_F(QC_Algorithms_Test, Grovers_algorithm)
@@ -252,6 +303,14 @@ TEST_F(QC_Algorithms_Test, PowersOfModulo)
 	EXPECT_EQ(cint_vector({ 1,13,4,7,1,13,4,7,1,13,4,7,1 }), v);
 
 	PrintUtil::PrintVectorToConsole(PowersOfModulo(6, 371, 8), "PowersOfModulo(6, 371, 8)");
+
+	v = PowersOfModulo(7, 1000003, 40); // 7^19 and up do not fit in the mantissa of a double
+	long long expected = 1;
+	for (size_t x = 0; x < v.size(); x++)
+	{
+		EXPECT_EQ(cint(static_cast<int>(expected)), v[x]);
+		expected = expected * 7 % 1000003;
+	}
 }
 
 TEST_F(QC_Algorithms_Test, example_7_2_4)
@@ -311,3 +370,65 @@ TEST_F(QC_Algorithms_Test, quantum_computer_simultor)
 		std::cout << "Measured state: " << RES << "\n";
 	}
 }
+
+TEST_F(QC_Algorithms_Test, QuantumFourierTransform)
+{
+	const double pi = 3.14159265358979323846;
+
+	for (size_t qubits = 1; qubits <= 6; qubits++)
+	{
+		const size_t n = size_t(1) << qubits;
+
+		cdouble_vector state = CreateTestVector<cdouble>(n), expected(n);
+
+		for (size_t y = 0; y < n; y++)
+			for (size_t x = 0; x < n; x++)
+			{
+				cdouble w;
+				w.FromPolar(1 / sqrt(double(n)), 2 * pi * double((x * y) % n) / double(n));
+
+				expected[y] += w * state[x];
+			}
+
+		QuantumFourierTransform(state);
+		EXPECT_TRUE(state.NearEquals(expected, 1e-9));
+
+		InverseQuantumFourierTransform(state);
+		EXPECT_TRUE(state.NearEquals(CreateTestVector<cdouble>(n), 1e-9));
+	}
+}
+
+TEST_F(QC_Algorithms_Test, QuantumFourierTransformCircuit)
+{
+	for (size_t qubits = 1; qubits <= 5; qubits++)
+	{
+		const size_t n = size_t(1) << qubits;
+
+		cdouble_vector expected = CreateTestVector<cdouble>(n), state(expected);
+		QuantumFourierTransform(expected);
+
+		QuantumFourierTransformCircuit(qubits).Run(state);
+		EXPECT_TRUE(state.NearEquals(expected, 1e-9));
+
+		state = CreateTestVector<cdouble>(n);
+		QuantumFourierTransformCircuit(qubits).Fuse().Run(state);
+		EXPECT_TRUE(state.NearEquals(expected, 1e-9));
+	}
+}
+
+TEST_F(QC_Algorithms_Test, QuantumFourierTransform_period_finding)
+{ // 20 qubits holding the uniform superposition of x = 3 (mod 16): only multiples of N / 16 can be measured
+	const size_t n = size_t(1) << 20, period = 16;
+
+	cdouble_vector state(n);
+	for (size_t x = 3; x < n; x += period)
+		state[x] = cdouble(1 / sqrt(double(n / period)));
+
+	QuantumFourierTransform(state);
+
+	measurement_sampler sampler(state);
+	for (size_t y : sampler.Sample(1000, 7))
+		EXPECT_EQ(0, y % (n / period));
+
+	EXPECT_NEAR(1.0 / period, sampler.Probability(5 * n / period), 1e-9);
+}
@@ -0,0 +1,112 @@
+#include <gtest\gtest.h>
+
+#include "quantum_circuit.h"
+#include "state_vector.h"
+#include "matrix_constants.h"
+#include "qc_algorithms.h"
+#include "test_util.h"
+
+using namespace testing;
+
+class QuantumCircuitTest : public Test
+{
+public:
+	QuantumCircuitTest() = default;
+
+	static cdouble_quantum_circuit CreateTestCircuit()
+	{
+		const cdouble_matrix T({ { cdouble(1), cdouble(0) }, { cdouble(0), cdouble(M_SQRT1_2, M_SQRT1_2) } });
+
+		cdouble_quantum_circuit circuit(4);
+		circuit.AddGate(MatrixConstants::HADAMARD, 0).AddGate(T, 0).AddCNOT(0, 1).AddGate(MatrixConstants::SQRT_NOT, 1)
+			.AddToffoli(0, 1, 2).AddGate(MatrixConstants::HADAMARD, 3).AddCZ(3, 2).AddSwap(1, 3)
+			.AddControlledGate(MatrixConstants::SQRT_NOT, { 2 }, 0).AddGate(T, 3).AddGate(MatrixConstants::HADAMARD, 2);
+
+		return circuit;
+	}
+};
+
+
+TEST_F(QuantumCircuitTest, exercise_7_2_4)
+{
+	cdouble_quantum_circuit circuit(2);
+	circuit.AddGate(MatrixConstants::HADAMARD, 0).AddCNOT(0, 1);
+
+	cdouble_vector R = QC_Algorithms::CreateQubitStateVectorAndInitializeToZero(2);
+	circuit.Run(R);
+
+	std::vector<double> probabilities = QC_Algorithms::MeasurementProbabilitiesVector(R);
+	EXPECT_NEAR(0.5, probabilities[0], 1e-12);
+	EXPECT_NEAR(0.0, probabilities[1], 1e-12);
+	EXPECT_NEAR(0.0, probabilities[2], 1e-12);
+	EXPECT_NEAR(0.5, probabilities[3], 1e-12);
+
+	cdouble_matrix U = QC_Algorithms::HadamardMatrix(1).TensorProduct(cdouble_matrix::CreateIdentityMatrix(2));
+	EXPECT_TRUE((MatrixConstants::CNOT * U).NearEquals(circuit.ToMatrix(), 1e-12));
+}
+
+TEST_F(QuantumCircuitTest, Run_matches_gate_by_gate_kernels)
+{
+	cdouble_vector expected = CreateTestState(4);
+	StateVector::ApplyGate(expected, MatrixConstants::HADAMARD, 2);
+	StateVector::ApplyToffoli(expected, 3, 0, 1);
+	StateVector::ApplySwap(expected, 0, 2);
+	StateVector::ApplyCZ(expected, 1, 3);
+
+	cdouble_quantum_circuit circuit(4);
+	circuit.AddGate(MatrixConstants::HADAMARD, 2).AddToffoli(3, 0, 1).AddSwap(0, 2).AddCZ(1, 3);
+
+	cdouble_vector state = CreateTestState(4);
+	circuit.Run(state);
+	EXPECT_TRUE(expected.NearEquals(state, 1e-12));
+
+	EXPECT_TRUE((circuit.ToMatrix() * CreateTestState(4)).NearEquals(state, 1e-12));
+
+	cdouble_vector wrongSize = CreateTestState(3);
+	EXPECT_ANY_THROW(circuit.Run(wrongSize));
+	EXPECT_ANY_THROW(circuit.AddCNOT(1, 1));
+	EXPECT_ANY_THROW(circuit.AddGate(MatrixConstants::HADAMARD, 4));
+	EXPECT_ANY_THROW(circuit.AddGate(MatrixConstants::CNOT, 1));
+}
+
+TEST_F(QuantumCircuitTest, Fuse)
+{
+	cdouble_quantum_circuit circuit = CreateTestCircuit();
+
+	for (size_t width = 1; width <= 4; width++)
+	{
+		cdouble_quantum_circuit fused = circuit.Fuse(width);
+		EXPECT_LE(fused.GateCount(), circuit.GateCount());
+
+		for (const auto & gate : fused.Gates())
+			EXPECT_TRUE(gate.m_qubits.size() <= std::max<size_t>(width, 3)); // the Toffoli cannot get narrower
+
+		cdouble_vector expected = CreateTestState(4), state = expected;
+		circuit.Run(expected);
+		fused.Run(state);
+
+		EXPECT_TRUE(expected.NearEquals(state, 1e-12));
+	}
+
+	EXPECT_EQ(1, circuit.Fuse(4).GateCount());
+	cdouble_quantum_circuit separate(2);
+	separate.AddGate(MatrixConstants::HADAMARD, 0).AddGate(MatrixConstants::HADAMARD, 1);
+	EXPECT_EQ(2, separate.Fuse(1).GateCount()); // different qubits, too wide together
+	EXPECT_EQ(1, separate.Fuse(2).GateCount());
+}
+
+TEST_F(QuantumCircuitTest, ExpandGate)
+{
+	cdouble_matrix expanded = cdouble_quantum_circuit::ExpandGate(MatrixConstants::CNOT, { 0, 1 }, { 0, 1 });
+	EXPECT_EQ(MatrixConstants::CNOT, expanded);
+
+	expanded = cdouble_quantum_circuit::ExpandGate(MatrixConstants::HADAMARD, { 1 }, { 0, 1 });
+	EXPECT_EQ(cdouble_matrix::CreateIdentityMatrix(2).TensorProduct(MatrixConstants::HADAMARD), expanded);
+
+	expanded = cdouble_quantum_circuit::ExpandGate(MatrixConstants::CNOT, { 1, 0 }, { 0, 1 }); // control on the low qubit
+	cdouble_vector state = CreateTestState(2), expected = state;
+	StateVector::ApplyCNOT(expected, 1, 0);
+	EXPECT_EQ(expected, expanded * state);
+
+	EXPECT_ANY_THROW(cdouble_quantum_circuit::ExpandGate(MatrixConstants::HADAMARD, { 2 }, { 0, 1 }));
+}
@@ -0,0 +1,88 @@
+#include <gtest\gtest.h>
+
+#include "shor.h"
+#include "parallel.h"
+#include "test_util.h"
+
+using namespace testing;
+
+class ShorTest : public ThreadCountTest
+{
+public:
+	ShorTest() = default;
+
+	static uint64_t ClassicalOrder(uint64_t base, uint64_t modulus)
+	{
+		uint64_t value = base % modulus, order = 1;
+		for (; value != 1; order++)
+			value = value * base % modulus;
+
+		return order;
+	}
+};
+
+TEST_F(ShorTest, Modular_arithmetic)
+{
+	EXPECT_EQ(1, Shor::ModularPower(7, 0, 15));
+	EXPECT_EQ(13, Shor::ModularPower(7, 3, 15));
+	EXPECT_EQ(0, Shor::ModularPower(5, 3, 1));
+	EXPECT_EQ(1, Shor::ModularPower(3, 4294967290, 4294967291)); // Fermat, with the largest prime below 2^32
+
+	EXPECT_THROW(Shor::ModularPower(2, 2, 0), std::out_of_range);
+	EXPECT_THROW(Shor::ModularPower(2, 2, uint64_t(1) << 32), std::out_of_range);
+
+	Parallel::SetThreadCount(4);
+
+	std::vector<uint64_t> powers = Shor::ModularPowers(123456789, 4294967291, 100000);
+	uint64_t expected = 1;
+	for (size_t x = 0; x < powers.size(); x++)
+	{
+		ASSERT_EQ(expected, powers[x]);
+		expected = expected * 123456789 % 4294967291;
+	}
+
+	EXPECT_EQ(6, Shor::GreatestCommonDivisor(48, 18));
+	EXPECT_EQ(7, Shor::GreatestCommonDivisor(7, 0));
+}
+
+TEST_F(ShorTest, ConvergentDenominators)
+{
+	EXPECT_EQ(std::vector<uint64_t>({ 1, 2, 7, 16 }), Shor::ConvergentDenominators(71, 16)); // 71/16 = [4; 2, 3, 2]
+	EXPECT_EQ(std::vector<uint64_t>({ 1, 1, 4 }), Shor::ConvergentDenominators(192, 256)); // 3/4 = [0; 1, 3]
+}
+
+TEST_F(ShorTest, PrepareRegister)
+{ // 7 has order 4 modulo 15, so 7^x = 4 for x = 2, 6, 10, ...
+	cdouble_vector state = Shor::PrepareRegister(7, 15, 4, 4);
+
+	for (size_t x = 0; x < 16; x++)
+		EXPECT_EQ(x % 4 == 2 ? cdouble(0.5) : cdouble(0), state[x]);
+
+	EXPECT_THROW(Shor::PrepareRegister(7, 15, 4, 5), std::invalid_argument);
+}
+
+TEST_F(ShorTest, FindOrder)
+{
+	std::mt19937_64 generator(1);
+
+	EXPECT_EQ(4, Shor::FindOrder(7, 15, generator));
+	EXPECT_EQ(ClassicalOrder(2, 899), Shor::FindOrder(2, 899, generator)); // 899 = 29 * 31, 20 qubits
+	EXPECT_THROW(Shor::FindOrder(6, 15, generator), std::invalid_argument);
+}
+
+TEST_F(ShorTest, FindOrders_and_Factor)
+{
+	Parallel::SetThreadCount(4);
+
+	std::vector<uint64_t> bases = { 2, 4, 5, 7, 8, 11 };
+	std::vector<uint64_t> orders = Shor::FindOrders(bases, 221, 5); // 221 = 13 * 17
+
+	for (size_t i = 0; i < bases.size(); i++)
+		EXPECT_EQ(ClassicalOrder(bases[i], 221), orders[i]);
+
+	uint64_t factor = Shor::Factor(221, 3);
+	EXPECT_TRUE(factor == 13 || factor == 17);
+
+	EXPECT_EQ(3, Shor::Factor(243, 3)); // 3^5
+	EXPECT_EQ(2, Shor::Factor(1000, 3));
+}
@@ -0,0 +1,205 @@
+#include <gtest\gtest.h>
+
+#include "snapshot.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace testing;
+
+class SnapshotTest : public Test
+{
+public:
+	SnapshotTest() = default;
+	~SnapshotTest() { std::remove(m_path.c_str()); }
+
+	// not the integer values of test_util.h: these fractions fill the low bytes of the mantissa, so that a payload byte lost or
+	// swapped on the way changes the value read back
+	static cdouble_vector CreateTestVector(size_t size)
+	{
+		cdouble_vector result(size);
+
+		for (size_t i = 0; i < size; i++)
+			result[i] = cdouble(static_cast<double>(i % 7) - 3.25, static_cast<double>(i % 3) / 3);
+
+		return result;
+	}
+
+	static cdouble_matrix CreateTestMatrix(size_t rows, size_t columns)
+	{
+		cdouble_matrix result(rows, columns);
+
+		for (size_t i = 0; i < rows; i++)
+			for (size_t j = 0; j < columns; j++)
+				result[i][j] = cdouble(static_cast<double>(i), -static_cast<double>(j) / 7);
+
+		return result;
+	}
+
+	static void Reverse(std::string & bytes, size_t offset, size_t size)
+	{
+		std::reverse(bytes.begin() + offset, bytes.begin() + offset + size);
+	}
+
+	const std::string m_path = "test_snapshot.bin";
+};
+
+TEST_F(SnapshotTest, Vector_round_trip)
+{
+	cdouble_vector v = CreateTestVector(3000000); // several blocks
+	std::stringstream stream;
+
+	Snapshot::Write(stream, v);
+	EXPECT_EQ(Snapshot::HEADER_SIZE + v.size() * sizeof(cdouble) + 8, stream.str().size());
+
+	EXPECT_EQ(v, Snapshot::ReadVector<cdouble>(stream));
+
+	cfloat_vector vf(v);
+	std::stringstream streamf;
+
+	Snapshot::Write(streamf, vf, false);
+	EXPECT_EQ(Snapshot::HEADER_SIZE + vf.size() * sizeof(cfloat), streamf.str().size());
+	EXPECT_EQ(vf, Snapshot::ReadVector<cfloat>(streamf));
+}
+
+TEST_F(SnapshotTest, Matrix_round_trip_and_header)
+{
+	cint_matrix m({ { cint(1, 2), cint(3, 4), cint(5, 6) }, { cint(-1), cint(0, -1), cint(7) } });
+	Snapshot::Save(m_path, m);
+
+	EXPECT_EQ(m, Snapshot::LoadMatrix<cint>(m_path));
+
+	std::stringstream stream;
+	Snapshot::Write(stream, m);
+
+	Snapshot::header header = Snapshot::ReadHeader(stream);
+	EXPECT_EQ(Snapshot::VERSION, header.version);
+	EXPECT_EQ(Snapshot::ElementType<cint>(), header.elementType);
+	EXPECT_EQ(Snapshot::KIND_MATRIX, header.kind);
+	EXPECT_EQ(Snapshot::HAS_CHECKSUM, header.flags);
+	EXPECT_EQ(2, header.rows);
+	EXPECT_EQ(3, header.columns);
+	EXPECT_EQ(6 * sizeof(cint), header.payloadBytes);
+	EXPECT_FALSE(header.swapped);
+
+	cint_matrix ragged({ { cint(1) }, { cint(1), cint(2) } });
+	EXPECT_THROW(Snapshot::Write(stream, ragged), std::invalid_argument);
+}
+
+TEST_F(SnapshotTest, Errors)
+{
+	cdouble_vector v = CreateTestVector(100);
+	std::stringstream stream;
+	Snapshot::Write(stream, v);
+	const std::string bytes = stream.str();
+
+	std::string corrupt = bytes;
+	corrupt[Snapshot::HEADER_SIZE + 17] ^= 1;
+	std::stringstream corruptStream(corrupt);
+	EXPECT_THROW(Snapshot::ReadVector<cdouble>(corruptStream), std::runtime_error);
+
+	std::stringstream truncatedStream(bytes.substr(0, bytes.size() - 9));
+	EXPECT_THROW(Snapshot::ReadVector<cdouble>(truncatedStream), std::runtime_error);
+
+	std::stringstream wrongType(bytes);
+	EXPECT_THROW(Snapshot::ReadVector<cfloat>(wrongType), std::invalid_argument);
+
+	std::stringstream wrongKind(bytes);
+	EXPECT_THROW(Snapshot::ReadMatrix<cdouble>(wrongKind), std::invalid_argument);
+
+	std::stringstream text("(1,2) (3,4)");
+	EXPECT_THROW(Snapshot::ReadVector<cdouble>(text), std::runtime_error);
+
+	EXPECT_THROW(Snapshot::LoadVector<cdouble>("no_such_file.bin"), std::runtime_error);
+}
+
+TEST_F(SnapshotTest, Corrupt_sizes)
+{
+	cdouble_vector v = CreateTestVector(6);
+	std::stringstream stream;
+	Snapshot::Write(stream, v);
+	const std::string bytes = stream.str();
+
+	auto withSize = [&](uint64_t rows, uint64_t columns, uint32_t kind = Snapshot::KIND_VECTOR)
+	{ // a consistent payload size, as a hostile file would have
+		std::string result = bytes;
+		uint64_t payloadBytes = rows * columns * sizeof(cdouble);
+
+		memcpy(&result[24], &kind, 4);
+		memcpy(&result[32], &rows, 8);
+		memcpy(&result[40], &columns, 8);
+		memcpy(&result[48], &payloadBytes, 8);
+
+		return result;
+	};
+
+	std::stringstream notOneColumn(withSize(2, 3)); // as many bytes as the 6 elements, but not a vector
+	EXPECT_THROW(Snapshot::ReadVector<cdouble>(notOneColumn), std::runtime_error);
+
+	std::stringstream huge(withSize(uint64_t(1) << 40, 1));
+	EXPECT_THROW(Snapshot::ReadVector<cdouble>(huge), std::runtime_error);
+
+	std::stringstream hugeMatrix(withSize(uint64_t(1) << 20, uint64_t(1) << 20, Snapshot::KIND_MATRIX));
+	EXPECT_THROW(Snapshot::ReadMatrix<cdouble>(hugeMatrix), std::runtime_error);
+
+	std::ofstream(m_path, std::ios::binary) << withSize(uint64_t(1) << 40, 1);
+	EXPECT_THROW(Snapshot::LoadVector<cdouble>(m_path), std::runtime_error);
+	EXPECT_THROW(Snapshot::mapped_snapshot<cdouble> snapshot(m_path), std::runtime_error);
+}
+
+TEST_F(SnapshotTest, Other_byte_order)
+{ // turns a snapshot into the one a machine of the other byte order would write
+	cdouble_vector v = CreateTestVector(100);
+	std::stringstream stream;
+	Snapshot::Write(stream, v);
+	std::string bytes = stream.str();
+
+	for (size_t offset = 8; offset < 32; offset += 4)
+		Reverse(bytes, offset, 4);
+	for (size_t offset = 32; offset < 64; offset += 8)
+		Reverse(bytes, offset, 8);
+	for (size_t offset = Snapshot::HEADER_SIZE; offset < bytes.size(); offset += 8) // the doubles, then the checksum
+		Reverse(bytes, offset, 8);
+
+	std::stringstream swapped(bytes);
+	EXPECT_TRUE(Snapshot::ReadHeader(swapped).swapped);
+
+	swapped.seekg(0);
+	EXPECT_EQ(v, Snapshot::ReadVector<cdouble>(swapped));
+
+	std::ofstream(m_path, std::ios::binary) << bytes;
+	EXPECT_THROW(Snapshot::mapped_snapshot<cdouble> snapshot(m_path), std::runtime_error);
+}
+
+TEST_F(SnapshotTest, Mapped_read)
+{
+	cdouble_matrix m = CreateTestMatrix(40, 24);
+	Snapshot::Save(m_path, m);
+
+	{
+		Snapshot::mapped_snapshot<cdouble> snapshot(m_path);
+
+		EXPECT_EQ(40, snapshot.Rows());
+		EXPECT_EQ(24, snapshot.Cols());
+		EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(snapshot.Data()) % 64);
+		EXPECT_EQ(m[3][5], snapshot.Row(3)[5]);
+		EXPECT_TRUE(snapshot.Verify());
+		EXPECT_EQ(m, snapshot.ToMatrix());
+		EXPECT_EQ(m[1][0], snapshot.ToVector()[24]); // row-major, unlike complex_matrix::ToVector
+		EXPECT_EQ(Snapshot::Checksum(snapshot.Data(), snapshot.Size() * sizeof(cdouble)),
+			Snapshot::Checksum(snapshot.ToVector().data(), snapshot.Size() * sizeof(cdouble)));
+	}
+
+	{
+		std::fstream file(m_path, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(Snapshot::HEADER_SIZE + 100);
+		file.put('x');
+	}
+
+	Snapshot::mapped_snapshot<cdouble> snapshot(m_path);
+	EXPECT_FALSE(snapshot.Verify());
+	EXPECT_THROW(Snapshot::mapped_snapshot<cint> wrongType(m_path), std::invalid_argument);
+}
@@ -0,0 +1,212 @@
+#include <gtest\gtest.h>
+
+#include "state_vector.h"
+#include "ckronecker.h"
+#include "matrix_constants.h"
+#include "quantum_gates.h"
+#include "qc_algorithms.h"
+#include "test_util.h"
+
+using namespace testing;
+
+class StateVectorTest : public Test
+{
+public:
+	StateVectorTest() = default;
+
+	static cdouble_matrix GateOnQubit(const cdouble_matrix & gate, size_t qubitCount, size_t qubit)
+	{ // the dense operator I (x) ... (x) gate (x) ... (x) I
+		cdouble_kronecker_operator result;
+
+		for (size_t i = 0; i < qubitCount; i++)
+		{
+			if (i == qubit)
+				result.Append(gate);
+			else
+				result.AppendIdentity(2);
+		}
+
+		return result.ToMatrix();
+	}
+
+	static cdouble_matrix ControlledGate(const cdouble_matrix & gate, size_t qubitCount, const std::vector<size_t> & controls, size_t target)
+	{ // the dense operator, built element by element
+		size_t size = size_t(1) << qubitCount, targetMask = StateVector::QubitStride(qubitCount, target), controlMask = 0;
+
+		for (size_t control : controls)
+			controlMask |= StateVector::QubitStride(qubitCount, control);
+
+		cdouble_matrix result(size, size);
+
+		for (size_t i = 0; i < size; i++)
+			for (size_t j = 0; j < size; j++)
+			{
+				if ((j & controlMask) != controlMask)
+					result[i][j] = i == j ? 1 : 0;
+				else if ((i & ~targetMask) == (j & ~targetMask))
+					result[i][j] = gate[(i & targetMask) ? 1 : 0][(j & targetMask) ? 1 : 0];
+			}
+
+		return result;
+	}
+};
+
+
+TEST_F(StateVectorTest, QubitCount)
+{
+	EXPECT_EQ(0, StateVector::QubitCount(cdouble_vector(1)));
+	EXPECT_EQ(3, StateVector::QubitCount(cdouble_vector(8)));
+	EXPECT_ANY_THROW(StateVector::QubitCount(cdouble_vector(6)));
+	EXPECT_ANY_THROW(StateVector::QubitCount(cdouble_vector()));
+}
+
+TEST_F(StateVectorTest, ApplyGate_matches_dense_operator)
+{
+	const size_t qubitCount = 4;
+	const cdouble_matrix gates[] = { MatrixConstants::HADAMARD, MatrixConstants::SQRT_NOT, cdouble_matrix({ { cdouble(1), cdouble(0) }, { cdouble(0), cdouble(0, 1) } }) };
+
+	for (const auto & gate : gates)
+	{
+		for (size_t qubit = 0; qubit < qubitCount; qubit++)
+		{
+			cdouble_vector state = CreateTestState(qubitCount);
+			cdouble_vector expected = GateOnQubit(gate, qubitCount, qubit) * state;
+
+			StateVector::ApplyGate(state, gate, qubit);
+			EXPECT_TRUE(expected.NearEquals(state, 1e-12));
+		}
+	}
+
+	cdouble_vector state = CreateTestState(2);
+	EXPECT_ANY_THROW(StateVector::ApplyGate(state, MatrixConstants::HADAMARD, 2));
+	EXPECT_ANY_THROW(StateVector::ApplyGate(state, MatrixConstants::CNOT, 0));
+}
+
+TEST_F(StateVectorTest, exercise_7_2_4) // first step, H on the top qubit
+{
+	cdouble_vector R = QC_Algorithms::CreateQubitStateVectorAndInitializeToZero(2);
+	cdouble_vector expected = QC_Algorithms::HadamardMatrix(1).TensorProduct(cdouble_matrix::CreateIdentityMatrix(2)) * R;
+
+	StateVector::ApplyGate(R, MatrixConstants::HADAMARD, 0);
+	EXPECT_TRUE(expected.NearEquals(R, 1e-12));
+}
+
+TEST_F(StateVectorTest, Square_root_of_not_twice_is_not)
+{
+	cdouble_vector state = CreateTestState(3);
+	cdouble_vector expected = GateOnQubit(cdouble_matrix({ { cdouble(0), cdouble(-1) }, { cdouble(1), cdouble(0) } }), 3, 1) * state;
+
+	StateVector::ApplyGate(state, QuantumGates::SquareRootOfNot(), 1);
+	StateVector::ApplyGate(state, QuantumGates::SquareRootOfNot(), 1);
+	EXPECT_TRUE(expected.NearEquals(state, 1e-12));
+}
+
+TEST_F(StateVectorTest, Uniform_superposition_of_many_qubits)
+{
+	const size_t qubitCount = 20; // the dense operator would have 2^40 elements
+	cdouble_vector state = QC_Algorithms::CreateQubitStateVectorAndInitializeToZero(qubitCount);
+
+	StateVector::ApplyGateToAll(state, MatrixConstants::HADAMARD);
+
+	const double amplitude = 1.0 / (1 << (qubitCount / 2));
+	for (size_t i = 0; i < state.size(); i += 4099)
+		EXPECT_NEAR(amplitude, state[i].Real(), 1e-12);
+
+	StateVector::ApplyGateToAll(state, MatrixConstants::HADAMARD); // H is its own inverse
+	EXPECT_NEAR(1.0, state[0].Real(), 1e-9);
+	EXPECT_NEAR(0.0, state[state.size() - 1].Real(), 1e-9);
+}
+
+TEST_F(StateVectorTest, CNOT) // the dense gate from pages 153-154
+{
+	cdouble_vector state = CreateTestState(2);
+	cdouble_vector expected = MatrixConstants::CNOT * state;
+
+	StateVector::ApplyCNOT(state, 0, 1);
+	EXPECT_EQ(expected, state);
+
+	const cdouble_matrix X({ { cdouble(0), cdouble(1) }, { cdouble(1), cdouble(0) } });
+
+	for (size_t control = 0; control < 4; control++)
+		for (size_t target = 0; target < 4; target++)
+		{
+			if (control == target)
+				continue;
+
+			state = CreateTestState(4);
+			expected = ControlledGate(X, 4, { control }, target) * state;
+
+			StateVector::ApplyCNOT(state, control, target);
+			EXPECT_EQ(expected, state);
+		}
+
+	EXPECT_ANY_THROW(StateVector::ApplyCNOT(state, 1, 1));
+	EXPECT_ANY_THROW(StateVector::ApplyCNOT(state, 0, 4));
+}
+
+TEST_F(StateVectorTest, Toffoli_and_controlled_gates)
+{
+	const cdouble_matrix X({ { cdouble(0), cdouble(1) }, { cdouble(1), cdouble(0) } });
+
+	cdouble_vector state = CreateTestState(4);
+	cdouble_vector expected = ControlledGate(X, 4, { 3, 0 }, 2) * state;
+	StateVector::ApplyToffoli(state, 3, 0, 2);
+	EXPECT_EQ(expected, state);
+
+	state = CreateTestState(4);
+	expected = ControlledGate(MatrixConstants::HADAMARD, 4, { 1, 3 }, 0) * state;
+	StateVector::ApplyControlledGate(state, MatrixConstants::HADAMARD, { 1, 3 }, 0);
+	EXPECT_TRUE(expected.NearEquals(state, 1e-12));
+
+	state = CreateTestState(3);
+	expected = GateOnQubit(MatrixConstants::SQRT_NOT, 3, 2) * state;
+	StateVector::ApplyControlledGate(state, MatrixConstants::SQRT_NOT, {}, 2); // no controls is the plain gate
+	EXPECT_TRUE(expected.NearEquals(state, 1e-12));
+}
+
+TEST_F(StateVectorTest, CZ_and_swap)
+{
+	const cdouble_matrix Z({ { cdouble(1), cdouble(0) }, { cdouble(0), cdouble(-1) } });
+
+	cdouble_vector state = CreateTestState(3);
+	cdouble_vector expected = ControlledGate(Z, 3, { 2 }, 0) * state;
+	StateVector::ApplyCZ(state, 0, 2);
+	EXPECT_EQ(expected, state);
+
+	state = CreateTestState(3);
+	expected = state;
+	StateVector::ApplyCZ(state, 2, 0); // symmetric
+	StateVector::ApplyCZ(state, 0, 2);
+	EXPECT_EQ(expected, state);
+
+	state = CreateTestState(3); // SWAP = CNOT(a, b) CNOT(b, a) CNOT(a, b)
+	expected = state;
+	StateVector::ApplyCNOT(expected, 0, 2);
+	StateVector::ApplyCNOT(expected, 2, 0);
+	StateVector::ApplyCNOT(expected, 0, 2);
+	StateVector::ApplySwap(state, 2, 0);
+	EXPECT_EQ(expected, state);
+}
+
+TEST_F(StateVectorTest, ApplyMultiQubitGate)
+{
+	for (size_t control = 0; control < 3; control++)
+		for (size_t target = 0; target < 3; target++)
+		{
+			if (control == target)
+				continue;
+
+			cdouble_vector state = CreateTestState(3), expected = state;
+			StateVector::ApplyCNOT(expected, control, target);
+			StateVector::ApplyMultiQubitGate(state, MatrixConstants::CNOT, { control, target });
+			EXPECT_EQ(expected, state);
+		}
+
+	cdouble_vector state = CreateTestState(3);
+	cdouble_vector expected = GateOnQubit(MatrixConstants::HADAMARD, 3, 1) * state;
+	StateVector::ApplyMultiQubitGate(state, MatrixConstants::HADAMARD, { 1 });
+	EXPECT_TRUE(expected.NearEquals(state, 1e-12));
+
+	EXPECT_ANY_THROW(StateVector::ApplyMultiQubitGate(state, MatrixConstants::CNOT, { 1 }));
+	EXPECT_ANY_THROW(StateVector::ApplyMultiQubitGate(state, MatrixConstants::CNOT, { 1, 1 }));
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <gtest\gtest.h>
+
+#include "cflatmatrix.h"
+#include "parallel.h"
+
+// small integer parts, so that sums and products are exact in every complex type whatever order they are added in;
+// different seeds give different data for the operands of a test
+template <class T> T CreateTestValue(size_t i, size_t j, int seed)
+{
+	return T((static_cast<int>(i * 7 + j * 3) + seed) % 11 - 5, (static_cast<int>(i + j * 5) + seed) % 7 - 3);
+}
+
+template <class T> complex_vector<T> CreateTestVector(size_t size, int seed = 0)
+{
+	complex_vector<T> result(size);
+
+	for (size_t i = 0; i < size; i++)
+		result[i] = CreateTestValue<T>(i, 0, seed);
+
+	return result;
+}
+
+template <class T> complex_flat_matrix<T> CreateTestMatrix(size_t m, size_t n, int seed)
+{
+	complex_flat_matrix<T> result(m, n);
+
+	for (size_t i = 0; i < m; i++)
+		for (size_t j = 0; j < n; j++)
+			result(i, j) = CreateTestValue<T>(i, j, seed);
+
+	return result;
+}
+
+// test amplitudes for qubitCount qubits, normalized only when asked
+inline cdouble_vector CreateTestState(size_t qubitCount, bool normalize = false)
+{
+	cdouble_vector result = CreateTestVector<cdouble>(size_t(1) << qubitCount);
+
+	if (normalize)
+		result.NormalizeInPlace();
+
+	return result;
+}
+
+// the base of the fixtures whose tests change the number of threads, which is set back to the default for the other tests
+class ThreadCountTest : public testing::Test
+{
+public:
+	~ThreadCountTest() { Parallel::SetThreadCount(0); }
+};